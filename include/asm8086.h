@@ -0,0 +1,15 @@
+/*
+ * asm8086.h - Built-in 8086 assembler for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_ASM8086_H
+#define PHYLOG_ASM8086_H
+
+#include "common.h"
+
+// Encode the last generated assembly stream (see codegen_get_line) into a flat
+// DOS .com image: code at 100h followed by the data, jumps relaxed to their
+// shortest encodings. Returns 1 on success, 0 if a line cannot be encoded.
+int asm8086_write_com(const char* filename);
+
+#endif // PHYLOG_ASM8086_H
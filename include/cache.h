@@ -0,0 +1,42 @@
+/*
+ * cache.h - Content-addressed compilation cache for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_CACHE_H
+#define PHYLOG_CACHE_H
+
+#include "common.h"
+
+#define CACHE_KEY_LENGTH 16                        // Hex digits in a cache key
+#define CACHE_DEFAULT_MAX_BYTES (64L * 1024 * 1024) // Default cache size bound
+
+// Cache statistics (persisted in the cache directory)
+typedef struct {
+    long hits;
+    long misses;
+    long stores;
+    long evictions;
+} CacheStats;
+
+// Open (and create if needed) a cache directory
+int cache_init(const char* dir, long max_bytes);
+
+// Compute the key of a compilation from the source bytes and the option set
+int cache_compute_key(const char* source_file, const char* options, char key[CACHE_KEY_LENGTH + 1]);
+
+// Copy a cached entry to <output_prefix>.<suffix> for each suffix; returns 1 on a hit
+int cache_lookup(const char* key, const char* output_prefix, const char* const* suffixes, int* status);
+
+// Store <output_prefix>.<suffix> files under a key, then evict down to the size bound
+int cache_store(const char* key, const char* output_prefix, const char* const* suffixes, int status);
+
+// Get the cache statistics
+CacheStats cache_get_stats(void);
+
+// Display cache statistics
+void cache_display_stats(void);
+
+// Save statistics and release the cache
+void cache_cleanup(void);
+
+#endif // PHYLOG_CACHE_H
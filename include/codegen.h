@@ -4,14 +4,49 @@
 
  #ifndef CODEGEN_H
  #define CODEGEN_H
- 
+
+ #include "quadgen.h"
+
+ // Kinds of lines in the generated assembly stream
+ typedef enum {
+     ASM_LINE_DIRECTIVE,   // Assembler directive (bits 16, global ...)
+     ASM_LINE_SECTION,     // Section switch
+     ASM_LINE_LABEL,       // Label definition
+     ASM_LINE_INSTR,       // Machine instruction
+     ASM_LINE_DATA,        // Data definition (name + definition)
+     ASM_LINE_COMMENT,     // Comment line
+     ASM_LINE_BLANK        // Empty line
+ } AsmLineKind;
+
+ // One line of generated assembly, kept so later stages can inspect what was emitted
+ typedef struct {
+     AsmLineKind kind;
+     int quad_id;          // Quadruple that produced the line (-1 outside quads)
+     char mnemonic[32];    // Mnemonic, label, section, directive or data name
+     char operands[160];   // Operand text or data definition
+     char comment[96];     // Trailing comment (without ';')
+ } AsmLine;
+
  // Initialize the code generator
  void codegen_init(void);
- 
+
+ // Lower FLOAT values to calls of a soft-float runtime instead of 8087
+ // instructions (for targets without a coprocessor)
+ void codegen_set_soft_float(int enabled);
+
  // Generate assembly code from quadruple file
  int codegen_generate(const char* quad_file, const char* asm_file);
- 
+
+ // Number of lines in the last generated assembly stream
+ int codegen_get_line_count(void);
+
+ // Get a line of the last generated assembly stream
+ const AsmLine* codegen_get_line(int index);
+
+ // Lower a single quadruple into a scratch buffer (used for cost estimates)
+ int codegen_lower_quad(const Quadruplet* q, AsmLine* lines, int max_lines);
+
  // Clean up code generator resources
  void codegen_cleanup(void);
- 
+
  #endif /* CODEGEN_H */
\ No newline at end of file
@@ -0,0 +1,18 @@
+/*
+ * codegen_c.h - Portable C code generator for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_CODEGEN_C_H
+#define PHYLOG_CODEGEN_C_H
+
+#include "common.h"
+
+// Generate a self-contained C translation unit from a quadruple file. Labels
+// and jumps become labels and gotos; READ and DISPLAY call a small stdio
+// runtime emitted into the same file.
+int codegen_c_generate(const char* quad_file, const char* c_file);
+
+// Compile generated C with the host compiler ($CC, default cc) at -O2
+int codegen_c_compile(const char* c_file, const char* exe_file);
+
+#endif // PHYLOG_CODEGEN_C_H
@@ -0,0 +1,18 @@
+/*
+ * codegen_x64.h - x86-64 Linux code generator for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_CODEGEN_X64_H
+#define PHYLOG_CODEGEN_X64_H
+
+#include "common.h"
+
+// Generate x86-64 assembly (GNU as, Intel syntax) from a quadruple file.
+// The output is self-contained: it carries its own I/O runtime and talks to
+// the kernel through system calls only.
+int codegen_x64_generate(const char* quad_file, const char* asm_file);
+
+// Assemble and link generated x86-64 assembly into a static ELF executable
+int codegen_x64_link(const char* asm_file, const char* exe_file);
+
+#endif // PHYLOG_CODEGEN_X64_H
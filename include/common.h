@@ -10,6 +10,9 @@
 #include <string.h>
 #include <stdarg.h>
 
+// Compiler version (recorded in cache entries; the key uses the build itself)
+#define PHYLOG_VERSION "1.1"
+
 // Error severity levels
 typedef enum {
     ERROR_LEVEL_INFO,    // Informational message
@@ -38,4 +41,8 @@ int is_float_literal(const char* str);
 int string_to_int(const char* str);
 float string_to_float(const char* str);
 
+// Write a float as the shortest literal that reads back to the same value
+// (%g with up to 9 digits, always with a decimal point: "3.14", "3.0", "1.0e-07")
+void format_float(char* buffer, size_t size, float value);
+
 #endif // PHYLOG_COMMON_H
\ No newline at end of file
@@ -0,0 +1,30 @@
+/*
+ * costmodel.h - Static 8086 cost model for generated code
+ */
+
+#ifndef PHYLOG_COSTMODEL_H
+#define PHYLOG_COSTMODEL_H
+
+#include "common.h"
+#include "quadgen.h"
+
+// Estimated cost of a piece of code
+typedef struct {
+    int cycles;        // Estimated 8086 clock cycles
+    int bytes;         // Estimated encoded size in bytes
+    int instructions;  // Number of machine instructions
+} CostEstimate;
+
+// Estimate the cost of a single 8086 instruction
+CostEstimate costmodel_instr_cost(const char* mnemonic, const char* operands);
+
+// Same, with a known REP / shift-by-CL count
+CostEstimate costmodel_instr_cost_repeat(const char* mnemonic, const char* operands, int repeat);
+
+// Estimate the cost of the code generated for a quadruple
+CostEstimate costmodel_quad_cost(const Quadruplet* q);
+
+// Write the per-block / per-loop / per-construct report for the last generated code
+int costmodel_write_report(const char* report_file);
+
+#endif // PHYLOG_COSTMODEL_H
@@ -0,0 +1,100 @@
+/*
+ * irbin.h - Binary IR container for the PHYLOG compiler
+ *
+ * Layout (all offsets are byte offsets from the start of the file, all
+ * sections 4-byte aligned, integers in host byte order):
+ *
+ *   IrBinHeader
+ *   opcode table   uint32 string offsets, indexed by IrBinQuad.opcode
+ *   quads          IrBinQuad records
+ *   symbols        IrBinSymbol records
+ *   messages       uint32 string offsets of the AFFICHER messages, by number
+ *   string pool    NUL-terminated strings, offset 0 is the empty string
+ */
+
+#ifndef PHYLOG_IRBIN_H
+#define PHYLOG_IRBIN_H
+
+#include <stdint.h>
+#include "common.h"
+#include "quadgen.h"
+
+#define IRBIN_MAGIC      "PHIR"
+#define IRBIN_VERSION    3
+#define IRBIN_BYTE_ORDER 0x01020304u
+
+// File header
+typedef struct {
+    char magic[4];             // "PHIR"
+    uint16_t version;          // Format version
+    uint16_t header_size;      // sizeof(IrBinHeader)
+    uint32_t byte_order;       // IRBIN_BYTE_ORDER as written by the producer
+    uint32_t file_size;        // Total size in bytes
+    uint32_t opcode_count, opcode_offset;
+    uint32_t quad_count, quad_offset;
+    uint32_t symbol_count, symbol_offset;
+    uint32_t message_count, message_offset;
+    uint32_t pool_size, pool_offset;
+} IrBinHeader;
+
+// Quadruple record (operands are string pool offsets)
+typedef struct {
+    uint16_t opcode;           // Index into the opcode table
+    uint16_t reserved;
+    uint32_t arg1;
+    uint32_t arg2;
+    uint32_t result;
+} IrBinQuad;
+
+// Symbol record
+typedef struct {
+    uint32_t name;             // String pool offset
+    uint8_t category;          // SymbolCategory
+    uint8_t type;              // SymbolType
+    uint8_t is_initialized;
+    uint8_t reserved;
+    uint32_t value;            // Integer, float bits or character value
+    uint32_t string_value;     // String pool offset (TYPE_STRING)
+    int32_t array_size;
+    int32_t array_lower_bound;
+    int32_t line;
+    int32_t column;
+} IrBinSymbol;
+
+// A mapped IR container
+typedef struct {
+    void* base;                // Start of the mapping
+    size_t size;               // Mapping size
+    const IrBinHeader* header;
+    const uint32_t* opcodes;
+    const IrBinQuad* quads;
+    const IrBinSymbol* symbols;
+    const uint32_t* messages;
+    const char* pool;
+} IrBinFile;
+
+// Check if a file starts with the binary IR magic
+int irbin_is_binary(const char* filename);
+
+// Write the current quadruples and symbol table to a binary IR file
+int irbin_write(const char* filename);
+
+// Map a binary IR file read-only (returns NULL if invalid)
+IrBinFile* irbin_open(const char* filename);
+
+// Get a string from the pool ("" for invalid offsets)
+const char* irbin_string(const IrBinFile* ir, uint32_t offset);
+
+// Get the operator name of a quadruple record
+const char* irbin_quad_op(const IrBinFile* ir, const IrBinQuad* q);
+
+// Get display message number i ("" if out of range)
+const char* irbin_message(const IrBinFile* ir, uint32_t index);
+
+// Copy the quadruples of a binary IR file into the quadruplet generator
+int irbin_load_quads(const char* filename);
+
+// Unmap a binary IR file
+void irbin_close(IrBinFile* ir);
+
+#endif // PHYLOG_IRBIN_H
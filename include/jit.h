@@ -0,0 +1,21 @@
+/*
+ * jit.h - In-process x86-64 execution of the quadruples for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_JIT_H
+#define PHYLOG_JIT_H
+
+#include "common.h"
+
+// Compile the quadruples held by the quadruplet generator to x86-64 machine
+// code in executable memory and run them in this process. READ and DISPLAY
+// go through host callbacks on stdin/stdout. Compile and run times are
+// reported separately. Returns the program exit status (1 after an array
+// access outside its bounds) or -1 if the code could not be run.
+int jit_run(void);
+
+// Count basic block executions during jit_run and add them to a profile
+// file (NULL stops profiling); see profile.h
+void jit_set_profile(const char* filename);
+
+#endif // PHYLOG_JIT_H
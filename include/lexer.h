@@ -11,8 +11,16 @@
 extern int current_line;
 extern int current_column;
 
+// Position of a token in the source buffer
+typedef struct {
+    unsigned int offset;   // Byte offset into the source buffer
+    unsigned int length;   // Length in bytes
+    int line;              // Line of the first character
+    int column;            // Column of the first character
+} TokenSpan;
+
 // Token value storage
-extern char token_text[256];
+extern TokenSpan token_span;   // Span of the last token
 extern int token_int_value;
 extern float token_float_value;
 extern char token_char_value;
@@ -20,6 +28,12 @@ extern char token_char_value;
 // Initialize the lexical analyzer with an input file
 int lexer_init(const char* filename);
 
+// Get the source buffer that token spans point into
+const char* lexer_source(void);
+
+// Intern an identifier: every occurrence of the same name shares one copy
+const char* lexer_intern(const char* text, int length);
+
 // Report a lexical error
 void lexer_error(const char* message);
 
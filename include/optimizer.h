@@ -8,14 +8,30 @@
 #include "common.h"
 #include "quadgen.h"
 
+#define OPT_UNROLL_DEFAULT_FACTOR 4   // Copies of the body per iteration of a partially unrolled loop
+#define OPT_UNROLL_FULL_MAX_TRIPS 8   // Loops with at most this many iterations are fully unrolled
+#define OPT_UNROLL_MAX_GROWTH 64      // Quadruples a single loop may grow by when unrolled
+
+// Profile-guided decisions, relative to the execution count of the hottest block
+#define OPT_PROFILE_COLD_RATIO 100    // Loops whose body runs under 1/100 of it are not unrolled
+#define OPT_PROFILE_HOT_RATIO 4       // Loops whose body runs at least 1/4 of it get twice the factor
+#define OPT_PROFILE_RARE_RATIO 8      // Regions entered under 1/8 of their branch's runs move out of line
+
 // Optimization pass types
 typedef enum {
     OPT_PASS_COPY_PROPAGATION,          // Propagate copy operations
     OPT_PASS_CONSTANT_FOLDING,          // Compute constant expressions
     OPT_PASS_CONSTANT_PROPAGATION,      // Propagate constant values
     OPT_PASS_COMMON_SUBEXPR_ELIMINATION, // Eliminate common subexpressions
+    OPT_PASS_ARRAY_ELEMENT_CSE,         // Reuse array elements already held in variables
     OPT_PASS_DEAD_CODE_ELIMINATION,     // Remove dead code
     OPT_PASS_ALGEBRAIC_SIMPLIFICATION,  // Simplify algebraic expressions
+    OPT_PASS_RANGE_CHECK_ELIMINATION,   // Remove array range checks proven by value ranges
+    OPT_PASS_RESULT_FORWARDING,         // Retarget single-use temporaries into their copies
+    OPT_PASS_BRANCH_SIMPLIFICATION,     // Thread jumps, drop jumps to next and unused labels
+    OPT_PASS_LOOP_IDIOMS,               // Turn array fill/copy loops into AFILL/ACOPY
+    OPT_PASS_LOOP_UNROLLING,            // Unroll FOR loops with compile-time trip counts
+    OPT_PASS_BLOCK_LAYOUT,              // Move rarely run regions out of line (needs a profile)
     OPT_PASS_CODE_COMPACTION,            // eliminate nops (cleaning)
     OPT_PASS_UNUSED_VAR_CLEANUP         // Remove unused variables
 } OptimizationPass;
@@ -26,14 +42,24 @@ typedef struct {
     int constants_folded;
     int constants_propagated;
     int common_subexprs_eliminated;
+    int array_accesses_reused;
     int dead_code_eliminated;
     int algebraic_simplifications;
+    int results_forwarded;
+    int branches_simplified;
+    int loop_idioms_replaced;
+    int loops_unrolled;
+    int bounds_checks_removed;
+    int blocks_moved;
     int nops_eliminated;
 } OptimizationStats;
 
 // Initialize the optimizer
 void optimizer_init();
 
+// Configure loop unrolling (factor 1 disables partial unrolling, growth 0 favours size)
+void optimizer_set_unrolling(int factor, int max_growth);
+
 // Run a specific optimization pass
 int optimizer_run_pass(OptimizationPass pass, const char* input_file, const char* output_file);
 
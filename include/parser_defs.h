@@ -5,19 +5,52 @@
 #ifndef PHYLOG_PARSER_DEFS_H
 #define PHYLOG_PARSER_DEFS_H
 
+#include "symboltable.h"
+
+// Kind of an expression operand
+typedef enum {
+    OPERAND_NONE,       // Missing or erroneous value (name kept for recovery)
+    OPERAND_SYMBOL,     // Variable, constant or temporary in the symbol table
+    OPERAND_IMMEDIATE,  // Literal value
+    OPERAND_EXPR        // Expression not lowered to quadruples yet
+} OperandKind;
+
+// Node of the expression DAG of the current statement (parser_helpers.c)
+struct ExprNode;
+
+// Semantic value of an expression, carried by value through the grammar
+typedef struct {
+    OperandKind kind;
+    SymbolType type;
+    SymbolNode* symbol;      // OPERAND_SYMBOL
+    const char* name;        // Symbol name, or identifier text for OPERAND_NONE
+    union {
+        int int_value;
+        float float_value;
+        char char_value;
+        const char* string_value;
+    } imm;                   // OPERAND_IMMEDIATE
+    struct ExprNode* expr;   // OPERAND_EXPR
+} Operand;
+
+// Buffer size for the IR text of an operand
+#define OPERAND_TEXT_SIZE 256
+
 // parser_defs.h
 typedef struct {
     char* name;     // Variable or array name
-    char* index;    // Index expression (NULL for simple variables)
+    Operand index;  // Index expression (array elements only)
     int is_array;   // Flag to indicate array access
 } AssignmentTarget;
 
-/* FOR loop information structure */
+/* FOR/WHILE loop information structure */
 typedef struct ForLoopContext {
-    char* var_name;                  // Loop counter variable name
+    char* var_name;                  // Loop counter variable name (NULL for WHILE)
     int cond_label;                  // Label for condition check
     int body_label;                  // Label for loop body
     int end_label;                   // Label for loop end
+    int cond_start;                  // First quadruple of the condition code
+    int cond_end;                    // Quadruple after the condition code (body label)
     struct ForLoopContext* next;     // For stack implementation
 } ForLoopContext;
 
@@ -0,0 +1,38 @@
+/*
+ * profile.h - Basic block execution profiles for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_PROFILE_H
+#define PHYLOG_PROFILE_H
+
+#include "common.h"
+
+// Split the current quadruples into basic blocks: block_of_quad[i] receives
+// the block of quadruple i. Returns the number of blocks.
+int profile_find_blocks(int* block_of_quad);
+
+// Write one execution count per block of the current quadruples. Counts
+// already in the file are added to when it profiles the same code.
+int profile_write(const char* filename, const long* counts, int block_count);
+
+// Load a profile of the current quadruples; returns 0 if the file is missing
+// or was recorded for different code
+int profile_load(const char* filename);
+
+// Check if a profile is loaded
+int profile_loaded(void);
+
+// Execution count of the block holding quadruple `quad` of the loaded
+// profile (-1 without a profile or for quadruples the profile does not cover)
+long profile_quad_count(int quad);
+
+// Execution count of the most executed block
+long profile_max_count(void);
+
+// Checksum of a profile file's bytes (0 if it cannot be read), for the cache key
+unsigned int profile_file_checksum(const char* filename);
+
+// Release the loaded profile
+void profile_cleanup(void);
+
+#endif // PHYLOG_PROFILE_H
@@ -6,6 +6,7 @@
 #define PHYLOG_QUADGEN_H
 
 #include "common.h"
+#include "strpool.h"
 
 // Quadruplet structure
 typedef struct {
@@ -54,4 +55,7 @@ void quadgen_cleanup();
 
 void quadgen_set_count(int count);
 
+// Get the pool of display messages (AFFICHER strings, numbered in first-use order)
+StrPool* quadgen_get_messages();
+
 #endif // PHYLOG_QUADGEN_H
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*
+ * strpool.h - Hash-interned string pool for the PHYLOG compiler
+ */
+
+#ifndef PHYLOG_STRPOOL_H
+#define PHYLOG_STRPOOL_H
+
+#include "common.h"
+
+// Pool of distinct strings, numbered 0, 1, ... in first-interned order
+typedef struct StrPool StrPool;
+
+// Create an empty pool
+StrPool* strpool_create(void);
+
+// Intern a string and return its number (the same number for equal strings)
+int strpool_intern(StrPool* pool, const char* text);
+
+// Number of a string already in the pool (-1 if absent)
+int strpool_find(const StrPool* pool, const char* text);
+
+// Number of strings in the pool
+int strpool_count(const StrPool* pool);
+
+// String with the given number
+const char* strpool_get(const StrPool* pool, int id);
+
+// Find strings stored as the tail of a longer one: owner[i] is the string
+// holding string i (i itself if it is stored on its own) and offset[i] the
+// byte offset of string i inside it
+void strpool_share_suffixes(const StrPool* pool, int* owner, int* offset);
+
+// Remove all strings
+void strpool_clear(StrPool* pool);
+
+// Free a pool
+void strpool_destroy(StrPool* pool);
+
+#endif // PHYLOG_STRPOOL_H
@@ -0,0 +1,825 @@
+/*
+ * asm8086.c - Built-in 8086 assembler for the PHYLOG compiler
+ *
+ * Encodes codegen's line stream straight to machine code instead of going
+ * through NASM. The image is a flat .com file: the .text lines at 100h, then
+ * the .data lines, all in one segment (so "mov ax, data" becomes "mov ax, cs").
+ *
+ * Jumps start out short (2 bytes) and are lengthened only when their target
+ * is out of reach, repeating the layout until nothing changes: sizes only
+ * grow, so this ends with every jump in its smallest encoding. A long jmp is
+ * E9 rel16; the 8086 has no near conditional jump, so a long Jcc is the
+ * inverted short Jcc skipping over a jmp near.
+ */
+
+#include <stdint.h>
+#include "../include/asm8086.h"
+#include "../include/codegen.h"
+#include "../include/strpool.h"
+
+#define COM_ORIGIN 0x100
+#define MAX_ENCODING 16
+
+// Operand kinds
+typedef enum {
+    OPERAND_NONE,
+    OPERAND_REG16,
+    OPERAND_REG8,
+    OPERAND_SREG,
+    OPERAND_IMM,
+    OPERAND_MEM
+} OperandKind;
+
+// A parsed operand
+typedef struct {
+    OperandKind kind;
+    int reg;            // Register number
+    int rm;             // Memory: ModRM r/m field, -1 for a direct address
+    int value;          // Immediate value or displacement
+    int symbolic;       // Value depends on a symbol (always encoded as 16 bits)
+    int size;           // Memory: 1 byte, 2 word, 0 unspecified
+} Operand86;
+
+// A line of the image in layout order
+typedef struct {
+    const AsmLine* line;
+    int address;
+    int size;
+    int long_jump;      // Jump lengthened by relaxation
+} ImageItem;
+
+static const char* const reg16_names[] = { "ax", "cx", "dx", "bx", "sp", "bp", "si", "di" };
+static const char* const reg8_names[] = { "al", "cl", "dl", "bl", "ah", "ch", "dh", "bh" };
+static const char* const sreg_names[] = { "es", "cs", "ss", "ds" };
+
+// Conditional jumps and their condition codes (opcode 70h + code)
+static const struct { const char* name; int code; } conditions[] = {
+    { "jo", 0x0 }, { "jno", 0x1 }, { "jb", 0x2 }, { "jc", 0x2 }, { "jnae", 0x2 },
+    { "jae", 0x3 }, { "jnb", 0x3 }, { "jnc", 0x3 }, { "je", 0x4 }, { "jz", 0x4 },
+    { "jne", 0x5 }, { "jnz", 0x5 }, { "jbe", 0x6 }, { "jna", 0x6 }, { "ja", 0x7 },
+    { "jnbe", 0x7 }, { "js", 0x8 }, { "jns", 0x9 }, { "jp", 0xA }, { "jpe", 0xA },
+    { "jnp", 0xB }, { "jpo", 0xB }, { "jl", 0xC }, { "jnge", 0xC }, { "jge", 0xD },
+    { "jnl", 0xD }, { "jle", 0xE }, { "jng", 0xE }, { "jg", 0xF }, { "jnle", 0xF }
+};
+
+// Two-operand ALU instructions (opcode base and /digit)
+static const char* const alu_names[] = { "add", "or", "adc", "sbb", "and", "sub", "xor", "cmp" };
+
+// Shifts and rotates (/digit of D0-D3)
+static const struct { const char* name; int digit; } shifts[] = {
+    { "rol", 0 }, { "ror", 1 }, { "rcl", 2 }, { "rcr", 3 },
+    { "shl", 4 }, { "sal", 4 }, { "shr", 5 }, { "sar", 7 }
+};
+
+// One-operand F6/F7 group (/digit)
+static const struct { const char* name; int digit; } unary[] = {
+    { "not", 2 }, { "neg", 3 }, { "mul", 4 }, { "imul", 5 }, { "div", 6 }, { "idiv", 7 }
+};
+
+// Instructions without operands
+static const struct { const char* name; int opcode; } simple[] = {
+    { "ret", 0xC3 }, { "cwd", 0x99 }, { "cbw", 0x98 }, { "cld", 0xFC }, { "std", 0xFD },
+    { "nop", 0x90 }, { "movsb", 0xA4 }, { "movsw", 0xA5 }, { "stosb", 0xAA }, { "stosw", 0xAB },
+    { "lodsb", 0xAC }, { "lodsw", 0xAD }, { "hlt", 0xF4 }, { "sahf", 0x9E }, { "fwait", 0x9B }
+};
+
+// 8087 instructions on a memory operand (escape opcode and /digit); "wait"
+// marks the forms NASM assembles with a leading fwait
+static const struct { const char* name; int opcode; int digit; int wait; } x87_memory[] = {
+    { "fld", 0xD9, 0, 0 }, { "fst", 0xD9, 2, 0 }, { "fstp", 0xD9, 3, 0 }, { "fldcw", 0xD9, 5, 0 },
+    { "fnstcw", 0xD9, 7, 0 }, { "fstcw", 0xD9, 7, 1 }, { "fnstsw", 0xDD, 7, 0 }, { "fstsw", 0xDD, 7, 1 },
+    { "fadd", 0xD8, 0, 0 }, { "fmul", 0xD8, 1, 0 }, { "fcom", 0xD8, 2, 0 }, { "fcomp", 0xD8, 3, 0 },
+    { "fsub", 0xD8, 4, 0 }, { "fsubr", 0xD8, 5, 0 }, { "fdiv", 0xD8, 6, 0 }, { "fdivr", 0xD8, 7, 0 },
+    { "fild", 0xDF, 0, 0 }, { "fist", 0xDF, 2, 0 }, { "fistp", 0xDF, 3, 0 },
+    { "fiadd", 0xDE, 0, 0 }, { "fimul", 0xDE, 1, 0 }, { "ficom", 0xDE, 2, 0 }, { "ficomp", 0xDE, 3, 0 },
+    { "fisub", 0xDE, 4, 0 }, { "fisubr", 0xDE, 5, 0 }, { "fidiv", 0xDE, 6, 0 }, { "fidivr", 0xDE, 7, 0 }
+};
+
+// Symbols: labels, data names and equ values
+static StrPool* symbol_names = NULL;
+static int* symbol_values = NULL;
+static char* symbol_defined = NULL;
+static int symbol_capacity = 0;
+
+// Set while the layout is final (undefined symbols are errors then)
+static int final_pass = 0;
+
+// Set when a layout pass defines a symbol or moves one
+static int symbols_changed = 0;
+
+// Error reported for the line being encoded
+static char encode_error[160];
+
+// Number of a symbol, creating it when needed
+static int symbol_number(const char* name) {
+    int id = strpool_intern(symbol_names, name);
+    if (id >= symbol_capacity) {
+        int capacity = symbol_capacity ? symbol_capacity * 2 : 256;
+        while (capacity <= id) capacity *= 2;
+        symbol_values = (int*)safe_realloc(symbol_values, capacity * sizeof(int));
+        symbol_defined = (char*)safe_realloc(symbol_defined, capacity);
+        memset(symbol_defined + symbol_capacity, 0, capacity - symbol_capacity);
+        symbol_capacity = capacity;
+    }
+    return id;
+}
+
+// Define a symbol
+static void define_symbol(const char* name, int value) {
+    int id = symbol_number(name);
+    if (!symbol_defined[id] || symbol_values[id] != value) {
+        symbols_changed = 1;
+    }
+    symbol_values[id] = value;
+    symbol_defined[id] = 1;
+}
+
+// Index of a name in a table of names (-1 if absent)
+static int find_name(const char* const* names, int count, const char* name) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+// Check if a value fits a signed byte
+static int fits_int8(int value) {
+    return value >= -128 && value <= 127;
+}
+
+// Read one term of an expression: number (decimal or h-suffixed hex),
+// character literal, register (stored in regs when allowed) or symbol
+static int read_term(const char** text, int* value, int* symbolic, int* regs, int* reg_count) {
+    const char* p = *text;
+    char token[64];
+    int len = 0;
+
+    if (*p == '\'') {
+        if (p[1] == '\0' || p[2] != '\'') return 0;
+        *value = (unsigned char)p[1];
+        *text = p + 3;
+        return 1;
+    }
+    while ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9') ||
+           *p == '_' || *p == '.' || *p == '$') {
+        if (len < (int)sizeof(token) - 1) token[len++] = *p;
+        p++;
+    }
+    token[len] = '\0';
+    *text = p;
+    if (len == 0) return 0;
+
+    if (token[0] >= '0' && token[0] <= '9') {
+        char* end;
+        if (token[len - 1] == 'h' || token[len - 1] == 'H') {
+            token[len - 1] = '\0';
+            *value = (int)strtol(token, &end, 16);
+        } else {
+            *value = (int)strtol(token, &end, 10);
+        }
+        if (*end == '.') {
+            snprintf(encode_error, sizeof(encode_error), "floating-point value '%s' has no 8086 encoding", token);
+        }
+        return *end == '\0';
+    }
+    if (regs && (strcmp(token, "bx") == 0 || strcmp(token, "bp") == 0 ||
+                 strcmp(token, "si") == 0 || strcmp(token, "di") == 0)) {
+        if (*reg_count >= 2) return 0;
+        regs[(*reg_count)++] = find_name(reg16_names, 8, token);
+        *value = 0;
+        return 1;
+    }
+    int id = symbol_number(token);
+    if (!symbol_defined[id] && final_pass) {
+        snprintf(encode_error, sizeof(encode_error), "undefined symbol '%s'", token);
+        return 0;
+    }
+    *value = symbol_defined[id] ? symbol_values[id] : 0;
+    *symbolic = 1;
+    return 1;
+}
+
+// Evaluate "term (+|- term)*"; registers are only accepted inside memory operands
+static int eval_expression(const char* text, int* value, int* symbolic, int* regs, int* reg_count) {
+    int total = 0, sign = 1, expect_term = 1;
+    *symbolic = 0;
+    while (*text) {
+        if (*text == ' ') {
+            text++;
+        } else if (*text == '+' || *text == '-') {
+            sign = (*text == '-') ? -sign : sign;
+            text++;
+            expect_term = 1;
+        } else {
+            int term = 0;
+            int reg_before = reg_count ? *reg_count : 0;
+            if (!expect_term || !read_term(&text, &term, symbolic, regs, reg_count)) return 0;
+            if (reg_count && *reg_count != reg_before && sign < 0) return 0;
+            total += sign * term;
+            sign = 1;
+            expect_term = 0;
+        }
+    }
+    *value = total;
+    return !expect_term;
+}
+
+// ModRM r/m field of a base/index register pair (-1 if not addressable)
+static int memory_rm(const int* regs, int count) {
+    static const struct { int a, b, rm; } pairs[] = {
+        { 3, 6, 0 }, { 3, 7, 1 }, { 5, 6, 2 }, { 5, 7, 3 }
+    };
+    if (count == 1) {
+        switch (regs[0]) {
+            case 6: return 4;   // si
+            case 7: return 5;   // di
+            case 5: return 6;   // bp
+            case 3: return 7;   // bx
+        }
+        return -1;
+    }
+    for (int i = 0; i < 4; i++) {
+        if ((regs[0] == pairs[i].a && regs[1] == pairs[i].b) ||
+            (regs[1] == pairs[i].a && regs[0] == pairs[i].b)) {
+            return pairs[i].rm;
+        }
+    }
+    return -1;
+}
+
+// Parse an operand
+static int parse_operand(const char* text, Operand86* op) {
+    char buffer[160];
+    int index;
+
+    memset(op, 0, sizeof(*op));
+    while (*text == ' ') text++;
+    snprintf(buffer, sizeof(buffer), "%s", text);
+    for (int len = (int)strlen(buffer); len > 0 && buffer[len - 1] == ' '; len--) buffer[len - 1] = '\0';
+
+    char* p = buffer;
+    if (strncmp(p, "dword ", 6) == 0) { op->size = 4; p += 6; }
+    else if (strncmp(p, "word ", 5) == 0) { op->size = 2; p += 5; }
+    else if (strncmp(p, "byte ", 5) == 0) { op->size = 1; p += 5; }
+    while (*p == ' ') p++;
+
+    if ((index = find_name(reg16_names, 8, p)) >= 0) {
+        op->kind = OPERAND_REG16;
+        op->reg = index;
+        return 1;
+    }
+    if ((index = find_name(reg8_names, 8, p)) >= 0) {
+        op->kind = OPERAND_REG8;
+        op->reg = index;
+        return 1;
+    }
+    if ((index = find_name(sreg_names, 4, p)) >= 0) {
+        op->kind = OPERAND_SREG;
+        op->reg = index;
+        return 1;
+    }
+    if (*p == '[') {
+        char* end = strrchr(p, ']');
+        int regs[2], reg_count = 0;
+        if (!end || end[1] != '\0') return 0;
+        *end = '\0';
+        op->kind = OPERAND_MEM;
+        if (!eval_expression(p + 1, &op->value, &op->symbolic, regs, &reg_count)) return 0;
+        op->rm = reg_count ? memory_rm(regs, reg_count) : -1;
+        return reg_count == 0 || op->rm >= 0;
+    }
+    op->kind = OPERAND_IMM;
+    return eval_expression(p, &op->value, &op->symbolic, NULL, NULL);
+}
+
+// Split "a, b" at the top-level comma (not inside quotes or brackets)
+static int split_operands(const char* text, char parts[][160], int max_parts) {
+    int count = 0, depth = 0, quote = 0, len = 0;
+    if (*text == '\0') return 0;
+    for (const char* p = text; ; p++) {
+        if (*p == '\0' || (*p == ',' && !depth && !quote)) {
+            if (count < max_parts) parts[count][len] = '\0';
+            count++;
+            len = 0;
+            if (*p == '\0') break;
+            continue;
+        }
+        if (*p == '\'') quote = !quote;
+        if (!quote && *p == '[') depth++;
+        if (!quote && *p == ']') depth--;
+        if (count < max_parts && len < 159) parts[count][len++] = *p;
+    }
+    return count;
+}
+
+// Append a byte / a little-endian word to an encoding
+static void put_byte(uint8_t* out, int* n, int value) {
+    out[(*n)++] = (uint8_t)value;
+}
+
+static void put_word(uint8_t* out, int* n, int value) {
+    out[(*n)++] = (uint8_t)(value & 0xFF);
+    out[(*n)++] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+// ModRM (and displacement) for a register field and a register or memory operand
+static void put_modrm(uint8_t* out, int* n, int reg_field, const Operand86* rm) {
+    if (rm->kind != OPERAND_MEM) {
+        put_byte(out, n, 0xC0 | (reg_field << 3) | rm->reg);
+    } else if (rm->rm < 0) {
+        put_byte(out, n, 0x06 | (reg_field << 3));
+        put_word(out, n, rm->value);
+    } else if (rm->value == 0 && !rm->symbolic && rm->rm != 6) {
+        put_byte(out, n, (reg_field << 3) | rm->rm);
+    } else if (!rm->symbolic && fits_int8(rm->value)) {
+        put_byte(out, n, 0x40 | (reg_field << 3) | rm->rm);
+        put_byte(out, n, rm->value);
+    } else {
+        put_byte(out, n, 0x80 | (reg_field << 3) | rm->rm);
+        put_word(out, n, rm->value);
+    }
+}
+
+// Check if an operand is a register or memory operand of the given width
+static int is_rm(const Operand86* op, int word) {
+    if (op->kind == OPERAND_MEM) return op->size == 0 || op->size == (word ? 2 : 1);
+    return op->kind == (word ? OPERAND_REG16 : OPERAND_REG8);
+}
+
+// Encode a jump or call to a label (relaxed jumps are long)
+static int encode_jump(const char* mnemonic, const char* target, const ImageItem* item, uint8_t* out) {
+    Operand86 op;
+    int n = 0;
+    int condition = -1;
+
+    while (strncmp(target, "short ", 6) == 0 || strncmp(target, "near ", 5) == 0) {
+        target += (target[0] == 's') ? 6 : 5;
+    }
+    if (!parse_operand(target, &op) || op.kind != OPERAND_IMM) {
+        snprintf(encode_error, sizeof(encode_error), "bad jump target '%s'", target);
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++) {
+        if (strcmp(mnemonic, conditions[i].name) == 0) condition = conditions[i].code;
+    }
+
+    int next = item->address;
+    if (strcmp(mnemonic, "call") == 0) {
+        put_byte(out, &n, 0xE8);
+        put_word(out, &n, op.value - (next + 3));
+    } else if (!item->long_jump) {
+        put_byte(out, &n, condition >= 0 ? 0x70 | condition : 0xEB);
+        put_byte(out, &n, op.value - (next + 2));
+    } else if (condition < 0) {
+        put_byte(out, &n, 0xE9);
+        put_word(out, &n, op.value - (next + 3));
+    } else {
+        put_byte(out, &n, 0x70 | (condition ^ 1));   // Inverted condition skips the jmp
+        put_byte(out, &n, 3);
+        put_byte(out, &n, 0xE9);
+        put_word(out, &n, op.value - (next + 5));
+    }
+    return n;
+}
+
+// Check if a mnemonic is a jump that relaxation may lengthen
+static int is_relaxable_jump(const char* mnemonic) {
+    if (strcmp(mnemonic, "jmp") == 0) return 1;
+    for (size_t i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++) {
+        if (strcmp(mnemonic, conditions[i].name) == 0) return 1;
+    }
+    return 0;
+}
+
+// Encode one instruction; returns its size or -1 (encode_error says why)
+static int encode_instruction(const char* mnemonic, const char* operands, const ImageItem* item, uint8_t* out) {
+    char parts[3][160];
+    Operand86 a, b;
+    int n = 0, index;
+
+    // Prefix: rep <string instruction>
+    if (strcmp(mnemonic, "rep") == 0 || strcmp(mnemonic, "repe") == 0 || strcmp(mnemonic, "repne") == 0) {
+        char rest[32];
+        put_byte(out, &n, strcmp(mnemonic, "repne") == 0 ? 0xF2 : 0xF3);
+        snprintf(rest, sizeof(rest), "%s", operands);
+        int size = encode_instruction(rest, "", item, out + 1);
+        return size < 0 ? -1 : size + 1;
+    }
+    for (size_t i = 0; i < sizeof(simple) / sizeof(simple[0]); i++) {
+        if (strcmp(mnemonic, simple[i].name) == 0 && operands[0] == '\0') {
+            put_byte(out, &n, simple[i].opcode);
+            return n;
+        }
+    }
+    if (is_relaxable_jump(mnemonic) || strcmp(mnemonic, "call") == 0) {
+        return encode_jump(mnemonic, operands, item, out);
+    }
+    if (strcmp(mnemonic, "finit") == 0 && operands[0] == '\0') {
+        put_byte(out, &n, 0x9B);
+        put_byte(out, &n, 0xDB);
+        put_byte(out, &n, 0xE3);
+        return n;
+    }
+
+    int count = split_operands(operands, parts, 3);
+    if (count > 2 || (count >= 1 && !parse_operand(parts[0], &a)) ||
+        (count == 2 && strcmp(parts[1], " data") != 0 && strcmp(parts[1], "data") != 0 &&
+         !parse_operand(parts[1], &b))) {
+        if (encode_error[0] == '\0') {
+            snprintf(encode_error, sizeof(encode_error), "bad operands '%s'", operands);
+        }
+        return -1;
+    }
+
+    if (strcmp(mnemonic, "mov") == 0 && count == 2) {
+        // The program segment: one segment for code and data in a .com
+        if (strstr(parts[1], "data") && a.kind == OPERAND_REG16 && !strchr(parts[1], '[')) {
+            put_byte(out, &n, 0x8C);
+            put_byte(out, &n, 0xC0 | (1 << 3) | a.reg);   // mov r16, cs
+            return n;
+        }
+        int word = a.kind == OPERAND_REG16 || b.kind == OPERAND_REG16 ||
+                   (a.kind == OPERAND_MEM && a.size == 2);
+        if (a.kind == OPERAND_SREG && b.kind == OPERAND_REG16) {
+            put_byte(out, &n, 0x8E);
+            put_modrm(out, &n, a.reg, &b);
+        } else if (b.kind == OPERAND_SREG && a.kind == OPERAND_REG16) {
+            put_byte(out, &n, 0x8C);
+            put_modrm(out, &n, b.reg, &a);
+        } else if ((a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8) && b.kind == OPERAND_IMM) {
+            put_byte(out, &n, (word ? 0xB8 : 0xB0) + a.reg);
+            if (word) put_word(out, &n, b.value); else put_byte(out, &n, b.value);
+        } else if ((a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8) && b.kind == OPERAND_MEM && is_rm(&b, word)) {
+            if (a.reg == 0 && b.rm < 0) {
+                put_byte(out, &n, word ? 0xA1 : 0xA0);
+                put_word(out, &n, b.value);
+            } else {
+                put_byte(out, &n, word ? 0x8B : 0x8A);
+                put_modrm(out, &n, a.reg, &b);
+            }
+        } else if (is_rm(&a, word) && (b.kind == OPERAND_REG16 || b.kind == OPERAND_REG8) &&
+                   (b.kind == OPERAND_REG16) == word) {
+            if (b.reg == 0 && a.kind == OPERAND_MEM && a.rm < 0) {
+                put_byte(out, &n, word ? 0xA3 : 0xA2);
+                put_word(out, &n, a.value);
+            } else {
+                put_byte(out, &n, word ? 0x89 : 0x88);
+                put_modrm(out, &n, b.reg, &a);
+            }
+        } else if (a.kind == OPERAND_MEM && a.size && b.kind == OPERAND_IMM) {
+            put_byte(out, &n, word ? 0xC7 : 0xC6);
+            put_modrm(out, &n, 0, &a);
+            if (word) put_word(out, &n, b.value); else put_byte(out, &n, b.value);
+        } else {
+            n = -1;
+        }
+    }
+    else if ((index = find_name(alu_names, 8, mnemonic)) >= 0 && count == 2) {
+        int word = a.kind == OPERAND_REG16 || b.kind == OPERAND_REG16 || (a.kind == OPERAND_MEM && a.size == 2);
+        if (b.kind == OPERAND_IMM && is_rm(&a, word) && (a.kind != OPERAND_MEM || a.size)) {
+            if (!word) {
+                put_byte(out, &n, a.kind == OPERAND_REG8 && a.reg == 0 ? 0x04 + 8 * index : 0x80);
+                if (!(a.kind == OPERAND_REG8 && a.reg == 0)) put_modrm(out, &n, index, &a);
+                put_byte(out, &n, b.value);
+            } else if (!b.symbolic && fits_int8(b.value)) {
+                put_byte(out, &n, 0x83);
+                put_modrm(out, &n, index, &a);
+                put_byte(out, &n, b.value);
+            } else if (a.kind == OPERAND_REG16 && a.reg == 0) {
+                put_byte(out, &n, 0x05 + 8 * index);
+                put_word(out, &n, b.value);
+            } else {
+                put_byte(out, &n, 0x81);
+                put_modrm(out, &n, index, &a);
+                put_word(out, &n, b.value);
+            }
+        } else if ((b.kind == OPERAND_REG16 || b.kind == OPERAND_REG8) && is_rm(&a, b.kind == OPERAND_REG16)) {
+            put_byte(out, &n, 8 * index + (b.kind == OPERAND_REG16 ? 0x01 : 0x00));
+            put_modrm(out, &n, b.reg, &a);
+        } else if ((a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8) && b.kind == OPERAND_MEM &&
+                   is_rm(&b, a.kind == OPERAND_REG16)) {
+            put_byte(out, &n, 8 * index + (a.kind == OPERAND_REG16 ? 0x03 : 0x02));
+            put_modrm(out, &n, a.reg, &b);
+        } else {
+            n = -1;
+        }
+    }
+    else if (strcmp(mnemonic, "test") == 0 && count == 2) {
+        int word = a.kind == OPERAND_REG16 || (a.kind == OPERAND_MEM && a.size == 2);
+        if (b.kind == OPERAND_IMM && is_rm(&a, word)) {
+            if (a.kind != OPERAND_MEM && a.reg == 0) {
+                put_byte(out, &n, word ? 0xA9 : 0xA8);
+            } else {
+                put_byte(out, &n, word ? 0xF7 : 0xF6);
+                put_modrm(out, &n, 0, &a);
+            }
+            if (word) put_word(out, &n, b.value); else put_byte(out, &n, b.value);
+        } else if ((b.kind == OPERAND_REG16 || b.kind == OPERAND_REG8) && is_rm(&a, b.kind == OPERAND_REG16)) {
+            put_byte(out, &n, b.kind == OPERAND_REG16 ? 0x85 : 0x84);
+            put_modrm(out, &n, b.reg, &a);
+        } else {
+            n = -1;
+        }
+    }
+    else if (strcmp(mnemonic, "lea") == 0 && count == 2 && a.kind == OPERAND_REG16 && b.kind == OPERAND_MEM) {
+        put_byte(out, &n, 0x8D);
+        put_modrm(out, &n, a.reg, &b);
+    }
+    else if ((strcmp(mnemonic, "push") == 0 || strcmp(mnemonic, "pop") == 0) && count == 1) {
+        int pop = mnemonic[1] == 'o';
+        if (a.kind == OPERAND_REG16) {
+            put_byte(out, &n, (pop ? 0x58 : 0x50) + a.reg);
+        } else if (a.kind == OPERAND_SREG && !(pop && a.reg == 1)) {
+            put_byte(out, &n, (pop ? 0x07 : 0x06) | (a.reg << 3));
+        } else {
+            n = -1;
+        }
+    }
+    else if ((strcmp(mnemonic, "inc") == 0 || strcmp(mnemonic, "dec") == 0) && count == 1) {
+        int dec = mnemonic[0] == 'd';
+        if (a.kind == OPERAND_REG16) {
+            put_byte(out, &n, (dec ? 0x48 : 0x40) + a.reg);
+        } else if (a.kind == OPERAND_REG8 || (a.kind == OPERAND_MEM && a.size)) {
+            put_byte(out, &n, a.kind == OPERAND_REG8 || a.size == 1 ? 0xFE : 0xFF);
+            put_modrm(out, &n, dec, &a);
+        } else {
+            n = -1;
+        }
+    }
+    else if (strcmp(mnemonic, "xchg") == 0 && count == 2) {
+        int word = a.kind == OPERAND_REG16 || b.kind == OPERAND_REG16;
+        if (a.kind == OPERAND_MEM) {
+            Operand86 swap = a;
+            a = b;
+            b = swap;
+        }
+        if (a.kind == OPERAND_REG16 && b.kind == OPERAND_REG16 && (a.reg == 0 || b.reg == 0)) {
+            put_byte(out, &n, 0x90 + a.reg + b.reg);
+        } else if ((a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8) && is_rm(&b, word)) {
+            put_byte(out, &n, word ? 0x87 : 0x86);
+            put_modrm(out, &n, a.reg, &b);
+        } else {
+            n = -1;
+        }
+    }
+    else if (strcmp(mnemonic, "int") == 0 && count == 1 && a.kind == OPERAND_IMM) {
+        put_byte(out, &n, 0xCD);
+        put_byte(out, &n, a.value);
+    }
+    else {
+        n = -1;
+        for (size_t i = 0; i < sizeof(x87_memory) / sizeof(x87_memory[0]); i++) {
+            if (strcmp(mnemonic, x87_memory[i].name) == 0 && count == 1 && a.kind == OPERAND_MEM) {
+                n = 0;
+                if (x87_memory[i].wait) put_byte(out, &n, 0x9B);
+                put_byte(out, &n, x87_memory[i].opcode);
+                put_modrm(out, &n, x87_memory[i].digit, &a);
+            }
+        }
+        for (size_t i = 0; i < sizeof(unary) / sizeof(unary[0]); i++) {
+            if (strcmp(mnemonic, unary[i].name) == 0 && count == 1 &&
+                (a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8 || (a.kind == OPERAND_MEM && a.size))) {
+                n = 0;
+                put_byte(out, &n, a.kind == OPERAND_REG8 || a.size == 1 ? 0xF6 : 0xF7);
+                put_modrm(out, &n, unary[i].digit, &a);
+            }
+        }
+        for (size_t i = 0; i < sizeof(shifts) / sizeof(shifts[0]); i++) {
+            if (strcmp(mnemonic, shifts[i].name) == 0 && count == 2 &&
+                (a.kind == OPERAND_REG16 || a.kind == OPERAND_REG8 || (a.kind == OPERAND_MEM && a.size))) {
+                int word = a.kind == OPERAND_REG16 || a.size == 2;
+                if (b.kind == OPERAND_REG8 && b.reg == 1) {
+                    n = 0;
+                    put_byte(out, &n, word ? 0xD3 : 0xD2);
+                    put_modrm(out, &n, shifts[i].digit, &a);
+                } else if (b.kind == OPERAND_IMM && b.value == 1 && !b.symbolic) {
+                    n = 0;
+                    put_byte(out, &n, word ? 0xD1 : 0xD0);
+                    put_modrm(out, &n, shifts[i].digit, &a);
+                } else {
+                    snprintf(encode_error, sizeof(encode_error), "the 8086 shifts by 1 or by CL only");
+                }
+            }
+        }
+    }
+
+    if (n < 0 && encode_error[0] == '\0') {
+        snprintf(encode_error, sizeof(encode_error), "unsupported instruction");
+    }
+    return n;
+}
+
+// Encode a data definition (db/dw/dd lists, times N d?, equ); returns its size or -1
+static int encode_data(const char* definition, int address, const char* name, uint8_t* out, int capacity) {
+    char keyword[16] = {0};
+    const char* rest = definition;
+    int repeat = 1, n = 0;
+
+    if (strncmp(rest, "times ", 6) == 0) {
+        int symbolic;
+        char count_text[32] = {0};
+        rest += 6;
+        sscanf(rest, "%31s", count_text);
+        if (!eval_expression(count_text, &repeat, &symbolic, NULL, NULL) || repeat < 0) return -1;
+        rest += strlen(count_text);
+        while (*rest == ' ') rest++;
+    }
+    sscanf(rest, "%15s", keyword);
+    rest += strlen(keyword);
+    while (*rest == ' ') rest++;
+
+    if (strcmp(keyword, "equ") == 0) {
+        int value, symbolic;
+        if (!eval_expression(rest, &value, &symbolic, NULL, NULL)) return -1;
+        define_symbol(name, value);
+        return 0;
+    }
+    int width = strcmp(keyword, "dd") == 0 ? 4 : strcmp(keyword, "dw") == 0 ? 2 : 1;
+    if (width == 1 && strcmp(keyword, "db") != 0) return -1;
+    define_symbol(name, address);
+
+    char parts[32][160];
+    int count = split_operands(rest, parts, 32);
+    if (count > 32) return -1;
+    for (int r = 0; r < repeat; r++) {
+        for (int i = 0; i < count; i++) {
+            const char* item = parts[i];
+            while (*item == ' ') item++;
+            int len = (int)strlen(item);
+            while (len > 0 && item[len - 1] == ' ') len--;
+            if (width == 1 && len >= 2 && item[0] == '\'' && item[len - 1] == '\'' && len != 3) {
+                for (int k = 1; k < len - 1; k++) {
+                    if (out && n < capacity) out[n] = (uint8_t)item[k];
+                    n++;
+                }
+                continue;
+            }
+            int value, symbolic;
+            uint32_t bits;
+            if (width == 4 && strchr(item, '.')) {
+                // Float literal: IEEE single precision
+                char* end;
+                float f = strtof(item, &end);
+                while (*end == ' ') end++;
+                if (*end != '\0') return -1;
+                memcpy(&bits, &f, sizeof(bits));
+            } else {
+                if (!eval_expression(item, &value, &symbolic, NULL, NULL)) return -1;
+                bits = (uint32_t)value;
+            }
+            if (out && n + width <= capacity) {
+                for (int k = 0; k < width; k++) {
+                    out[n + k] = (uint8_t)((bits >> (8 * k)) & 0xFF);
+                }
+            }
+            n += width;
+        }
+    }
+    return n;
+}
+
+// Lay out the items from the given address; returns the end address or -1
+static int layout(ImageItem* items, int count, uint8_t* image) {
+    uint8_t encoding[MAX_ENCODING];
+    int address = COM_ORIGIN;
+
+    for (int i = 0; i < count; i++) {
+        ImageItem* item = &items[i];
+        const AsmLine* line = item->line;
+        item->address = address;
+        encode_error[0] = '\0';
+
+        if (line->kind == ASM_LINE_LABEL) {
+            define_symbol(line->mnemonic, address);
+            item->size = 0;
+        } else if (line->kind == ASM_LINE_INSTR) {
+            item->size = encode_instruction(line->mnemonic, line->operands, item, encoding);
+            if (item->size < 0) {
+                report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot encode '%s %s': %s",
+                             line->mnemonic, line->operands, encode_error);
+                return -1;
+            }
+            if (image) memcpy(image + (address - COM_ORIGIN), encoding, item->size);
+        } else {
+            item->size = encode_data(line->operands, address, line->mnemonic,
+                                     image ? image + (address - COM_ORIGIN) : NULL, 1 << 20);
+            if (item->size < 0) {
+                report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot encode data '%s %s'%s%s",
+                             line->mnemonic, line->operands, encode_error[0] ? ": " : "", encode_error);
+                return -1;
+            }
+        }
+        address += item->size;
+    }
+    return address;
+}
+
+// Release the symbol table
+static void free_symbols(void) {
+    strpool_destroy(symbol_names);
+    symbol_names = NULL;
+    free(symbol_values);
+    symbol_values = NULL;
+    free(symbol_defined);
+    symbol_defined = NULL;
+    symbol_capacity = 0;
+}
+
+// Encode the last generated assembly stream into a flat .com image
+int asm8086_write_com(const char* filename) {
+    int line_count = codegen_get_line_count();
+    ImageItem* items = (ImageItem*)safe_malloc((line_count + 1) * sizeof(ImageItem));
+    int count = 0, code_items;
+
+    // Code first (execution starts at 100h), then the data
+    for (int section = 0; section < 2; section++) {
+        int in_data = 0;
+        for (int i = 0; i < line_count; i++) {
+            const AsmLine* line = codegen_get_line(i);
+            if (line->kind == ASM_LINE_SECTION) {
+                in_data = strcmp(line->mnemonic, ".data") == 0;
+            } else if (in_data == (section == 1) &&
+                       (line->kind == ASM_LINE_INSTR || line->kind == ASM_LINE_LABEL ||
+                        line->kind == ASM_LINE_DATA)) {
+                memset(&items[count], 0, sizeof(ImageItem));
+                items[count++].line = line;
+            }
+        }
+        if (section == 0) code_items = count;
+    }
+
+    // Relax: lengthen out-of-range jumps until the layout is stable. Code is
+    // encoded before the data, so an equ naming a later message (msgA equ
+    // msgB + 1) only has its value for the code in the next pass: passes
+    // repeat until no symbol changes either.
+    symbol_names = strpool_create();
+    final_pass = 0;
+    int end = -1, passes = 0, changed = 1;
+    while (changed) {
+        symbols_changed = 0;
+        passes++;
+        end = layout(items, count, NULL);
+        if (end < 0) break;
+        changed = symbols_changed;
+        for (int i = 0; i < code_items; i++) {
+            ImageItem* item = &items[i];
+            if (item->line->kind != ASM_LINE_INSTR || item->long_jump ||
+                !is_relaxable_jump(item->line->mnemonic)) {
+                continue;
+            }
+            const char* target = item->line->operands;
+            if (strncmp(target, "short ", 6) == 0) continue;
+            if (strncmp(target, "near ", 5) == 0) target += 5;
+            int id = strpool_find(symbol_names, target);
+            int distance = (id >= 0 && symbol_defined[id]) ? symbol_values[id] - (item->address + 2) : 0;
+            if (!fits_int8(distance)) {
+                item->long_jump = 1;
+                changed = 1;
+            }
+        }
+    }
+
+    // Final layout with every symbol known, written into the image
+    uint8_t* image = NULL;
+    if (end >= 0) {
+        final_pass = 1;
+        image = (uint8_t*)calloc(end - COM_ORIGIN + 1, 1);
+        if (!image) {
+            report_error(ERROR_LEVEL_FATAL, 0, 0, "Memory allocation failed");
+        }
+        end = layout(items, count, image);
+        final_pass = 0;
+    }
+    if (end >= 0 && end > 0x10000) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Program does not fit a .com segment (%d bytes)", end - COM_ORIGIN);
+        end = -1;
+    }
+
+    int ok = 0;
+    if (end >= 0) {
+        FILE* file = fopen(filename, "wb");
+        if (!file) {
+            report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open output file '%s'", filename);
+        } else {
+            ok = fwrite(image, 1, end - COM_ORIGIN, file) == (size_t)(end - COM_ORIGIN);
+            ok = (fclose(file) == 0) && ok;
+        }
+    }
+
+    if (ok) {
+        int short_jumps = 0, long_jumps = 0;
+        int code_end = code_items < count ? items[code_items].address : end;
+        for (int i = 0; i < code_items; i++) {
+            if (items[i].line->kind == ASM_LINE_INSTR && is_relaxable_jump(items[i].line->mnemonic)) {
+                if (items[i].long_jump) long_jumps++; else short_jumps++;
+            }
+        }
+        printf("Binary written to '%s': %d bytes (code %d, data %d), %d short and %d near jumps, %d layout passes\n",
+               filename, end - COM_ORIGIN, code_end - COM_ORIGIN, end - code_end, short_jumps, long_jumps, passes);
+    }
+
+    free(image);
+    free(items);
+    free_symbols();
+    return ok;
+}
@@ -0,0 +1,401 @@
+/*
+ * cache.c - Content-addressed compilation cache for the PHYLOG compiler
+ *
+ * Each entry is a directory <cache>/<key>/ holding the output files of one
+ * compilation plus a "meta" file (exit status and compiler build). The key is a
+ * 64-bit FNV-1a hash of the source bytes, the compiler build and the
+ * option string. The build is identified by a hash of the running
+ * executable, so any rebuild of the compiler starts from fresh entries
+ * instead of returning outputs of the code it replaced. Entry directories are touched on every hit, so their
+ * modification time orders them for LRU eviction.
+ */
+
+#include "../include/cache.h"
+#include "../include/irbin.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+#include <time.h>
+
+#define CACHE_DIR_LENGTH 256     // Cache directory path
+#define CACHE_ENTRY_LENGTH 320   // Entry directory path (directory + key)
+#define CACHE_PATH_LENGTH 512    // File path inside an entry
+
+static char cache_dir[CACHE_DIR_LENGTH];
+static long cache_max_bytes = CACHE_DEFAULT_MAX_BYTES;
+static CacheStats stats;
+static int cache_open = 0;
+static unsigned long long build_id = 0;  // Hash of the compiler executable
+
+// Cache entry found while scanning for eviction
+typedef struct {
+    char key[CACHE_KEY_LENGTH + 1];
+    time_t last_used;
+    long bytes;
+} CacheEntry;
+
+// FNV-1a 64-bit hash, continued from a previous value
+static unsigned long long fnv1a64(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Check that a name looks like a cache key
+static int is_cache_key(const char* name) {
+    if (strlen(name) != CACHE_KEY_LENGTH) return 0;
+    for (int i = 0; i < CACHE_KEY_LENGTH; i++) {
+        char c = name[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return 0;
+    }
+    return 1;
+}
+
+// Copy a file; returns the number of bytes copied or -1
+static long copy_file(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    if (!in) {
+        return -1;
+    }
+    FILE* out = fopen(to, "wb");
+    if (!out) {
+        fclose(in);
+        return -1;
+    }
+
+    char buffer[8192];
+    size_t n;
+    long total = 0;
+    while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        if (fwrite(buffer, 1, n, out) != n) {
+            total = -1;
+            break;
+        }
+        total += (long)n;
+    }
+
+    fclose(in);
+    if (fclose(out) != 0) {
+        total = -1;
+    }
+    return total;
+}
+
+// Remove an entry directory and its files; returns the bytes freed
+static long remove_entry_dir(const char* path) {
+    long freed = 0;
+    DIR* dir = opendir(path);
+    if (dir) {
+        struct dirent* ent;
+        while ((ent = readdir(dir)) != NULL) {
+            if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+            char file[CACHE_PATH_LENGTH];
+            struct stat st;
+            snprintf(file, sizeof(file), "%s/%s", path, ent->d_name);
+            if (stat(file, &st) == 0) freed += (long)st.st_size;
+            remove(file);
+        }
+        closedir(dir);
+    }
+    rmdir(path);
+    return freed;
+}
+
+// Size of all files in an entry directory
+static long entry_size(const char* path) {
+    long total = 0;
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return 0;
+    }
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        char file[CACHE_PATH_LENGTH];
+        struct stat st;
+        snprintf(file, sizeof(file), "%s/%s", path, ent->d_name);
+        if (stat(file, &st) == 0) total += (long)st.st_size;
+    }
+    closedir(dir);
+    return total;
+}
+
+// Load persisted statistics
+static void load_stats(void) {
+    char path[CACHE_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/stats", cache_dir);
+
+    memset(&stats, 0, sizeof(stats));
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        return;
+    }
+    if (fscanf(file, "hits %ld misses %ld stores %ld evictions %ld",
+               &stats.hits, &stats.misses, &stats.stores, &stats.evictions) != 4) {
+        memset(&stats, 0, sizeof(stats));
+    }
+    fclose(file);
+}
+
+// Save statistics
+static void save_stats(void) {
+    char path[CACHE_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/stats", cache_dir);
+
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        return;
+    }
+    fprintf(file, "hits %ld\nmisses %ld\nstores %ld\nevictions %ld\n",
+            stats.hits, stats.misses, stats.stores, stats.evictions);
+    fclose(file);
+}
+
+// Identify the running compiler build: a hash of its executable, or of the
+// build date and time of this file where the executable cannot be read
+static unsigned long long compute_build_id(void) {
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = fnv1a64(hash, PHYLOG_VERSION, sizeof(PHYLOG_VERSION));
+    FILE* exe = fopen("/proc/self/exe", "rb");
+    if (!exe) {
+        return fnv1a64(hash, __DATE__ " " __TIME__, sizeof(__DATE__ " " __TIME__));
+    }
+    char buffer[8192];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), exe)) > 0) {
+        hash = fnv1a64(hash, buffer, n);
+    }
+    fclose(exe);
+    return hash;
+}
+
+// Open (and create if needed) a cache directory
+int cache_init(const char* dir, long max_bytes) {
+    struct stat st;
+
+    if (strlen(dir) >= CACHE_DIR_LENGTH) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cache directory path too long: %s", dir);
+        return 0;
+    }
+    if (stat(dir, &st) != 0) {
+        if (mkdir(dir, 0755) != 0) {
+            report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot create cache directory '%s'", dir);
+            return 0;
+        }
+    } else if (!S_ISDIR(st.st_mode)) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cache path '%s' is not a directory", dir);
+        return 0;
+    }
+
+    snprintf(cache_dir, sizeof(cache_dir), "%s", dir);
+    cache_max_bytes = max_bytes > 0 ? max_bytes : CACHE_DEFAULT_MAX_BYTES;
+    build_id = compute_build_id();
+    load_stats();
+    cache_open = 1;
+    return 1;
+}
+
+// Compute the key of a compilation from the source bytes and the option set
+int cache_compute_key(const char* source_file, const char* options, char key[CACHE_KEY_LENGTH + 1]) {
+    FILE* file = fopen(source_file, "rb");
+    if (!file) {
+        return 0;
+    }
+
+    unsigned long long hash = 14695981039346656037ULL;
+    char buffer[8192];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        hash = fnv1a64(hash, buffer, n);
+    }
+    fclose(file);
+
+    // Separate the fields so that different splits cannot collide
+    int irbin_version = IRBIN_VERSION;
+    hash = fnv1a64(hash, "\0", 1);
+    hash = fnv1a64(hash, &build_id, sizeof(build_id));
+    hash = fnv1a64(hash, &irbin_version, sizeof(irbin_version));
+    hash = fnv1a64(hash, "\0", 1);
+    hash = fnv1a64(hash, options, strlen(options));
+
+    snprintf(key, CACHE_KEY_LENGTH + 1, "%016llx", hash);
+    return 1;
+}
+
+// Copy a cached entry to <output_prefix>.<suffix> for each suffix; returns 1 on a hit
+int cache_lookup(const char* key, const char* output_prefix, const char* const* suffixes, int* status) {
+    char entry[CACHE_ENTRY_LENGTH];
+    char path[CACHE_PATH_LENGTH];
+    char output[CACHE_PATH_LENGTH];
+
+    if (!cache_open) {
+        return 0;
+    }
+
+    snprintf(entry, sizeof(entry), "%s/%s", cache_dir, key);
+    snprintf(path, sizeof(path), "%s/meta", entry);
+
+    // The meta file is written last, so its presence marks a complete entry
+    FILE* meta = fopen(path, "r");
+    int cached_status = 0;
+    if (!meta || fscanf(meta, "status %d", &cached_status) != 1) {
+        if (meta) fclose(meta);
+        stats.misses++;
+        return 0;
+    }
+    fclose(meta);
+
+    for (int i = 0; suffixes[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", entry, suffixes[i]);
+        snprintf(output, sizeof(output), "%s.%s", output_prefix, suffixes[i]);
+        if (copy_file(path, output) < 0) {
+            report_error(ERROR_LEVEL_WARNING, 0, 0, "Incomplete cache entry %s, recompiling", key);
+            remove_entry_dir(entry);
+            stats.misses++;
+            return 0;
+        }
+    }
+
+    // Mark the entry as most recently used
+    utime(entry, NULL);
+
+    stats.hits++;
+    *status = cached_status;
+    return 1;
+}
+
+// Sort entries oldest first
+static int compare_entries(const void* a, const void* b) {
+    const CacheEntry* ea = (const CacheEntry*)a;
+    const CacheEntry* eb = (const CacheEntry*)b;
+    if (ea->last_used != eb->last_used) {
+        return ea->last_used < eb->last_used ? -1 : 1;
+    }
+    return strcmp(ea->key, eb->key);
+}
+
+// Evict least recently used entries until the cache fits its bound
+static void evict_entries(const char* keep_key) {
+    DIR* dir = opendir(cache_dir);
+    if (!dir) {
+        return;
+    }
+
+    int capacity = 64;
+    int count = 0;
+    long total = 0;
+    CacheEntry* entries = (CacheEntry*)safe_malloc(capacity * sizeof(CacheEntry));
+    struct dirent* ent;
+
+    while ((ent = readdir(dir)) != NULL) {
+        if (!is_cache_key(ent->d_name)) continue;
+
+        char path[CACHE_ENTRY_LENGTH + 256];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, ent->d_name);
+        if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) continue;
+
+        if (count >= capacity) {
+            capacity *= 2;
+            entries = (CacheEntry*)safe_realloc(entries, capacity * sizeof(CacheEntry));
+        }
+        memcpy(entries[count].key, ent->d_name, CACHE_KEY_LENGTH + 1);
+        entries[count].last_used = st.st_mtime;
+        entries[count].bytes = entry_size(path);
+        total += entries[count].bytes;
+        count++;
+    }
+    closedir(dir);
+
+    qsort(entries, count, sizeof(CacheEntry), compare_entries);
+
+    for (int i = 0; i < count && total > cache_max_bytes; i++) {
+        if (strcmp(entries[i].key, keep_key) == 0) continue;
+
+        char path[CACHE_PATH_LENGTH];
+        snprintf(path, sizeof(path), "%s/%s", cache_dir, entries[i].key);
+        total -= remove_entry_dir(path);
+        stats.evictions++;
+    }
+
+    free(entries);
+}
+
+// Store <output_prefix>.<suffix> files under a key, then evict down to the size bound
+int cache_store(const char* key, const char* output_prefix, const char* const* suffixes, int status) {
+    char staging[CACHE_ENTRY_LENGTH];
+    char entry[CACHE_ENTRY_LENGTH];
+    char path[CACHE_PATH_LENGTH];
+    char input[CACHE_PATH_LENGTH];
+
+    if (!cache_open) {
+        return 0;
+    }
+
+    // Build the entry in a private directory, then publish it with a rename
+    snprintf(staging, sizeof(staging), "%s/tmp.%ld.%s", cache_dir, (long)getpid(), key);
+    snprintf(entry, sizeof(entry), "%s/%s", cache_dir, key);
+    remove_entry_dir(staging);
+    if (mkdir(staging, 0755) != 0) {
+        report_error(ERROR_LEVEL_WARNING, 0, 0, "Cannot create cache entry in '%s'", cache_dir);
+        return 0;
+    }
+
+    for (int i = 0; suffixes[i]; i++) {
+        snprintf(input, sizeof(input), "%s.%s", output_prefix, suffixes[i]);
+        snprintf(path, sizeof(path), "%s/%s", staging, suffixes[i]);
+        if (copy_file(input, path) < 0) {
+            report_error(ERROR_LEVEL_WARNING, 0, 0, "Cannot cache output file '%s'", input);
+            remove_entry_dir(staging);
+            return 0;
+        }
+    }
+
+    snprintf(path, sizeof(path), "%s/meta", staging);
+    FILE* meta = fopen(path, "w");
+    if (!meta) {
+        remove_entry_dir(staging);
+        return 0;
+    }
+    fprintf(meta, "status %d\nversion %s\nbuild %016llx\n", status, PHYLOG_VERSION, build_id);
+    fclose(meta);
+
+    remove_entry_dir(entry);
+    if (rename(staging, entry) != 0) {
+        remove_entry_dir(staging);
+        return 0;
+    }
+
+    stats.stores++;
+    evict_entries(key);
+    return 1;
+}
+
+// Get the cache statistics
+CacheStats cache_get_stats(void) {
+    return stats;
+}
+
+// Display cache statistics
+void cache_display_stats(void) {
+    long lookups = stats.hits + stats.misses;
+    printf("Cache statistics (%s): %ld hits, %ld misses", cache_dir, stats.hits, stats.misses);
+    if (lookups > 0) {
+        printf(" (%.1f%% hit rate)", 100.0 * stats.hits / lookups);
+    }
+    printf(", %ld stores, %ld evictions\n", stats.stores, stats.evictions);
+}
+
+// Save statistics and release the cache
+void cache_cleanup(void) {
+    if (!cache_open) {
+        return;
+    }
+    save_stats();
+    cache_open = 0;
+}
@@ -5,13 +5,14 @@
  #include <stdio.h>
  #include <stdlib.h>
  #include <string.h>
+ #include <stdarg.h>
  #include "../include/codegen.h"
  #include "../include/common.h"
  #include "../include/symboltable.h"
  #include "../include/quadgen.h"
- 
- // Maximum line length for reading quadruples
- #define MAX_LINE_LENGTH 256
+ #include "../include/irbin.h"
+ #include "../include/costmodel.h"
+ #include "../include/strpool.h"
  
  // Output file handle
  static FILE* output_file = NULL;
@@ -19,20 +20,304 @@
  // Counter for generating unique labels
  static int label_counter = 0;
  
- // Message tracking for display strings
- #define MAX_MESSAGES 100
- static struct {
-     char* label;
-     char* text;
- } message_strings[MAX_MESSAGES];
- static int message_count = 0;
- static int message_counter = 0;
+ // Set when a range check needs the array range error routine
+ static int range_check_used = 0;
+ 
+ // Input quadruples: a mapped binary IR file, or the quadruplet generator for CSV input
+ static IrBinFile* input_ir = NULL;
+ 
+ // Display strings (msgN is message number N) and which of them are displayed
+ static StrPool* messages = NULL;
+ static char* message_used = NULL;
+ static int message_used_capacity = 0;
+ 
+ // Set when a CHAR is read (the input hook stores a word)
+ static int char_input_used = 0;
+ 
+ // Soft-float runtime instead of 8087 instructions (-msoft-float)
+ static int soft_float = 0;
+ 
+ // Float support used by the program: the 8087, its control words, the software routines
+ static int fpu_used = 0;
+ static int fpu_control_used = 0;
+ static int fpu_status_used = 0;
+ static int fpu_scratch_used = 0;
+ static int soft_float_used = 0;
+ 
+ // Float literals given storage as 8087 operands (fltN is literal N)
+ static StrPool* float_constants = NULL;
+ 
+ // Temporaries of the symbol table and the data slot each one is stored in:
+ // temporaries that are never live at the same time share a slot
+ typedef struct {
+     SymbolNode* symbol;
+     int number;        // n in the name Tn
+     int slot;          // temporary owning the storage (itself for a slot owner)
+ } TempSlot;
+ static TempSlot* temp_slots = NULL;
+ static int temp_slot_count = 0;
+ static int* temp_by_number = NULL;     // Tn -> index in temp_slots, or -1
+ static int temp_number_limit = 0;
+ 
+ // Constants whose address is taken (the only ones given storage)
+ #define MAX_ADDRESSED_CONSTANTS 32
+ static char addressed_constants[MAX_ADDRESSED_CONSTANTS][32];
+ static int addressed_constant_count = 0;
+
+ // Generated assembly stream (written to the .asm file at the end)
+ static AsmLine* asm_lines = NULL;
+ static int asm_line_count = 0;
+ static int asm_line_capacity = 0;
+
+ // Scratch buffer used by codegen_lower_quad instead of the stream
+ static AsmLine* scratch_lines = NULL;
+ static int scratch_count = 0;
+ static int scratch_capacity = 0;
+
+ // Quadruple currently being lowered (-1 outside quadruples)
+ static int current_quad_id = -1;
+
+ // Append a new line to the stream (or to the scratch buffer)
+ static AsmLine* new_asm_line(AsmLineKind kind) {
+     static AsmLine discard;
+     AsmLine* line;
+
+     if (scratch_lines) {
+         if (scratch_count >= scratch_capacity) {
+             return &discard;  // Scratch buffer full, drop the line
+         }
+         line = &scratch_lines[scratch_count++];
+     } else {
+         if (asm_line_count >= asm_line_capacity) {
+             asm_line_capacity = asm_line_capacity ? asm_line_capacity * 2 : 1024;
+             asm_lines = (AsmLine*)safe_realloc(asm_lines, asm_line_capacity * sizeof(AsmLine));
+         }
+         line = &asm_lines[asm_line_count++];
+     }
+
+     memset(line, 0, sizeof(AsmLine));
+     line->kind = kind;
+     line->quad_id = current_quad_id;
+     return line;
+ }
+
+ // Copy a string into a fixed-size field, trimming surrounding blanks
+ static void copy_trimmed(char* dest, size_t size, const char* start, const char* end) {
+     while (start < end && (*start == ' ' || *start == '\t')) start++;
+     while (end > start && (end[-1] == ' ' || end[-1] == '\t')) end--;
+
+     size_t len = end - start;
+     if (len >= size) len = size - 1;
+     memcpy(dest, start, len);
+     dest[len] = '\0';
+ }
+
+ // Emit an instruction given as "mnemonic operands ; comment"
+ static void emit_instr(const char* format, ...) {
+     char text[256];
+     va_list args;
+     va_start(args, format);
+     vsnprintf(text, sizeof(text), format, args);
+     va_end(args);
+
+     AsmLine* line = new_asm_line(ASM_LINE_INSTR);
+
+     // Split off the comment (a ';' outside of quotes)
+     char* comment = NULL;
+     int in_quote = 0;
+     for (char* p = text; *p; p++) {
+         if (*p == '\'') in_quote = !in_quote;
+         if (*p == ';' && !in_quote) {
+             comment = p;
+             break;
+         }
+     }
+     char* code_end = comment ? comment : text + strlen(text);
+     if (comment) {
+         copy_trimmed(line->comment, sizeof(line->comment), comment + 1, comment + strlen(comment));
+     }
+
+     // Split mnemonic and operands
+     char* p = text;
+     while (*p == ' ') p++;
+     char* mnem_end = p;
+     while (mnem_end < code_end && *mnem_end != ' ') mnem_end++;
+     copy_trimmed(line->mnemonic, sizeof(line->mnemonic), p, mnem_end);
+     copy_trimmed(line->operands, sizeof(line->operands), mnem_end, code_end);
+ }
+
+ // Emit a comment line
+ static void emit_comment(const char* format, ...) {
+     AsmLine* line = new_asm_line(ASM_LINE_COMMENT);
+     va_list args;
+     va_start(args, format);
+     vsnprintf(line->comment, sizeof(line->comment), format, args);
+     va_end(args);
+ }
+
+ // Emit a label definition
+ static void emit_label(const char* name) {
+     AsmLine* line = new_asm_line(ASM_LINE_LABEL);
+     snprintf(line->mnemonic, sizeof(line->mnemonic), "%s", name);
+ }
+
+ // Emit a data definition ("name definition")
+ static void emit_data(const char* name, const char* format, ...) {
+     AsmLine* line = new_asm_line(ASM_LINE_DATA);
+     snprintf(line->mnemonic, sizeof(line->mnemonic), "%s", name);
+     va_list args;
+     va_start(args, format);
+     vsnprintf(line->operands, sizeof(line->operands), format, args);
+     va_end(args);
+ }
+
+ // Emit a section switch
+ static void emit_section(const char* name) {
+     AsmLine* line = new_asm_line(ASM_LINE_SECTION);
+     snprintf(line->mnemonic, sizeof(line->mnemonic), "%s", name);
+ }
+
+ // Emit a raw assembler directive
+ static void emit_directive(const char* text) {
+     AsmLine* line = new_asm_line(ASM_LINE_DIRECTIVE);
+     snprintf(line->operands, sizeof(line->operands), "%s", text);
+ }
+
+ // Emit an empty line
+ static void emit_blank(void) {
+     new_asm_line(ASM_LINE_BLANK);
+ }
+
+ // Write the generated stream as NASM text
+ static void write_asm_stream(FILE* file) {
+     for (int i = 0; i < asm_line_count; i++) {
+         AsmLine* line = &asm_lines[i];
+         char code[256];
+
+         switch (line->kind) {
+             case ASM_LINE_DIRECTIVE:
+                 fprintf(file, "%s\n", line->operands);
+                 break;
+             case ASM_LINE_SECTION:
+                 fprintf(file, "section %s\n", line->mnemonic);
+                 break;
+             case ASM_LINE_LABEL:
+                 fprintf(file, "%s:\n", line->mnemonic);
+                 break;
+             case ASM_LINE_INSTR:
+                 if (line->operands[0] != '\0') {
+                     snprintf(code, sizeof(code), "    %s %s", line->mnemonic, line->operands);
+                 } else {
+                     snprintf(code, sizeof(code), "    %s", line->mnemonic);
+                 }
+                 if (line->comment[0] != '\0') {
+                     fprintf(file, "%-17s ; %s\n", code, line->comment);
+                 } else {
+                     fprintf(file, "%s\n", code);
+                 }
+                 break;
+             case ASM_LINE_DATA:
+                 fprintf(file, "    %s %s\n", line->mnemonic, line->operands);
+                 break;
+             case ASM_LINE_COMMENT:
+                 fprintf(file, "    ; %s\n", line->comment);
+                 break;
+             case ASM_LINE_BLANK:
+                 fprintf(file, "\n");
+                 break;
+         }
+     }
+ }
+
+ // Check if an operand is an immediate (number or character literal)
+ static int is_immediate(const char* value) {
+     return (value[0] >= '0' && value[0] <= '9') || value[0] == '-' || value[0] == '\'';
+ }
+ 
+ // Operand text with an integer, character or float constant replaced by its value
+ // (constants have no storage unless their address is taken)
+ static const char* resolve_constant(const char* value) {
+     static char buffers[4][32];
+     static int next = 0;
+     if (is_immediate(value) || strchr(value, '[')) {
+         return value;
+     }
+     SymbolNode* symbol = symboltable_lookup(value);
+     if (!symbol || symbol->category != CATEGORY_CONSTANT || !symbol->is_initialized) {
+         return value;
+     }
+     char* buffer = buffers[next];
+     next = (next + 1) % 4;
+     if (symbol->type == TYPE_INTEGER) {
+         snprintf(buffer, sizeof(buffers[0]), "%d", symbol->value.int_value);
+     } else if (symbol->type == TYPE_CHAR) {
+         snprintf(buffer, sizeof(buffers[0]), "'%c'", symbol->value.char_value);
+     } else if (symbol->type == TYPE_FLOAT) {
+         format_float(buffer, sizeof(buffers[0]), symbol->value.float_value);
+     } else {
+         return value;
+     }
+     return buffer;
+ }
+ 
+ // Check if an operand is stored as a CHAR byte (variable, constant or array element)
+ static int is_char_value(const char* value) {
+     char name[64] = {0};
+     if (value[0] == '\0' || is_immediate(value)) {
+         return 0;
+     }
+     sscanf(value, "%63[^[]", name);
+     SymbolNode* symbol = symboltable_lookup(name);
+     return symbol && symbol->type == TYPE_CHAR;
+ }
+ 
+ // Load an array index into BX
+ static void load_index_to_bx(const char* index) {
+     index = resolve_constant(index);
+     if (is_immediate(index)) {
+         emit_instr("mov bx, %s", index);
+     } else {
+         emit_instr("mov bx, [%s]", index);
+     }
+ }
+ 
+ // Load a CHAR value or a literal into AL
+ static void load_byte_to_al(const char* value) {
+     value = resolve_constant(value);
+     if (is_immediate(value)) {
+         emit_instr("mov al, %s", value);
+     } else if (strchr(value, '[')) {
+         char array_name[64] = {0};
+         char index_text[64] = {0};
+         sscanf(value, "%[^[][%[^]]", array_name, index_text);
+         
+         // Byte elements: the index is the offset
+         emit_comment("Array access %s[%s]", array_name, index_text);
+         const char* index = resolve_constant(index_text);
+         if (is_immediate(index)) {
+             emit_instr("mov al, [%s + %d]", array_name, atoi(index));
+             return;
+         }
+         load_index_to_bx(index);
+         emit_instr("add bx, %s    ; Add array base address", array_name);
+         emit_instr("mov al, [bx]  ; Load character from array");
+     } else {
+         emit_instr("mov al, [%s]", value);
+     }
+ }
  
  // Helper function to load a value into AX
  static void load_value_to_ax(const char* value) {
-     // Check if value is a number
-     if ((value[0] >= '0' && value[0] <= '9') || value[0] == '-') {
-         fprintf(output_file, "    mov ax, %s\n", value);
+     value = resolve_constant(value);
+     
+     // Characters are bytes, zero-extended to a word
+     if (is_char_value(value)) {
+         load_byte_to_al(value);
+         emit_instr("mov ah, 0");
+     }
+     // Check if value is an immediate
+     else if (is_immediate(value)) {
+         emit_instr("mov ax, %s", value);
      }
      // Check if it's an array access
      else if (strchr(value, '[') && strchr(value, ']')) {
@@ -43,43 +328,1171 @@
          sscanf(value, "%[^[][%[^]]", array_name, index);
          
          // Load index to bx
-         fprintf(output_file, "    ; Array access %s[%s]\n", array_name, index);
-         fprintf(output_file, "    mov bx, [%s]\n", index);
-         fprintf(output_file, "    shl bx, 1     ; Multiply by 2 for word size\n");
-         fprintf(output_file, "    add bx, %s    ; Add array base address\n", array_name);
-         fprintf(output_file, "    mov ax, [bx]  ; Load value from array\n");
+         emit_comment("Array access %s[%s]", array_name, index);
+         load_index_to_bx(index);
+         emit_instr("shl bx, 1     ; Multiply by 2 for word size");
+         emit_instr("add bx, %s    ; Add array base address", array_name);
+         emit_instr("mov ax, [bx]  ; Load value from array");
      }
      // Regular variable
      else {
-         fprintf(output_file, "    mov ax, [%s]\n", value);
+         emit_instr("mov ax, [%s]", value);
+     }
+ }
+ 
+ // Store AL to a CHAR variable or array element
+ static void store_al_to_result(const char* result) {
+     if (strchr(result, '[')) {
+         char array_name[64] = {0};
+         char index_text[64] = {0};
+         sscanf(result, "%[^[][%[^]]", array_name, index_text);
+         const char* index = resolve_constant(index_text);
+         
+         emit_comment("Store to array %s[%s]", array_name, index);
+         if (is_immediate(index)) {
+             // Constant offset: no address computation
+             emit_instr("mov [%s + %d], al", array_name, atoi(index));
+             return;
+         }
+         emit_instr("mov bx, [%s]  ; Load index", index);
+         emit_instr("add bx, %s    ; Add array base address", array_name);
+         emit_instr("mov [bx], al  ; Store character at calculated address");
+     } else {
+         emit_instr("mov [%s], al", result);
      }
  }
  
  // Helper function to store AX to a variable or array element
  static void store_ax_to_result(const char* result) {
+     // Characters keep the low byte
+     if (is_char_value(result)) {
+         store_al_to_result(result);
+     }
      // Check if it's an array access
-     if (strchr(result, '[') && strchr(result, ']')) {
+     else if (strchr(result, '[') && strchr(result, ']')) {
          char array_name[64] = {0};
-         char index[64] = {0};
+         char index_text[64] = {0};
          
          // Parse array[index]
-         sscanf(result, "%[^[][%[^]]", array_name, index);
+         sscanf(result, "%[^[][%[^]]", array_name, index_text);
+         
+         const char* index = resolve_constant(index_text);
          
          // Calculate effective address and store
-         fprintf(output_file, "    ; Store to array %s[%s]\n", array_name, index);
-         fprintf(output_file, "    push ax       ; Save value temporarily\n");
-         fprintf(output_file, "    mov bx, [%s]  ; Load index\n", index);
-         fprintf(output_file, "    shl bx, 1     ; Multiply by 2 for word size\n");
-         fprintf(output_file, "    add bx, %s    ; Add array base address\n", array_name);
-         fprintf(output_file, "    pop ax        ; Restore value\n");
-         fprintf(output_file, "    mov [bx], ax  ; Store at calculated address\n");
+         emit_comment("Store to array %s[%s]", array_name, index);
+         emit_instr("push ax       ; Save value temporarily");
+         if (is_immediate(index)) {
+             emit_instr("mov bx, %s  ; Load index", index);
+         } else {
+             emit_instr("mov bx, [%s]  ; Load index", index);
+         }
+         emit_instr("shl bx, 1     ; Multiply by 2 for word size");
+         emit_instr("add bx, %s    ; Add array base address", array_name);
+         emit_instr("pop ax        ; Restore value");
+         emit_instr("mov [bx], ax  ; Store at calculated address");
      }
      // Regular variable
      else {
-         fprintf(output_file, "    mov [%s], ax\n", result);
+         emit_instr("mov [%s], ax", result);
+     }
+ }
+ 
+ // Check if an operand can take part in a byte compare (a CHAR or a literal below 256)
+ static int is_byte_operand(const char* value) {
+     value = resolve_constant(value);
+     if (is_char_value(value) || value[0] == '\'') {
+         return 1;
+     }
+     int literal;
+     return is_immediate(value) && !strchr(value, '.') && (literal = atoi(value)) >= 0 && literal <= 255;
+ }
+ 
+ // Compare two values (AX or AL holds the first one afterwards); characters are
+ // compared as bytes, which needs the unsigned jumps (returns 1 then)
+ static int emit_compare(const char* left, const char* right) {
+     if ((is_char_value(left) || is_char_value(right)) && is_byte_operand(left) && is_byte_operand(right)) {
+         right = resolve_constant(right);
+         if (strchr(right, '[')) {
+             load_byte_to_al(right);
+             emit_instr("mov ah, al    ; Second character");
+             load_byte_to_al(left);
+             emit_instr("cmp al, ah");
+         } else {
+             load_byte_to_al(left);
+             emit_instr(is_immediate(right) ? "cmp al, %s" : "cmp al, [%s]", right);
+         }
+         return 1;
+     }
+     load_value_to_ax(left);
+     right = resolve_constant(right);
+     if (is_immediate(right)) {
+         emit_instr("cmp ax, %s", right);
+     } else {
+         emit_instr("cmp ax, [%s]", right);
+     }
+     return 0;
+ }
+ 
+ // Load a count or index operand into a register
+ static void load_operand_to(const char* reg, const char* value) {
+     value = resolve_constant(value);
+     if (is_immediate(value)) {
+         emit_instr("mov %s, %s", reg, value);
+     } else {
+         emit_instr("mov %s, [%s]", reg, value);
+     }
+ }
+ 
+ // Point a string register at element [first] of an array after checking that
+ // the CX (= count) elements starting there lie inside it
+ static void emit_block_address(const char* element, const char* count, const char* reg) {
+     char array_name[64] = {0};
+     char index_text[64] = {0};
+     sscanf(element, "%[^[][%[^]]", array_name, index_text);
+     const char* index = resolve_constant(index_text);
+     count = resolve_constant(count);
+     
+     SymbolNode* array = symboltable_lookup(array_name);
+     int size = array ? array->array_size : 0;
+     
+     // Both ends known: the check is done here
+     if (is_immediate(index) && is_immediate(count)) {
+         int first = atoi(index);
+         if (first < 0 || first + atoi(count) > size) {
+             emit_instr("jmp array_range_error");
+             range_check_used = 1;
+         }
+         emit_instr("lea %s, [%s + %d]", reg, array_name, first * 2);
+         return;
+     }
+     
+     load_index_to_bx(index);
+     emit_instr("cmp bx, 0");
+     emit_instr("jl array_range_error");
+     emit_instr("mov dx, bx");
+     emit_instr("add dx, cx");
+     emit_instr("cmp dx, %d   ; Elements in %s", size, array_name);
+     emit_instr("jg array_range_error");
+     emit_instr("shl bx, 1     ; Multiply by 2 for word size");
+     emit_instr("lea %s, [%s + bx]", reg, array_name);
+     range_check_used = 1;
+ }
+ 
+ // Integer value of a literal or an integer constant (returns 0 if not known)
+ static int constant_int_value(const char* value, int* result) {
+     if (is_immediate(value)) {
+         if (value[0] == '\'' || strchr(value, '.')) {
+             return 0;
+         }
+         *result = atoi(value);
+         return 1;
+     }
+     SymbolNode* symbol = symboltable_lookup(value);
+     if (symbol && symbol->category == CATEGORY_CONSTANT && symbol->type == TYPE_INTEGER &&
+         symbol->is_initialized) {
+         *result = symbol->value.int_value;
+         return 1;
+     }
+     return 0;
+ }
+ 
+ // Candidate instruction sequence for arithmetic by a constant
+ #define MAX_SEQUENCE_INSTRS 64
+ typedef struct {
+     char text[MAX_SEQUENCE_INSTRS][48];
+     int repeat[MAX_SEQUENCE_INSTRS];   // Shift count of a shift by CL
+     int count;
+ } InstrSequence;
+ 
+ // Append an instruction to a sequence
+ static void sequence_add(InstrSequence* seq, int repeat, const char* format, ...) {
+     if (seq->count >= MAX_SEQUENCE_INSTRS) {
+         seq->count++;  // Overflowed: priced as unusable
+         return;
+     }
+     va_list args;
+     va_start(args, format);
+     vsnprintf(seq->text[seq->count], sizeof(seq->text[0]), format, args);
+     va_end(args);
+     seq->repeat[seq->count++] = repeat;
+ }
+ 
+ // Append one sequence to another
+ static void sequence_append(InstrSequence* seq, const InstrSequence* tail) {
+     for (int i = 0; i < tail->count && i < MAX_SEQUENCE_INSTRS; i++) {
+         sequence_add(seq, tail->repeat[i], "%s", tail->text[i]);
+     }
+ }
+ 
+ // Estimated cost of a sequence
+ static CostEstimate sequence_cost(const InstrSequence* seq) {
+     CostEstimate total = { 0, 0, 0 };
+     if (seq->count > MAX_SEQUENCE_INSTRS) {
+         total.cycles = total.bytes = 1 << 20;
+         return total;
+     }
+     for (int i = 0; i < seq->count; i++) {
+         char mnemonic[16] = {0};
+         const char* operands = seq->text[i];
+         while (*operands && *operands != ' ') operands++;
+         snprintf(mnemonic, sizeof(mnemonic), "%.*s", (int)(operands - seq->text[i]), seq->text[i]);
+         while (*operands == ' ') operands++;
+         
+         CostEstimate c = costmodel_instr_cost_repeat(mnemonic, operands, seq->repeat[i]);
+         total.cycles += c.cycles;
+         total.bytes += c.bytes;
+         total.instructions++;
+     }
+     return total;
+ }
+ 
+ // Check if a sequence is cheaper than another (cycles first, then size)
+ static int sequence_cheaper(const InstrSequence* a, const InstrSequence* b) {
+     CostEstimate ca = sequence_cost(a);
+     CostEstimate cb = sequence_cost(b);
+     return ca.cycles < cb.cycles || (ca.cycles == cb.cycles && ca.bytes < cb.bytes);
+ }
+ 
+ // Emit a sequence into the stream
+ static void emit_sequence(const InstrSequence* seq) {
+     for (int i = 0; i < seq->count; i++) {
+         emit_instr("%s", seq->text[i]);
+     }
+ }
+ 
+ // Shift a register by a constant count (repeated by-1 shifts or a shift by CL)
+ static void sequence_shift(InstrSequence* seq, const char* mnemonic, const char* reg, int count) {
+     if (count <= 0) {
+         return;
+     }
+     InstrSequence by_one = { .count = 0 };
+     InstrSequence by_cl = { .count = 0 };
+     for (int i = 0; i < count; i++) {
+         sequence_add(&by_one, 0, "%s %s, 1", mnemonic, reg);
+     }
+     sequence_add(&by_cl, 0, "mov cl, %d", count);
+     sequence_add(&by_cl, count, "%s %s, cl", mnemonic, reg);
+     sequence_append(seq, sequence_cheaper(&by_cl, &by_one) ? &by_cl : &by_one);
+ }
+ 
+ // AX *= multiplier (16-bit pattern) with shifts and adds, Horner style from the top
+ // digit. With signed digits (non-adjacent form) runs of ones become a subtraction.
+ static void sequence_multiply(InstrSequence* seq, unsigned int multiplier, int signed_digits) {
+     int digits[17] = {0};
+     int top = -1;
+     
+     multiplier &= 0xFFFF;
+     for (int i = 0; i < 17 && multiplier != 0; i++) {
+         if (multiplier & 1) {
+             digits[i] = signed_digits ? 2 - (int)(multiplier & 3) : 1;
+             multiplier = (multiplier - digits[i]) & 0x1FFFF;
+         }
+         multiplier >>= 1;
+         if (digits[i] != 0) top = i;
+     }
+     if (top < 0) {
+         sequence_add(seq, 0, "mov ax, 0");
+         return;
+     }
+     
+     // DX keeps the multiplicand once a digit below the top one needs it
+     int pending = 0;
+     for (int i = top - 1; i >= 0; i--) {
+         if (digits[i] != 0) {
+             sequence_add(seq, 0, "mov dx, ax");
+             break;
+         }
+     }
+     for (int i = top - 1; i >= 0; i--) {
+         pending++;
+         if (digits[i] != 0) {
+             sequence_shift(seq, "shl", "ax", pending);
+             sequence_add(seq, 0, digits[i] > 0 ? "add ax, dx" : "sub ax, dx");
+             pending = 0;
+         }
+     }
+     sequence_shift(seq, "shl", "ax", pending);
+ }
+ 
+ // Cheapest sequence for AX *= constant; falls back to imul
+ static void sequence_best_multiply(InstrSequence* best, int constant, const char* constant_text) {
+     InstrSequence candidates[4];
+     int count = 0;
+     
+     // imul by the constant
+     memset(&candidates[count], 0, sizeof(InstrSequence));
+     sequence_add(&candidates[count], 0, "mov cx, ax");
+     if (is_immediate(constant_text)) {
+         sequence_add(&candidates[count], 0, "mov ax, %s", constant_text);
+     } else {
+         sequence_add(&candidates[count], 0, "mov ax, [%s]", constant_text);
+     }
+     sequence_add(&candidates[count], 0, "imul cx");
+     count++;
+     
+     // Shift/add with binary and signed digits, of the constant or of its magnitude then negated
+     for (int signed_digits = 0; signed_digits <= 1; signed_digits++) {
+         memset(&candidates[count], 0, sizeof(InstrSequence));
+         sequence_multiply(&candidates[count], (unsigned int)constant, signed_digits);
+         count++;
+     }
+     if (constant < 0) {
+         memset(&candidates[count], 0, sizeof(InstrSequence));
+         sequence_multiply(&candidates[count], (unsigned int)(-constant), 1);
+         sequence_add(&candidates[count], 0, "neg ax");
+         count++;
+     }
+     
+     *best = candidates[0];
+     for (int i = 1; i < count; i++) {
+         if (sequence_cheaper(&candidates[i], best)) {
+             *best = candidates[i];
+         }
+     }
+ }
+ 
+ // Multiplier and shift for signed 16-bit division by a constant (|divisor| >= 2,
+ // not a power of two), after Hacker's Delight, section 10-4
+ static void signed_division_magic(int divisor, int* multiplier, int* shift) {
+     const unsigned int two15 = 0x8000;
+     unsigned int ad = (unsigned int)abs(divisor);
+     unsigned int t = two15 + (divisor < 0 ? 1 : 0);
+     unsigned int anc = t - 1 - t % ad;
+     unsigned int q1 = two15 / anc, r1 = two15 - q1 * anc;
+     unsigned int q2 = two15 / ad, r2 = two15 - q2 * ad;
+     unsigned int delta;
+     int p = 15;
+     
+     do {
+         p++;
+         q1 = (2 * q1) & 0xFFFF;
+         r1 = (2 * r1) & 0xFFFF;
+         if (r1 >= anc) {
+             q1 = (q1 + 1) & 0xFFFF;
+             r1 = (r1 - anc) & 0xFFFF;
+         }
+         q2 = (2 * q2) & 0xFFFF;
+         r2 = (2 * r2) & 0xFFFF;
+         if (r2 >= ad) {
+             q2 = (q2 + 1) & 0xFFFF;
+             r2 = (r2 - ad) & 0xFFFF;
+         }
+         delta = ad - r2;
+     } while (q1 < delta || (q1 == delta && r1 == 0));
+     
+     int m = (int)((q2 + 1) & 0xFFFF);
+     if (m >= 0x8000) m -= 0x10000;
+     *multiplier = divisor < 0 ? -m : m;
+     *shift = p - 16;
+ }
+ 
+ // AX = AX / divisor without idiv (a reciprocal multiply also leaves the
+ // dividend in BX); returns 0 when the divisor has no such sequence
+ static int sequence_divide(InstrSequence* seq, int divisor) {
+     int magnitude = abs(divisor);
+     if (magnitude == 0 || magnitude > 0x7FFF) {
+         return 0;
+     }
+     if (magnitude == 1) {
+         if (divisor < 0) {
+             sequence_add(seq, 0, "neg ax");
+         }
+         return 1;
+     }
+     
+     if ((magnitude & (magnitude - 1)) == 0) {
+         // Round toward zero: add 2^k - 1 to negative dividends, then shift
+         int k = 0;
+         while ((1 << k) < magnitude) k++;
+         sequence_add(seq, 0, "cwd");
+         if (k == 1) {
+             sequence_add(seq, 0, "sub ax, dx");
+         } else {
+             sequence_add(seq, 0, "and dx, %d", magnitude - 1);
+             sequence_add(seq, 0, "add ax, dx");
+         }
+         sequence_shift(seq, "sar", "ax", k);
+         if (divisor < 0) {
+             sequence_add(seq, 0, "neg ax");
+         }
+         return 1;
+     }
+     
+     // Multiply by the reciprocal: the quotient is the high word, corrected
+     int multiplier, shift;
+     signed_division_magic(divisor, &multiplier, &shift);
+     sequence_add(seq, 0, "mov bx, ax");
+     sequence_add(seq, 0, "mov ax, %d", multiplier);
+     sequence_add(seq, 0, "imul bx");
+     if (divisor > 0 && multiplier < 0) {
+         sequence_add(seq, 0, "add dx, bx");
+     } else if (divisor < 0 && multiplier > 0) {
+         sequence_add(seq, 0, "sub dx, bx");
+     }
+     sequence_shift(seq, "sar", "dx", shift);
+     sequence_add(seq, 0, "mov ax, dx");
+     sequence_add(seq, 0, "cwd");
+     sequence_add(seq, 0, "sub ax, dx");
+     return 1;
+ }
+ 
+ // AX = AX % divisor without idiv; returns 0 when there is no such sequence
+ static int sequence_remainder(InstrSequence* seq, int divisor) {
+     int magnitude = abs(divisor);
+     if (magnitude > 0x7FFF) {
+         return 0;
+     }
+     if (magnitude == 0) {
+         return 0;
+     }
+     if (magnitude == 1) {
+         sequence_add(seq, 0, "mov ax, 0");
+         return 1;
+     }
+     if ((magnitude & (magnitude - 1)) == 0) {
+         // Mask off the quotient bits of the rounded dividend: x - (x + fix) & -2^k
+         sequence_add(seq, 0, "mov bx, ax");
+         sequence_add(seq, 0, "cwd");
+         sequence_add(seq, 0, "and dx, %d", magnitude - 1);
+         sequence_add(seq, 0, "add ax, dx");
+         sequence_add(seq, 0, "and ax, %d", -magnitude);
+         sequence_add(seq, 0, "sub bx, ax");
+         sequence_add(seq, 0, "mov ax, bx");
+         return 1;
+     }
+     
+     // x - (x / divisor) * divisor
+     InstrSequence product;
+     char divisor_text[16];
+     if (!sequence_divide(seq, divisor)) {
+         return 0;
+     }
+     snprintf(divisor_text, sizeof(divisor_text), "%d", divisor);
+     sequence_best_multiply(&product, divisor, divisor_text);
+     sequence_append(seq, &product);
+     sequence_add(seq, 0, "sub bx, ax");
+     sequence_add(seq, 0, "mov ax, bx");
+     return 1;
+ }
+ 
+ // Lower "result := arg1 op arg2" for *, / and %, replacing imul/idiv by
+ // shifts, adds, masks or a reciprocal multiply when the cost model prefers them
+ static void emit_multiplicative(const char* op, const char* arg1, const char* arg2, const char* result) {
+     int constant;
+     arg1 = resolve_constant(arg1);
+     arg2 = resolve_constant(arg2);
+     const char* operand = arg1;
+     const char* constant_text = arg2;
+     int known = constant_int_value(arg2, &constant);
+     if (!known && strcmp(op, "*") == 0 && constant_int_value(arg1, &constant)) {
+         operand = arg2;
+         constant_text = arg1;
+         known = 1;
+     }
+     
+     // Reference lowering with imul / idiv
+     InstrSequence generic = { .count = 0 };
+     if (strcmp(op, "*") == 0) {
+         sequence_add(&generic, 0, "mov cx, ax    ; Save first operand");
+     } else {
+         sequence_add(&generic, 0, "mov cx, ax    ; Save dividend");
+     }
+     if (known || is_immediate(constant_text)) {
+         sequence_add(&generic, 0, is_immediate(constant_text) ? "mov ax, %s" : "mov ax, [%s]", constant_text);
+     }
+     if (strcmp(op, "*") == 0) {
+         sequence_add(&generic, 0, "imul cx       ; Multiply (result in DX:AX)");
+     } else {
+         sequence_add(&generic, 0, "mov bx, ax    ; Move divisor to BX");
+         sequence_add(&generic, 0, "mov ax, cx    ; Move dividend to AX");
+         sequence_add(&generic, 0, "cwd           ; Sign extend to DX:AX");
+         sequence_add(&generic, 0, "idiv bx       ; Divide, quotient in AX");
+         if (strcmp(op, "%") == 0) {
+             sequence_add(&generic, 0, "mov ax, dx    ; Remainder in DX");
+         }
+     }
+     
+     InstrSequence reduced = { .count = 0 };
+     int have_reduced = 0;
+     if (known) {
+         if (strcmp(op, "*") == 0) {
+             sequence_best_multiply(&reduced, constant, constant_text);
+             have_reduced = 1;
+         } else if (strcmp(op, "/") == 0) {
+             have_reduced = sequence_divide(&reduced, constant);
+         } else {
+             have_reduced = sequence_remainder(&reduced, constant);
+         }
+     }
+     
+     load_value_to_ax(operand);
+     if (have_reduced && sequence_cheaper(&reduced, &generic)) {
+         emit_comment("Strength-reduced %s by %d", op, constant);
+         emit_sequence(&reduced);
+     } else {
+         if (!known && !is_immediate(constant_text)) {
+             // Second operand from memory or an array element
+             emit_instr("%s", generic.text[0]);
+             load_value_to_ax(constant_text);
+             for (int i = 1; i < generic.count; i++) {
+                 emit_instr("%s", generic.text[i]);
+             }
+         } else {
+             emit_sequence(&generic);
+         }
+     }
+     store_ax_to_result(result);
+ }
+ 
+ // Check if an operand is a FLOAT value (literal, variable, constant or array element)
+ static int is_float_value(const char* value) {
+     char name[64] = {0};
+     if (value[0] == '\0') {
+         return 0;
+     }
+     if (is_immediate(value)) {
+         return value[0] != '\'' && strchr(value, '.') != NULL;
+     }
+     sscanf(value, "%63[^[]", name);
+     SymbolNode* symbol = symboltable_lookup(name);
+     return symbol && symbol->type == TYPE_FLOAT;
+ }
+ 
+ // Numeric value of a literal (a character literal is its code)
+ static double literal_value(const char* value) {
+     return value[0] == '\'' ? (double)(unsigned char)value[1] : atof(value);
+ }
+ 
+ // IEEE single precision bits of a literal
+ static uint32_t float_bits(const char* value) {
+     float f = (float)literal_value(value);
+     uint32_t bits;
+     memcpy(&bits, &f, sizeof(bits));
+     return bits;
+ }
+ 
+ // Word as NASM hex ("0C0A0h", "4120h")
+ static const char* hex_word(unsigned int value) {
+     static char buffers[2][8];
+     static int next = 0;
+     char* buffer = buffers[next];
+     next = (next + 1) % 2;
+     snprintf(buffer, sizeof(buffers[0]), (value & 0xFFFF) >= 0xA000 ? "0%04Xh" : "%04Xh", value & 0xFFFF);
+     return buffer;
+ }
+ 
+ // Address of an array element into BX
+ static void load_element_address_to_bx(const char* element, int element_size) {
+     char array_name[64] = {0};
+     char index[64] = {0};
+     sscanf(element, "%[^[][%[^]]", array_name, index);
+     
+     emit_comment("Array access %s[%s]", array_name, index);
+     load_index_to_bx(index);
+     if (element_size == 4) {
+         emit_instr("shl bx, 1");
+         emit_instr("shl bx, 1     ; Multiply by 4 for doubleword size");
+     } else {
+         emit_instr("shl bx, 1     ; Multiply by 2 for word size");
+     }
+     emit_instr("add bx, %s    ; Add array base address", array_name);
+ }
+ 
+ // Number of a float literal stored for the 8087
+ static int use_float_constant(const char* literal) {
+     if (!float_constants) {
+         float_constants = strpool_create();
+     }
+     if (scratch_lines) {
+         // Cost estimate only: the pool does not change
+         int id = strpool_find(float_constants, literal);
+         return id >= 0 ? id : strpool_count(float_constants);
+     }
+     return strpool_intern(float_constants, literal);
+ }
+ 
+ // Memory operand of a value for an 8087 instruction (array elements leave their
+ // address in BX); returns 1 for a float doubleword, 0 for an integer word
+ static int x87_operand(const char* value, char* operand, size_t size) {
+     value = resolve_constant(value);
+     if (!scratch_lines) {
+         fpu_used = 1;
+     }
+     if (is_immediate(value)) {
+         char literal[48];
+         format_float(literal, sizeof(literal), (float)literal_value(value));
+         snprintf(operand, size, "dword [flt%d]", use_float_constant(literal));
+         return 1;
+     }
+     int is_float = is_float_value(value);
+     if (strchr(value, '[')) {
+         load_element_address_to_bx(value, is_float ? 4 : 2);
+         snprintf(operand, size, "%s [bx]", is_float ? "dword" : "word");
+     } else {
+         snprintf(operand, size, "%s [%s]", is_float ? "dword" : "word", value);
+     }
+     return is_float;
+ }
+ 
+ // Push a value on the 8087 stack (integers are converted by fild)
+ static void x87_load(const char* value) {
+     char operand[96];
+     int is_float = x87_operand(value, operand, sizeof(operand));
+     emit_instr("%s %s", is_float ? "fld" : "fild", operand);
+ }
+ 
+ // ST0 = ST0 op value; the mnemonic is the float form ("fadd", "fcomp", ...)
+ static void x87_apply(const char* mnemonic, const char* value) {
+     char operand[96];
+     int is_float = x87_operand(value, operand, sizeof(operand));
+     emit_instr("%s%s %s", is_float ? "f" : "fi", mnemonic + 1, operand);
+ }
+ 
+ // Pop ST0 into a result; an integer target is truncated toward zero
+ static void x87_store(const char* result) {
+     char operand[96];
+     int is_float = is_float_value(result);
+     if (!is_float) {
+         emit_instr("fnstcw [fpu_control]  ; Round toward zero for the conversion");
+         emit_instr("fwait");
+         emit_instr("mov ax, [fpu_control]");
+         emit_instr("or ax, 0C00h");
+         emit_instr("mov [fpu_truncate], ax");
+         emit_instr("fldcw [fpu_truncate]");
+         if (!scratch_lines) {
+             fpu_control_used = 1;
+         }
+     }
+     x87_operand(result, operand, sizeof(operand));
+     emit_instr("%s %s", is_float ? "fstp" : "fistp", operand);
+     if (!is_float) {
+         emit_instr("fldcw [fpu_control]");
+     }
+     emit_instr("fwait         ; Stored before the CPU reads it");
+ }
+ 
+ // Call a routine of the soft-float runtime
+ static void emit_float_call(const char* routine) {
+     emit_instr("call %s", routine);
+     if (!scratch_lines) {
+         soft_float_used = 1;
+     }
+ }
+ 
+ // Load a value as a float into DX:AX (high word in DX)
+ static void load_float_to_dx_ax(const char* value) {
+     value = resolve_constant(value);
+     if (is_immediate(value)) {
+         // Literal: its bits are known now
+         uint32_t bits = float_bits(value);
+         emit_instr("mov ax, %s  ; %s", hex_word(bits & 0xFFFF), value);
+         emit_instr("mov dx, %s", hex_word(bits >> 16));
+     } else if (!is_float_value(value)) {
+         // Integer operand converted on the way
+         if (soft_float) {
+             load_value_to_ax(value);
+             emit_float_call("fp_from_int");
+         } else {
+             x87_load(value);
+             emit_instr("fstp dword [fpu_scratch]");
+             emit_instr("fwait");
+             emit_instr("mov ax, [fpu_scratch]");
+             emit_instr("mov dx, [fpu_scratch + 2]");
+             if (!scratch_lines) {
+                 fpu_scratch_used = 1;
+             }
+         }
+     } else if (strchr(value, '[')) {
+         load_element_address_to_bx(value, 4);
+         emit_instr("mov ax, [bx]");
+         emit_instr("mov dx, [bx + 2]  ; Load float from array");
+     } else {
+         emit_instr("mov ax, [%s]", value);
+         emit_instr("mov dx, [%s + 2]", value);
+     }
+ }
+ 
+ // Store DX:AX to a float variable or element; an integer target is truncated
+ static void store_dx_ax_to_float(const char* result) {
+     if (!is_float_value(result)) {
+         if (soft_float) {
+             emit_float_call("fp_to_int");
+             store_ax_to_result(result);
+         } else {
+             emit_instr("mov [fpu_scratch], ax");
+             emit_instr("mov [fpu_scratch + 2], dx");
+             emit_instr("fld dword [fpu_scratch]");
+             x87_store(result);
+             if (!scratch_lines) {
+                 fpu_scratch_used = 1;
+             }
+         }
+     } else if (strchr(result, '[')) {
+         emit_instr("push ax       ; Save low word");
+         load_element_address_to_bx(result, 4);
+         emit_instr("pop ax        ; Restore low word");
+         emit_instr("mov [bx], ax");
+         emit_instr("mov [bx + 2], dx  ; Store float at calculated address");
+     } else {
+         emit_instr("mov [%s], ax", result);
+         emit_instr("mov [%s + 2], dx", result);
+     }
+ }
+ 
+ // Soft float: first operand in DX:AX, second in CX:BX
+ static void load_float_operands(const char* left, const char* right) {
+     right = resolve_constant(right);
+     load_float_to_dx_ax(left);
+     if (is_immediate(right)) {
+         uint32_t bits = float_bits(right);
+         emit_instr("mov bx, %s  ; %s", hex_word(bits & 0xFFFF), right);
+         emit_instr("mov cx, %s", hex_word(bits >> 16));
+         return;
+     }
+     emit_instr("push dx");
+     emit_instr("push ax       ; Save first operand");
+     load_float_to_dx_ax(right);
+     emit_instr("mov bx, ax");
+     emit_instr("mov cx, dx    ; Second operand in CX:BX");
+     emit_instr("pop ax");
+     emit_instr("pop dx        ; First operand in DX:AX");
+ }
+ 
+ // result := value across the integer and float types
+ static void emit_float_move(const char* value, const char* result) {
+     int from_float = is_float_value(value);
+     int to_float = is_float_value(result);
+     if (!from_float && !to_float) {
+         load_value_to_ax(value);
+         store_ax_to_result(result);
+     } else if (soft_float || (to_float && (from_float || is_immediate(resolve_constant(value))))) {
+         // Bit copy (or a software conversion)
+         load_float_to_dx_ax(value);
+         store_dx_ax_to_float(result);
+     } else {
+         x87_load(value);
+         x87_store(result);
      }
  }
  
+ // Soft-float runtime for targets without an 8087: IEEE single precision with
+ // the first operand and the result in DX:AX (high word in DX) and the second
+ // operand in CX:BX. Denormals are flushed to zero, results round to nearest,
+ // overflow gives infinity. Labels end in ':', comments start with ';'.
+ static const char* const soft_float_words[] = {
+     "fp_sign", "fp_exp", "fp_diff", "fp_count",
+     "fp_a_hi", "fp_a_lo", "fp_b_hi", "fp_b_lo", "fp_p1", "fp_p2"
+ };
+ 
+ static const char* const soft_float_runtime[] = {
+     "; DX:AX = DX:AX - CX:BX",
+     "fp_sub:",
+     "xor cx, 8000h",
+     "; DX:AX = DX:AX + CX:BX",
+     "fp_add:",
+     "mov si, dx",
+     "and si, 7FFFh",
+     "mov di, cx",
+     "and di, 7FFFh",
+     "cmp si, di",
+     "ja fpa_ordered",
+     "jb fpa_swap",
+     "cmp ax, bx",
+     "jae fpa_ordered",
+     "fpa_swap:",
+     "xchg ax, bx",
+     "xchg dx, cx",
+     "fpa_ordered:",
+     "; |A| >= |B|: the sum has the sign of A",
+     "test cx, 7F80h",
+     "jz fpa_b_zero",
+     "mov [fp_sign], dx",
+     "mov si, dx",
+     "xor si, cx",
+     "mov [fp_diff], si",
+     "mov si, dx",
+     "and si, 7F80h",
+     "mov di, cx",
+     "and di, 7F80h",
+     "sub si, di",
+     "cmp si, 0D00h",
+     "jae fpa_return",
+     "push si",
+     "mov si, dx",
+     "push cx",
+     "mov cl, 7",
+     "shr si, cl",
+     "pop cx",
+     "and si, 00FFh",
+     "mov [fp_exp], si",
+     "pop si",
+     "; Mantissas with the hidden bit and 6 guard bits",
+     "and dx, 007Fh",
+     "or dx, 0080h",
+     "and cx, 007Fh",
+     "or cx, 0080h",
+     "mov di, 6",
+     "fpa_guard:",
+     "shl ax, 1",
+     "rcl dx, 1",
+     "shl bx, 1",
+     "rcl cx, 1",
+     "dec di",
+     "jnz fpa_guard",
+     "; Align B, keeping the bits shifted out as a sticky bit",
+     "fpa_align:",
+     "cmp si, 0",
+     "je fpa_aligned",
+     "shr cx, 1",
+     "rcr bx, 1",
+     "jnc fpa_next_bit",
+     "or bx, 1",
+     "fpa_next_bit:",
+     "sub si, 80h",
+     "jmp fpa_align",
+     "fpa_aligned:",
+     "test word [fp_diff], 8000h",
+     "jnz fpa_subtract",
+     "add ax, bx",
+     "adc dx, cx",
+     "jmp fpa_normalize",
+     "fpa_subtract:",
+     "sub ax, bx",
+     "sbb dx, cx",
+     "fpa_normalize:",
+     "mov si, ax",
+     "or si, dx",
+     "jz fpa_zero",
+     "test dx, 4000h",
+     "jz fpa_left",
+     "shr dx, 1",
+     "rcr ax, 1",
+     "jnc fpa_carried",
+     "or ax, 1",
+     "fpa_carried:",
+     "inc word [fp_exp]",
+     "fpa_left:",
+     "test dx, 2000h",
+     "jnz fpa_round",
+     "shl ax, 1",
+     "rcl dx, 1",
+     "dec word [fp_exp]",
+     "jmp fpa_left",
+     "; Round to nearest even on the 6 extra bits",
+     "fpa_round:",
+     "mov si, ax",
+     "and si, 003Fh",
+     "cmp si, 20h",
+     "jb fpa_drop",
+     "ja fpa_up",
+     "test ax, 0040h",
+     "jz fpa_drop",
+     "fpa_up:",
+     "add ax, 40h",
+     "adc dx, 0",
+     "test dx, 4000h",
+     "jz fpa_drop",
+     "shr dx, 1",
+     "rcr ax, 1",
+     "inc word [fp_exp]",
+     "fpa_drop:",
+     "mov di, 6",
+     "fpa_drop_bit:",
+     "shr dx, 1",
+     "rcr ax, 1",
+     "dec di",
+     "jnz fpa_drop_bit",
+     "jmp fp_pack",
+     "; B is zero: the sum is A, except that 0 + 0 is -0 only when both are -0",
+     "fpa_b_zero:",
+     "test dx, 7F80h",
+     "jnz fpa_return",
+     "and dx, cx",
+     "and dx, 8000h",
+     "xor ax, ax",
+     "ret",
+     "; An exact zero difference is +0 when rounding to nearest",
+     "fpa_zero:",
+     "xor ax, ax",
+     "xor dx, dx",
+     "fpa_return:",
+     "ret",
+     "; DX:AX = DX:AX * CX:BX",
+     "fp_mul:",
+     "mov si, dx",
+     "xor si, cx",
+     "mov [fp_sign], si",
+     "test dx, 7F80h",
+     "jz fp_zero",
+     "test cx, 7F80h",
+     "jz fp_zero",
+     "call fp_exponents",
+     "add si, di",
+     "sub si, 127",
+     "mov [fp_exp], si",
+     "; 48-bit product of the 24-bit mantissas",
+     "mov [fp_a_hi], dx",
+     "mov [fp_a_lo], ax",
+     "mov [fp_b_hi], cx",
+     "mov [fp_b_lo], bx",
+     "mul bx",
+     "mov si, ax",
+     "mov [fp_p1], dx",
+     "mov ax, [fp_a_hi]",
+     "mul word [fp_b_hi]",
+     "mov [fp_p2], ax",
+     "mov ax, [fp_a_hi]",
+     "mul word [fp_b_lo]",
+     "add [fp_p1], ax",
+     "adc [fp_p2], dx",
+     "mov ax, [fp_a_lo]",
+     "mul word [fp_b_hi]",
+     "add [fp_p1], ax",
+     "adc [fp_p2], dx",
+     "mov ax, [fp_p1]",
+     "mov dx, [fp_p2]",
+     "test dx, 8000h",
+     "jnz fpm_high",
+     "shl si, 1",
+     "rcl ax, 1",
+     "rcl dx, 1",
+     "jmp fpm_round",
+     "fpm_high:",
+     "inc word [fp_exp]",
+     "; Round to nearest even: bit 7 of AX is the rounding bit, the rest sticky",
+     "fpm_round:",
+     "test ax, 0080h",
+     "jz fpm_pack",
+     "test ax, 007Fh",
+     "jnz fpm_up",
+     "cmp si, 0",
+     "jne fpm_up",
+     "test ax, 0100h",
+     "jz fpm_pack",
+     "fpm_up:",
+     "add ax, 100h",
+     "adc dx, 0",
+     "jnc fpm_pack",
+     "mov dx, 8000h",
+     "inc word [fp_exp]",
+     "fpm_pack:",
+     "mov al, ah",
+     "mov ah, dl",
+     "mov dl, dh",
+     "xor dh, dh",
+     "jmp fp_pack",
+     "; DX:AX = DX:AX / CX:BX (0/0 is the 8087's indefinite NaN)",
+     "fp_div:",
+     "mov si, dx",
+     "xor si, cx",
+     "mov [fp_sign], si",
+     "test cx, 7F80h",
+     "jz fpd_by_zero",
+     "test dx, 7F80h",
+     "jz fp_zero",
+     "call fp_exponents",
+     "sub si, di",
+     "add si, 127",
+     "mov [fp_exp], si",
+     "; Dividend between the divisor and twice the divisor",
+     "cmp dx, cx",
+     "ja fpd_start",
+     "jb fpd_shift",
+     "cmp ax, bx",
+     "jae fpd_start",
+     "fpd_shift:",
+     "shl ax, 1",
+     "rcl dx, 1",
+     "dec word [fp_exp]",
+     "fpd_start:",
+     "xor si, si",
+     "xor di, di",
+     "mov word [fp_count], 25",
+     "fpd_loop:",
+     "shl di, 1",
+     "rcl si, 1",
+     "cmp dx, cx",
+     "jb fpd_next",
+     "ja fpd_subtract",
+     "cmp ax, bx",
+     "jb fpd_next",
+     "fpd_subtract:",
+     "sub ax, bx",
+     "sbb dx, cx",
+     "or di, 1",
+     "fpd_next:",
+     "shl ax, 1",
+     "rcl dx, 1",
+     "dec word [fp_count]",
+     "jnz fpd_loop",
+     "; 25 quotient bits: round to nearest even on the last one and the remainder",
+     "shr si, 1",
+     "rcr di, 1",
+     "jnc fpd_pack",
+     "or ax, dx",
+     "jnz fpd_up",
+     "test di, 1",
+     "jz fpd_pack",
+     "fpd_up:",
+     "add di, 1",
+     "adc si, 0",
+     "test si, 0100h",
+     "jz fpd_pack",
+     "shr si, 1",
+     "rcr di, 1",
+     "inc word [fp_exp]",
+     "fpd_pack:",
+     "mov dx, si",
+     "mov ax, di",
+     "jmp fp_pack",
+     "fpd_by_zero:",
+     "test dx, 7F80h",
+     "jnz fpd_infinite",
+     "mov dx, 0FFC0h",
+     "xor ax, ax",
+     "ret",
+     "fpd_infinite:",
+     "mov word [fp_exp], 255",
+     "jmp fp_pack",
+     "; SI = exponent of DX:AX, DI = exponent of CX:BX; hidden bits set",
+     "fp_exponents:",
+     "mov si, dx",
+     "and si, 7F80h",
+     "mov di, cx",
+     "and di, 7F80h",
+     "push cx",
+     "mov cl, 7",
+     "shr si, cl",
+     "shr di, cl",
+     "pop cx",
+     "and dx, 007Fh",
+     "or dx, 0080h",
+     "and cx, 007Fh",
+     "or cx, 0080h",
+     "ret",
+     "; DX:AX = 24-bit mantissa in DX:AX with [fp_exp] and the sign in [fp_sign]",
+     "fp_pack:",
+     "mov si, [fp_exp]",
+     "cmp si, 0",
+     "jle fp_zero",
+     "cmp si, 255",
+     "jge fpp_infinite",
+     "and dx, 007Fh",
+     "mov cl, 7",
+     "shl si, cl",
+     "or dx, si",
+     "jmp fpp_sign",
+     "fpp_infinite:",
+     "mov dx, 7F80h",
+     "xor ax, ax",
+     "fpp_sign:",
+     "mov si, [fp_sign]",
+     "and si, 8000h",
+     "or dx, si",
+     "ret",
+     "fp_zero:",
+     "xor ax, ax",
+     "mov dx, [fp_sign]",
+     "and dx, 8000h",
+     "ret",
+     "; DX:AX = AX converted from a signed integer",
+     "fp_from_int:",
+     "xor dx, dx",
+     "cmp ax, 0",
+     "je fpi_return",
+     "mov [fp_sign], ax",
+     "jg fpi_positive",
+     "neg ax",
+     "fpi_positive:",
+     "mov word [fp_exp], 142",
+     "fpi_normalize:",
+     "test ax, 8000h",
+     "jnz fpi_pack",
+     "shl ax, 1",
+     "dec word [fp_exp]",
+     "jmp fpi_normalize",
+     "fpi_pack:",
+     "mov dl, ah",
+     "mov ah, al",
+     "xor al, al",
+     "jmp fp_pack",
+     "fpi_return:",
+     "ret",
+     "; AX = DX:AX truncated toward zero (8000h when out of range, like fistp)",
+     "fp_to_int:",
+     "mov [fp_sign], dx",
+     "mov si, dx",
+     "mov cl, 7",
+     "shr si, cl",
+     "and si, 00FFh",
+     "sub si, 127",
+     "jl fpt_zero",
+     "cmp si, 15",
+     "jge fpt_overflow",
+     "and dx, 007Fh",
+     "or dx, 0080h",
+     "mov cx, 23",
+     "sub cx, si",
+     "fpt_shift:",
+     "shr dx, 1",
+     "rcr ax, 1",
+     "dec cx",
+     "jnz fpt_shift",
+     "test word [fp_sign], 8000h",
+     "jz fpt_return",
+     "neg ax",
+     "fpt_return:",
+     "ret",
+     "fpt_zero:",
+     "xor ax, ax",
+     "ret",
+     "fpt_overflow:",
+     "mov ax, 8000h",
+     "ret",
+     "; AX = -1, 0 or 1 as DX:AX is below, equal to or above CX:BX",
+     "fp_cmp:",
+     "mov si, dx",
+     "and si, 7FFFh",
+     "or si, ax",
+     "mov di, cx",
+     "and di, 7FFFh",
+     "or di, bx",
+     "or si, di",
+     "jz fpc_equal",
+     "; Order the bit patterns: negatives inverted, positives above them",
+     "test dx, 8000h",
+     "jz fpc_a_positive",
+     "not dx",
+     "not ax",
+     "jmp fpc_b",
+     "fpc_a_positive:",
+     "xor dx, 8000h",
+     "fpc_b:",
+     "test cx, 8000h",
+     "jz fpc_b_positive",
+     "not cx",
+     "not bx",
+     "jmp fpc_compare",
+     "fpc_b_positive:",
+     "xor cx, 8000h",
+     "fpc_compare:",
+     "cmp dx, cx",
+     "ja fpc_above",
+     "jb fpc_below",
+     "cmp ax, bx",
+     "ja fpc_above",
+     "jb fpc_below",
+     "fpc_equal:",
+     "xor ax, ax",
+     "ret",
+     "fpc_above:",
+     "mov ax, 1",
+     "ret",
+     "fpc_below:",
+     "mov ax, -1",
+     "ret"
+ };
+ 
  // Forward declarations of helper functions
  static void emit_file_header(void);
  static void emit_data_segment(void);
@@ -99,193 +1512,430 @@
  void codegen_init(void) {
      // Reset state
      label_counter = 0;
-     message_counter = 0;
-     message_count = 0;
+     range_check_used = 0;
+     char_input_used = 0;
+     fpu_used = 0;
+     fpu_control_used = 0;
+     fpu_status_used = 0;
+     fpu_scratch_used = 0;
+     soft_float_used = 0;
+     asm_line_count = 0;
+     current_quad_id = -1;
+     addressed_constant_count = 0;
+     
+     // Clear the message pool
+     if (messages) {
+         strpool_clear(messages);
+     } else {
+         messages = strpool_create();
+     }
+     if (message_used) {
+         memset(message_used, 0, message_used_capacity);
+     }
+     if (float_constants) {
+         strpool_clear(float_constants);
+     }
+ }
+ 
+ // Select the soft-float runtime instead of 8087 instructions
+ void codegen_set_soft_float(int enabled) {
+     soft_float = enabled;
+ }
+ 
+ // Load the display messages numbered by the IR producer
+ static void load_messages(void) {
+     strpool_clear(messages);
+     if (input_ir) {
+         for (uint32_t i = 0; i < input_ir->header->message_count; i++) {
+             strpool_intern(messages, irbin_message(input_ir, i));
+         }
+     } else {
+         StrPool* source = quadgen_get_messages();
+         for (int i = 0; i < strpool_count(source); i++) {
+             strpool_intern(messages, strpool_get(source, i));
+         }
+     }
+ }
+ 
+ // Number of a display message, marking it as used by the program
+ static int use_message(const char* text) {
+     if (!messages) {
+         messages = strpool_create();
+     }
+     int id = strpool_intern(messages, text);
+     if (scratch_lines) {
+         return id;  // Cost estimate only, the program does not change
+     }
+     if (id >= message_used_capacity) {
+         int capacity = message_used_capacity ? message_used_capacity : 64;
+         while (capacity <= id) capacity *= 2;
+         message_used = (char*)safe_realloc(message_used, capacity);
+         memset(message_used + message_used_capacity, 0, capacity - message_used_capacity);
+         message_used_capacity = capacity;
+     }
+     message_used[id] = 1;
+     return id;
+ }
+ 
+ // Move the lines from index 'from' to the end of the stream up to index 'to'
+ static void move_lines_up(int from, int to) {
+     int count = asm_line_count - from;
+     if (count <= 0 || from <= to) {
+         return;
+     }
+     AsmLine* moved = (AsmLine*)safe_malloc(count * sizeof(AsmLine));
+     memcpy(moved, &asm_lines[from], count * sizeof(AsmLine));
+     memmove(&asm_lines[to + count], &asm_lines[to], (from - to) * sizeof(AsmLine));
+     memcpy(&asm_lines[to], moved, count * sizeof(AsmLine));
+     free(moved);
+ }
+ 
+ // Number of input quadruples
+ static int input_quad_count(void) {
+     return input_ir ? (int)input_ir->header->quad_count : quadgen_get_count();
+ }
+ 
+ // Fields of an input quadruple
+ static void input_quad(int index, const char** op, const char** arg1, const char** arg2, const char** result) {
+     if (input_ir) {
+         const IrBinQuad* q = &input_ir->quads[index];
+         *op = irbin_quad_op(input_ir, q);
+         *arg1 = irbin_string(input_ir, q->arg1);
+         *arg2 = irbin_string(input_ir, q->arg2);
+         *result = irbin_string(input_ir, q->result);
+     } else {
+         Quadruplet* q = quadgen_get(index);
+         *op = q->op;
+         *arg1 = q->arg1;
+         *arg2 = q->arg2;
+         *result = q->result;
+     }
+ }
+ 
+ // A compiler temporary: T followed by its number
+ static int is_temp_name(const char* name) {
+     return name[0] == 'T' && name[1] >= '0' && name[1] <= '9';
+ }
+ 
+ // Index of a temporary in temp_slots, or -1
+ static int temp_index(const char* name) {
+     if (!temp_slots || !is_temp_name(name)) {
+         return -1;
+     }
+     int number = atoi(name + 1);
+     return number < temp_number_limit ? temp_by_number[number] : -1;
+ }
+ 
+ // Conditional branches: "Bxx label left right"
+ static int is_conditional_branch(const char* op) {
+     return strcmp(op, "BG") == 0 || strcmp(op, "BGE") == 0 || strcmp(op, "BL") == 0 ||
+            strcmp(op, "BLE") == 0 || strcmp(op, "BE") == 0 || strcmp(op, "BNE") == 0;
+ }
+ 
+ // Which fields of a quadruple hold operands (bit 0 arg1, bit 1 arg2, bit 2 result);
+ // messages, formats and labels are left alone
+ static int operand_fields(const char* op) {
+     if (strcmp(op, "AFFICHER") == 0) return 2;
+     if (strcmp(op, "LIRE") == 0) return 4;
+     if (strcmp(op, "BOUNDS") == 0) return 1;
+     if (is_conditional_branch(op)) return 6;
+     if (strcmp(op, "SAUT") == 0 || strcmp(op, "ETIQ") == 0 || strcmp(op, "ADEC") == 0) return 0;
+     return 7;
+ }
+ 
+ // Temporary used by an operand (itself, or the index of an element), or -1
+ static int operand_temp(const char* value) {
+     const char* bracket = strchr(value, '[');
+     if (!bracket) {
+         return temp_index(value);
+     }
+     char index[32] = {0};
+     sscanf(bracket + 1, "%31[^]]", index);
+     return temp_index(index);
+ }
+ 
+ // Temporaries read and written by a quadruple; the result is written unless the
+ // quadruple is a branch or the result is an array element
+ static void quad_temps(const char* op, const char* arg1, const char* arg2, const char* result,
+                        int uses[3], int* use_count, int* def) {
+     const char* fields[3] = { arg1, arg2, result };
+     int mask = operand_fields(op);
+     *use_count = 0;
+     *def = -1;
+     for (int f = 0; f < 3; f++) {
+         if (!(mask & (1 << f))) continue;
+         if (f == 2 && !is_conditional_branch(op) && !strchr(result, '[')) {
+             *def = temp_index(result);
+             continue;
+         }
+         int t = operand_temp(fields[f]);
+         if (t >= 0) uses[(*use_count)++] = t;
+     }
+ }
+ 
+ // Release the temporary slot assignment
+ static void free_temp_slots(void) {
+     free(temp_slots);
+     temp_slots = NULL;
+     temp_slot_count = 0;
+     free(temp_by_number);
+     temp_by_number = NULL;
+     temp_number_limit = 0;
+ }
+ 
+ // Share data slots between temporaries. Liveness is solved backwards over the
+ // basic blocks, a temporary interferes with every temporary live where it is
+ // written, and the interference graph is coloured greedily in symbol table
+ // order, one colour per slot among temporaries of the same type.
+ static void coalesce_temporaries(int quad_count) {
+     const char *op, *arg1, *arg2, *result;
+     free_temp_slots();
+     
+     // Temporaries of the symbol table
+     int symbol_count = symboltable_get_count();
+     temp_slots = (TempSlot*)safe_malloc((symbol_count + 1) * sizeof(TempSlot));
+     for (int i = 0; i < symbol_count; i++) {
+         SymbolNode* symbol = symboltable_get_by_index(i);
+         if (symbol && is_temp_name(symbol->name)) {
+             TempSlot* t = &temp_slots[temp_slot_count];
+             t->symbol = symbol;
+             t->number = atoi(symbol->name + 1);
+             t->slot = temp_slot_count++;
+             if (t->number >= temp_number_limit) temp_number_limit = t->number + 1;
+         }
+     }
+     temp_by_number = (int*)safe_malloc((temp_number_limit + 1) * sizeof(int));
+     for (int i = 0; i < temp_number_limit; i++) temp_by_number[i] = -1;
+     for (int i = 0; i < temp_slot_count; i++) temp_by_number[temp_slots[i].number] = i;
+     int n = temp_slot_count;
+     if (n < 2 || quad_count == 0) {
+         return;
+     }
+     
+     // Basic blocks: a label or the quadruple after a jump starts one
+     int* block_of = (int*)safe_malloc(quad_count * sizeof(int));
+     int* block_start = (int*)safe_malloc((quad_count + 1) * sizeof(int));
+     StrPool* labels = strpool_create();
+     int* label_block = (int*)safe_malloc(quad_count * sizeof(int));
+     int block_count = 0;
+     for (int i = 0; i < quad_count; i++) {
+         input_quad(i, &op, &arg1, &arg2, &result);
+         int starts = i == 0 || strcmp(op, "ETIQ") == 0;
+         if (i > 0) {
+             const char *prev_op, *a, *b, *c;
+             input_quad(i - 1, &prev_op, &a, &b, &c);
+             starts |= strcmp(prev_op, "SAUT") == 0 || is_conditional_branch(prev_op);
+         }
+         if (starts) block_start[block_count++] = i;
+         block_of[i] = block_count - 1;
+         if (strcmp(op, "ETIQ") == 0) {
+             label_block[strpool_intern(labels, arg1)] = block_count - 1;
+         }
+     }
+     block_start[block_count] = quad_count;
+     
+     // Successors: the jump target and/or the next block
+     int* succ = (int*)safe_malloc(2 * block_count * sizeof(int));
+     for (int b = 0; b < block_count; b++) {
+         input_quad(block_start[b + 1] - 1, &op, &arg1, &arg2, &result);
+         int falls_through = strcmp(op, "SAUT") != 0;
+         const char* target = strcmp(op, "SAUT") == 0 ? (arg1[0] != '\0' ? arg1 : result) :
+                              is_conditional_branch(op) ? arg1 : NULL;
+         int label = target ? strpool_find(labels, target) : -1;
+         succ[2 * b] = label >= 0 ? label_block[label] : -1;
+         succ[2 * b + 1] = falls_through && b + 1 < block_count ? b + 1 : -1;
+     }
+     
+     // Live-in sets per block, iterated to a fixed point
+     int words = (n + 31) / 32;
+     uint32_t* live_in = (uint32_t*)safe_malloc(block_count * words * sizeof(uint32_t));
+     uint32_t* live = (uint32_t*)safe_malloc(words * sizeof(uint32_t));
+     memset(live_in, 0, block_count * words * sizeof(uint32_t));
+     int uses[3], use_count, def;
+     int changed = 1;
+     while (changed) {
+         changed = 0;
+         for (int b = block_count - 1; b >= 0; b--) {
+             memset(live, 0, words * sizeof(uint32_t));
+             for (int s = 0; s < 2; s++) {
+                 if (succ[2 * b + s] < 0) continue;
+                 const uint32_t* in = &live_in[succ[2 * b + s] * words];
+                 for (int w = 0; w < words; w++) live[w] |= in[w];
+             }
+             for (int i = block_start[b + 1] - 1; i >= block_start[b]; i--) {
+                 input_quad(i, &op, &arg1, &arg2, &result);
+                 quad_temps(op, arg1, arg2, result, uses, &use_count, &def);
+                 if (def >= 0) live[def / 32] &= ~(1u << (def % 32));
+                 for (int u = 0; u < use_count; u++) live[uses[u] / 32] |= 1u << (uses[u] % 32);
+             }
+             uint32_t* in = &live_in[b * words];
+             if (memcmp(in, live, words * sizeof(uint32_t)) != 0) {
+                 memcpy(in, live, words * sizeof(uint32_t));
+                 changed = 1;
+             }
+         }
+     }
+     
+     // Interference: a written temporary against everything live after the write,
+     // and against the operands of the same quadruple (the result may be stored
+     // before every operand is read)
+     uint32_t* interferes = (uint32_t*)safe_malloc(n * words * sizeof(uint32_t));
+     memset(interferes, 0, n * words * sizeof(uint32_t));
+     #define INTERFERE(a, b) do { \
+         interferes[(a) * words + (b) / 32] |= 1u << ((b) % 32); \
+         interferes[(b) * words + (a) / 32] |= 1u << ((a) % 32); \
+     } while (0)
+     for (int b = 0; b < block_count; b++) {
+         memset(live, 0, words * sizeof(uint32_t));
+         for (int s = 0; s < 2; s++) {
+             if (succ[2 * b + s] < 0) continue;
+             const uint32_t* in = &live_in[succ[2 * b + s] * words];
+             for (int w = 0; w < words; w++) live[w] |= in[w];
+         }
+         for (int i = block_start[b + 1] - 1; i >= block_start[b]; i--) {
+             input_quad(i, &op, &arg1, &arg2, &result);
+             quad_temps(op, arg1, arg2, result, uses, &use_count, &def);
+             if (def >= 0) {
+                 for (int t = 0; t < n; t++) {
+                     if (t != def && (live[t / 32] & (1u << (t % 32)))) INTERFERE(def, t);
+                 }
+                 for (int u = 0; u < use_count; u++) {
+                     if (uses[u] != def) INTERFERE(def, uses[u]);
+                 }
+                 live[def / 32] &= ~(1u << (def % 32));
+             }
+             for (int u = 0; u < use_count; u++) live[uses[u] / 32] |= 1u << (uses[u] % 32);
+         }
+     }
+     #undef INTERFERE
      
-     // Clear message string array
-     for (int i = 0; i < MAX_MESSAGES; i++) {
-         message_strings[i].label = NULL;
-         message_strings[i].text = NULL;
+     // Greedy colouring: the first slot of the same type with no interfering member
+     int* owners = (int*)safe_malloc(n * sizeof(int));
+     int owner_count = 0;
+     for (int t = 0; t < n; t++) {
+         temp_slots[t].slot = t;
+         for (int o = 0; o < owner_count; o++) {
+             int owner = owners[o];
+             if (temp_slots[owner].symbol->type != temp_slots[t].symbol->type) continue;
+             int free_slot = 1;
+             for (int m = 0; m < t && free_slot; m++) {
+                 if (temp_slots[m].slot == owner && (interferes[t * words + m / 32] & (1u << (m % 32)))) {
+                     free_slot = 0;
+                 }
+             }
+             if (free_slot) {
+                 temp_slots[t].slot = owner;
+                 break;
+             }
+         }
+         if (temp_slots[t].slot == t) owners[owner_count++] = t;
      }
+     printf("Temporary slots: %d temporaries in %d slots\n", n, owner_count);
+     
+     free(owners);
+     free(interferes);
+     free(live);
+     free(live_in);
+     free(succ);
+     free(label_block);
+     strpool_destroy(labels);
+     free(block_start);
+     free(block_of);
+ }
+ 
+ // An operand with its temporary (or element index) renamed to the slot owner
+ static const char* slot_operand(const char* value, char* buffer, size_t size) {
+     const char* bracket = strchr(value, '[');
+     const char* name = bracket ? bracket + 1 : value;
+     int t = operand_temp(value);
+     if (t < 0 || temp_slots[t].slot == t) {
+         return value;
+     }
+     const char* owner = temp_slots[temp_slots[t].slot].symbol->name;
+     if (bracket) {
+         snprintf(buffer, size, "%.*s[%s%s", (int)(bracket - value), value, owner, strchr(name, ']'));
+     } else {
+         snprintf(buffer, size, "%s", owner);
+     }
+     return buffer;
  }
  
  // Main code generation function
  int codegen_generate(const char* quad_file, const char* asm_file) {
-     FILE* input = fopen(quad_file, "r");
-     if (!input) {
+     // Binary IR is mapped and read in place; CSV goes through the quadruplet reader
+     if (irbin_is_binary(quad_file)) {
+         input_ir = irbin_open(quad_file);
+         if (!input_ir) {
+             return 0;
+         }
+     } else if (!quadgen_read_from_file(quad_file)) {
          report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open quadruple file '%s'", quad_file);
          return 0;
      }
      
      output_file = fopen(asm_file, "w");
      if (!output_file) {
-         fclose(input);
+         irbin_close(input_ir);
+         input_ir = NULL;
          report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open output file '%s'", asm_file);
          return 0;
      }
      
-     // Process header line (skip it)
-     char line[MAX_LINE_LENGTH];
-     fgets(line, MAX_LINE_LENGTH, input);
+     int quad_count = input_quad_count();
+     const char *op, *arg1, *arg2, *result;
      
-     // First pass: Collect all messages from quadruples
-     while (fgets(line, MAX_LINE_LENGTH, input)) {
-         // Parse the quadruple
-         int id;
-         char op[32] = {0};
-         char arg1[64] = {0};
-         
-         // Remove newline
-         char* newline = strchr(line, '\n');
-         if (newline) *newline = '\0';
-         
-         // Parse CSV format
-         char* p = line;
-         char* end;
-         
-         // Parse ID
-         id = strtol(p, &end, 10);
-         if (p == end) continue;
-         
-         // Move to op
-         p = strchr(p, ',');
-         if (!p) continue;
-         p++;
-         
-         // Parse op
-         end = strchr(p, ',');
-         if (!end) continue;
-         
-         int len = end - p;
-         if (len > 0 && len < sizeof(op)) {
-             strncpy(op, p, len);
-             op[len] = '\0';
-         }
-         
-         // Move to arg1
-         p = end + 1;
-         
-         // Parse arg1
-         end = strchr(p, ',');
-         if (!end) continue;
-         
-         len = end - p;
-         if (len > 0 && len < sizeof(arg1)) {
-             strncpy(arg1, p, len);
-             arg1[len] = '\0';
-         }
-         
-         // If this is a display operation, save the message
-         if (strcmp(op, "AFFICHER") == 0) {
-             char msg_label[32];
-             sprintf(msg_label, "msg%d", message_counter++);
-             
-             if (message_count < MAX_MESSAGES) {
-                 message_strings[message_count].label = strdup(msg_label);
-                 message_strings[message_count].text = strdup(arg1);
-                 message_count++;
-             }
-         }
+     load_messages();
+     if (message_used) {
+         memset(message_used, 0, message_used_capacity);
      }
      
-     // Rewind the file to process all quadruples
-     rewind(input);
-     fgets(line, MAX_LINE_LENGTH, input); // Skip header again
-     
      // Generate file structure
      emit_file_header();
-     emit_data_segment();
+     int data_position = asm_line_count;
      emit_code_segment();
+     int code_start = asm_line_count - 1;
      
-     // Second pass: Process each quadruple
-     while (fgets(line, MAX_LINE_LENGTH, input)) {
-         // Parse the quadruple
-         int id;
-         char op[32] = {0};
-         char arg1[64] = {0};
-         char arg2[64] = {0};
-         char result[64] = {0};
-         
-         // Remove newline
-         char* newline = strchr(line, '\n');
-         if (newline) *newline = '\0';
-         
-         // Parse CSV format
-         char* p = line;
-         char* end;
-         
-         // Parse ID
-         id = strtol(p, &end, 10);
-         if (p == end) continue;
-         
-         // Move to op
-         p = strchr(p, ',');
-         if (!p) continue;
-         p++;
-         
-         // Parse op
-         end = strchr(p, ',');
-         if (!end) continue;
-         
-         int len = end - p;
-         if (len > 0 && len < sizeof(op)) {
-             strncpy(op, p, len);
-             op[len] = '\0';
-         }
-         
-         // Move to arg1
-         p = end + 1;
-         
-         // Parse arg1
-         end = strchr(p, ',');
-         if (!end) continue;
-         
-         len = end - p;
-         if (len > 0 && len < sizeof(arg1)) {
-             strncpy(arg1, p, len);
-             arg1[len] = '\0';
-         }
-         
-         // Move to arg2
-         p = end + 1;
-         
-         // Parse arg2
-         end = strchr(p, ',');
-         if (!end) continue;
-         
-         len = end - p;
-         if (len > 0 && len < sizeof(arg2)) {
-             strncpy(arg2, p, len);
-             arg2[len] = '\0';
-         }
-         
-         // Move to result
-         p = end + 1;
-         
-         // Parse result (rest of line)
-         if (strlen(p) > 0 && strlen(p) < sizeof(result)) {
-             strcpy(result, p);
-         }
-         
-         // Process the quadruple
-         process_quadruple(id, op, arg1, arg2, result);
+     // Temporaries that are never live together share their storage
+     coalesce_temporaries(quad_count);
+     
+     // Single pass over the quadruples
+     for (int i = 0; i < quad_count; i++) {
+         char slot_arg1[64], slot_arg2[64], slot_result[64];
+         input_quad(i, &op, &arg1, &arg2, &result);
+         int fields = operand_fields(op);
+         process_quadruple(i, op,
+                           (fields & 1) ? slot_operand(arg1, slot_arg1, sizeof(slot_arg1)) : arg1,
+                           (fields & 2) ? slot_operand(arg2, slot_arg2, sizeof(slot_arg2)) : arg2,
+                           (fields & 4) ? slot_operand(result, slot_result, sizeof(slot_result)) : result);
      }
      
-     emit_io_hooks();
+     current_quad_id = -1;
+     if (fpu_used) {
+         // Put the 8087 in its default state before the first float instruction
+         int init_start = asm_line_count;
+         emit_instr("finit");
+         move_lines_up(init_start, code_start);
+     }
      emit_file_footer();
+     emit_io_hooks();
+     
+     // The data segment depends on what the code used; it goes after the header
+     int data_start = asm_line_count;
+     emit_data_segment();
+     move_lines_up(data_start, data_position);
      
-     fclose(input);
+     // Write the assembly text
+     write_asm_stream(output_file);
+     
+     irbin_close(input_ir);
+     input_ir = NULL;
+     free_temp_slots();
      fclose(output_file);
      output_file = NULL;
      
      printf("Assembly code generated to '%s'\n", asm_file);
-     
-     // Free memory used for message strings
-     for (int i = 0; i < message_count; i++) {
-         if (message_strings[i].label) free(message_strings[i].label);
-         if (message_strings[i].text) free(message_strings[i].text);
-     }
-     
+
+     // The message pool and the line stream stay alive until codegen_cleanup()
      return 1;
  }
  
@@ -296,36 +1946,93 @@
          output_file = NULL;
      }
      
-     // Free any allocated memory for message strings
-     for (int i = 0; i < message_count; i++) {
-         if (message_strings[i].label) free(message_strings[i].label);
-         if (message_strings[i].text) free(message_strings[i].text);
-         message_strings[i].label = NULL;
-         message_strings[i].text = NULL;
+     // Free the message and float literal pools
+     strpool_destroy(messages);
+     messages = NULL;
+     strpool_destroy(float_constants);
+     float_constants = NULL;
+     free(message_used);
+     message_used = NULL;
+     message_used_capacity = 0;
+     
+     // Release the assembly stream
+     free(asm_lines);
+     asm_lines = NULL;
+     asm_line_count = 0;
+     asm_line_capacity = 0;
+ }
+ 
+ // Number of lines in the last generated assembly stream
+ int codegen_get_line_count(void) {
+     return asm_line_count;
+ }
+ 
+ // Get a line of the last generated assembly stream
+ const AsmLine* codegen_get_line(int index) {
+     if (index < 0 || index >= asm_line_count) {
+         return NULL;
      }
-     message_count = 0;
+     return &asm_lines[index];
+ }
+ 
+ // Lower a single quadruple into a scratch buffer (used for cost estimates)
+ int codegen_lower_quad(const Quadruplet* q, AsmLine* lines, int max_lines) {
+     scratch_lines = lines;
+     scratch_count = 0;
+     scratch_capacity = max_lines;
+     
+     process_quadruple(q->id, q->op, q->arg1, q->arg2, q->result);
+     
+     int count = scratch_count;
+     scratch_lines = NULL;
+     scratch_count = 0;
+     scratch_capacity = 0;
+     current_quad_id = -1;
+     return count;
  }
  
  // Emit file header with basic setup
  static void emit_file_header(void) {
-     fprintf(output_file, "; Generated by PHYLOG Compiler\n");
-     fprintf(output_file, "bits 16\n");
-     fprintf(output_file, "global _start\n\n");
+     emit_directive("; Generated by PHYLOG Compiler");
+     emit_directive("bits 16");
+     emit_directive("global _start");
+     emit_blank();
  }
  
  // Emit data segment with variables
  static void emit_data_segment(void) {
-     fprintf(output_file, "section .data\n");
+     emit_section(".data");
      
      // Define message for hooks
-     fprintf(output_file, "    hook_input db 'INPUT', 0\n");
-     fprintf(output_file, "    hook_output db 'OUTPUT', 0\n");
+     emit_data("hook_input", "db 'INPUT', 0");
+     emit_data("hook_output", "db 'OUTPUT', 0");
      
-     // Output all message strings collected during first pass
-     fprintf(output_file, "    ; Message strings\n");
-     for (int i = 0; i < message_count; i++) {
-         fprintf(output_file, "    %s db '%s', 0\n", 
-                 message_strings[i].label, message_strings[i].text);
+     // Output the displayed message strings; a message ending another one
+     // is stored inside it
+     emit_comment("Message strings");
+     int count = strpool_count(messages);
+     if (count > 0) {
+         int* owner = (int*)safe_malloc(count * sizeof(int));
+         int* offset = (int*)safe_malloc(count * sizeof(int));
+         char* stored = (char*)safe_malloc(count);
+         strpool_share_suffixes(messages, owner, offset);
+         
+         memset(stored, 0, count);
+         for (int i = 0; i < count && i < message_used_capacity; i++) {
+             if (message_used[i]) stored[owner[i]] = 1;
+         }
+         for (int i = 0; i < count; i++) {
+             char label[16];
+             sprintf(label, "msg%d", i);
+             if (stored[i]) {
+                 emit_data(label, "db '%s', 0", strpool_get(messages, i));
+             } else if (i < message_used_capacity && message_used[i]) {
+                 emit_data(label, "equ msg%d + %d", owner[i], offset[i]);
+             }
+         }
+         free(owner);
+         free(offset);
+         free(stored);
      }
      
      // Output all variables from symbol table
@@ -337,28 +2044,45 @@
          if (!symbol) continue;
          
          // Skip temporaries for now, we'll handle them in the second pass
-         if (symbol->name[0] == 'T' && symbol->name[1] >= '0' && symbol->name[1] <= '9') {
+         if (is_temp_name(symbol->name)) {
              continue;
          }
          
          switch (symbol->category) {
              case CATEGORY_VARIABLE:
-                 // Regular variable - define as word (2 bytes)
-                 fprintf(output_file, "    %s dw 0\n", symbol->name);
+                 // Regular variable - define as word (2 bytes), a character as byte,
+                 // a float as doubleword
+                 emit_data(symbol->name, symbol->type == TYPE_FLOAT ? "dd 0.0" :
+                                         symbol->type == TYPE_CHAR ? "db 0" : "dw 0");
                  break;
                  
              case CATEGORY_CONSTANT:
-                 // Constant - define with its value
-                 if (symbol->type == TYPE_INTEGER) {
-                     fprintf(output_file, "    %s dw %d\n", symbol->name, symbol->value.int_value);
+                 // Constant - used as an immediate, stored only if its address is taken
+                 for (int j = 0; j < addressed_constant_count; j++) {
+                     if (strcmp(addressed_constants[j], symbol->name) != 0) {
+                         continue;
+                     }
+                     if (symbol->type == TYPE_INTEGER) {
+                         emit_data(symbol->name, "dw %d", symbol->value.int_value);
+                     } else if (symbol->type == TYPE_FLOAT) {
+                         char literal[32];
+                         format_float(literal, sizeof(literal), symbol->value.float_value);
+                         emit_data(symbol->name, "dd %s", literal);
+                     } else if (symbol->type == TYPE_CHAR) {
+                         emit_data(symbol->name, "db '%c'", symbol->value.char_value);
+                     }
                  }
                  break;
                  
              case CATEGORY_ARRAY:
                  // Array - reserve space
                  if (symbol->type == TYPE_INTEGER) {
-                     fprintf(output_file, "    %s times %d dw 0\n", 
-                             symbol->name, symbol->array_size);
+                     emit_data(symbol->name, "times %d dw 0", symbol->array_size);
+                 } else if (symbol->type == TYPE_FLOAT) {
+                     emit_data(symbol->name, "times %d dd 0.0", symbol->array_size);
+                 } else if (symbol->type == TYPE_CHAR) {
+                     // Packed: one byte per character
+                     emit_data(symbol->name, "times %d db 0", symbol->array_size);
                  }
                  break;
                  
@@ -367,59 +2091,230 @@
          }
      }
      
-     // Second pass: Only include temporary variables that are in the symbol table
-     fprintf(output_file, "    ; Temporary variables\n");
+     // Second pass: one slot per group of temporaries that are never live together
+     emit_comment("Temporary variables");
      for (int i = 0; i < symbol_count; i++) {
          SymbolNode* symbol = symboltable_get_by_index(i);
-         if (symbol && symbol->name[0] == 'T' && symbol->name[1] >= '0' && symbol->name[1] <= '9') {
-             fprintf(output_file, "    %s dw 0\n", symbol->name);
+         if (symbol && is_temp_name(symbol->name)) {
+             int t = temp_index(symbol->name);
+             if (t >= 0 && temp_slots[t].slot != t) {
+                 continue;
+             }
+             emit_data(symbol->name, symbol->type == TYPE_FLOAT ? "dd 0.0" :
+                                     symbol->type == TYPE_CHAR ? "db 0" : "dw 0");
          }
      }
+     if (char_input_used) {
+         emit_data("char_input", "dw 0");
+     }
      
-     fprintf(output_file, "\n");
+     // Float support: 8087 operands and status, soft-float runtime workspace
+     if (fpu_used) {
+         emit_comment("8087 operands");
+         for (int i = 0; float_constants && i < strpool_count(float_constants); i++) {
+             char label[16];
+             sprintf(label, "flt%d", i);
+             emit_data(label, "dd %s", strpool_get(float_constants, i));
+         }
+         if (fpu_status_used) {
+             emit_data("fpu_status", "dw 0");
+         }
+         if (fpu_control_used) {
+             emit_data("fpu_control", "dw 0");
+             emit_data("fpu_truncate", "dw 0");
+         }
+         if (fpu_scratch_used) {
+             emit_data("fpu_scratch", "dd 0.0");
+         }
+     }
+     if (soft_float_used) {
+         emit_comment("Soft-float workspace");
+         for (size_t i = 0; i < sizeof(soft_float_words) / sizeof(soft_float_words[0]); i++) {
+             emit_data(soft_float_words[i], "dw 0");
+         }
+     }
+     
+     emit_blank();
  }
  
  // Emit beginning of code segment
  static void emit_code_segment(void) {
-     fprintf(output_file, "section .text\n");
-     fprintf(output_file, "_start:\n");
-     fprintf(output_file, "    ; Program initialization\n");
-     fprintf(output_file, "    mov ax, data\n");
-     fprintf(output_file, "    mov ds, ax\n\n");
+     emit_section(".text");
+     emit_label("_start");
+     emit_comment("Program initialization");
+     emit_instr("mov ax, data");
+     emit_instr("mov ds, ax");
+     emit_blank();
  }
  
  // Emit I/O hook routines
  static void emit_io_hooks(void) {
-     fprintf(output_file, "\n; I/O Hooks for Python emulator\n");
+     emit_blank();
+     emit_directive("; I/O Hooks for Python emulator");
      
      // Input hook routine
-     fprintf(output_file, "read_int:\n");
-     fprintf(output_file, "    ; Input hook - Python will intercept\n");
-     fprintf(output_file, "    mov ax, 0FFFFh  ; Input hook identifier\n");
-     fprintf(output_file, "    int 80h         ; Custom interrupt\n");
-     fprintf(output_file, "    ret\n\n");
+     emit_label("read_int");
+     emit_comment("Input hook - Python will intercept");
+     emit_instr("mov ax, 0FFFFh  ; Input hook identifier");
+     emit_instr("int 80h         ; Custom interrupt");
+     emit_instr("ret");
+     emit_blank();
      
      // Output hook routine
-     fprintf(output_file, "print_int:\n");
-     fprintf(output_file, "    ; Output hook - Python will intercept\n");
-     fprintf(output_file, "    mov ax, 0FFFEh  ; Output hook identifier\n");
-     fprintf(output_file, "    int 80h         ; Custom interrupt\n");
-     fprintf(output_file, "    ret\n\n");
+     emit_label("print_int");
+     emit_comment("Output hook - Python will intercept");
+     emit_instr("mov ax, 0FFFEh  ; Output hook identifier");
+     emit_instr("int 80h         ; Custom interrupt");
+     emit_instr("ret");
+     
+     // Range error routine for checked accesses, block fills and copies
+     if (range_check_used) {
+         emit_blank();
+         emit_label("array_range_error");
+         emit_comment("Array access outside its bounds - stop with exit code 1");
+         emit_instr("mov ax, 4C01h");
+         emit_instr("int 21h");
+     }
+     
+     // Soft-float routines called by the program
+     if (soft_float_used) {
+         emit_blank();
+         emit_directive("; Soft-float runtime (IEEE single precision, round to nearest)");
+         for (size_t i = 0; i < sizeof(soft_float_runtime) / sizeof(soft_float_runtime[0]); i++) {
+             const char* line = soft_float_runtime[i];
+             size_t len = strlen(line);
+             if (line[0] == ';') {
+                 emit_comment("%s", line + 2);
+             } else if (line[len - 1] == ':') {
+                 char label[32];
+                 snprintf(label, sizeof(label), "%.*s", (int)(len - 1), line);
+                 emit_label(label);
+             } else {
+                 emit_instr("%s", line);
+             }
+         }
+     }
  }
  
  // Emit file footer with program termination
  static void emit_file_footer(void) {
-     fprintf(output_file, "\n    ; Program termination\n");
-     fprintf(output_file, "    mov ax, 4C00h\n");
-     fprintf(output_file, "    int 21h\n");
+     emit_blank();
+     emit_comment("Program termination");
+     emit_instr("mov ax, 4C00h");
+     emit_instr("int 21h");
+ }
+ 
+ // Lower a quadruple on FLOAT values: 8087 instructions, or calls to the
+ // soft-float runtime; returns 0 when the quadruple involves no float
+ static int process_float_quadruple(const char* op, const char* arg1, const char* arg2, const char* result) {
+     static const struct { const char* op; const char* x87; const char* routine; } arithmetic[] = {
+         { "+", "fadd", "fp_add" }, { "-", "fsub", "fp_sub" }, { "*", "fmul", "fp_mul" }, { "/", "fdiv", "fp_div" }
+     };
+     // The 8087 compare sets the flags of an unsigned compare; fp_cmp returns -1, 0 or 1
+     static const struct { const char* op; const char* x87; const char* soft; } branches[] = {
+         { "BG", "ja", "jg" }, { "BGE", "jae", "jge" }, { "BL", "jb", "jl" },
+         { "BLE", "jbe", "jle" }, { "BE", "je", "je" }, { "BNE", "jne", "jne" }
+     };
+     
+     if (strcmp(op, "CONVERT") == 0) {
+         // "CONVERT x FLOAT t" / "CONVERT x INTEGER t"
+         emit_comment("Convert %s to %s", arg1, arg2);
+         emit_float_move(arg1, result);
+         return 1;
+     }
+     if (strcmp(op, ":=") == 0) {
+         if (!is_float_value(arg1) && !is_float_value(result)) {
+             return 0;
+         }
+         emit_float_move(arg1, result);
+         return 1;
+     }
+     for (size_t i = 0; i < sizeof(arithmetic) / sizeof(arithmetic[0]); i++) {
+         if (strcmp(op, arithmetic[i].op) != 0) {
+             continue;
+         }
+         if (!is_float_value(arg1) && !is_float_value(arg2) && !is_float_value(result)) {
+             return 0;
+         }
+         if (soft_float) {
+             load_float_operands(arg1, arg2);
+             emit_float_call(arithmetic[i].routine);
+             store_dx_ax_to_float(result);
+         } else {
+             x87_load(arg1);
+             x87_apply(arithmetic[i].x87, arg2);
+             x87_store(result);
+         }
+         return 1;
+     }
+     for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++) {
+         if (strcmp(op, branches[i].op) != 0) {
+             continue;
+         }
+         if (!is_float_value(arg2) && !is_float_value(result)) {
+             return 0;
+         }
+         if (soft_float) {
+             load_float_operands(arg2, result);
+             emit_float_call("fp_cmp");
+             emit_instr("cmp ax, 0");
+             emit_instr("%s %s", branches[i].soft, arg1);
+         } else {
+             x87_load(arg2);
+             x87_apply("fcomp", result);
+             emit_instr("fstsw [fpu_status]");
+             emit_instr("fwait");
+             emit_instr("mov ax, [fpu_status]");
+             emit_instr("sahf          ; C3 to ZF, C0 to CF");
+             emit_instr("%s %s", branches[i].x87, arg1);
+             if (!scratch_lines) {
+                 fpu_status_used = 1;
+             }
+         }
+         return 1;
+     }
+     if (strcmp(op, "LIRE") == 0 && is_float_value(result)) {
+         emit_comment("Float input operation");
+         emit_instr("lea bx, [%s]  ; Get address of target variable", result);
+         emit_instr("mov ax, 0FFFDh  ; Float input hook identifier");
+         emit_instr("int 80h         ; Call hook");
+         return 1;
+     }
+     if (strcmp(op, "AFFICHER") == 0 && is_float_value(arg2)) {
+         emit_comment("Float output operation");
+         load_float_to_dx_ax(arg2);
+         emit_instr("mov bx, ax");
+         emit_instr("mov cx, dx    ; Value to output in CX:BX");
+         emit_instr("mov dx, msg%d  ; String message", use_message(arg1));
+         emit_instr("mov ax, 0FFFCh  ; Float output hook identifier");
+         emit_instr("int 80h         ; Call hook");
+         return 1;
+     }
+     return 0;
  }
  
  // Process a single quadruple
  static void process_quadruple(int id, const char* op, const char* arg1, const char* arg2, const char* result) {
-     fprintf(output_file, "\n    ; Quad %d: %s %s %s %s\n", id, op, arg1, arg2, result);
+     current_quad_id = id;
+     emit_blank();
+     emit_comment("Quad %d: %s %s %s %s", id, op, arg1, arg2, result);
+     
+     // FLOAT values and conversions
+     if (process_float_quadruple(op, arg1, arg2, result)) {
+         return;
+     }
      
+     // Character assignment: byte moves
+     if (strcmp(op, ":=") == 0 && is_char_value(result) && is_byte_operand(arg1)) {
+         if (!strchr(result, '[') && is_immediate(resolve_constant(arg1))) {
+             emit_instr("mov byte [%s], %s", result, resolve_constant(arg1));
+         } else {
+             load_byte_to_al(arg1);
+             store_al_to_result(result);
+         }
+     }
      // Assignment operation
-     if (strcmp(op, ":=") == 0) {
+     else if (strcmp(op, ":=") == 0) {
          // Load value to AX
          load_value_to_ax(arg1);
          
@@ -432,9 +2327,9 @@
          load_value_to_ax(arg1);
          
          // Add second operand
-         fprintf(output_file, "    mov cx, ax    ; Save first operand\n");
+         emit_instr("mov cx, ax    ; Save first operand");
          load_value_to_ax(arg2);
-         fprintf(output_file, "    add ax, cx    ; Add operands\n");
+         emit_instr("add ax, cx    ; Add operands");
          
          // Store result
          store_ax_to_result(result);
@@ -444,139 +2339,146 @@
          load_value_to_ax(arg1);
          
          // Subtract second operand
-         fprintf(output_file, "    mov cx, ax    ; Save first operand\n");
+         emit_instr("mov cx, ax    ; Save first operand");
          load_value_to_ax(arg2);
-         fprintf(output_file, "    mov dx, ax    ; Save second operand\n");
-         fprintf(output_file, "    mov ax, cx    ; Restore first operand\n");
-         fprintf(output_file, "    sub ax, dx    ; Subtract second operand\n");
+         emit_instr("mov dx, ax    ; Save second operand");
+         emit_instr("mov ax, cx    ; Restore first operand");
+         emit_instr("sub ax, dx    ; Subtract second operand");
          
          // Store result
          store_ax_to_result(result);
      }
-     else if (strcmp(op, "*") == 0) {
-         // Load first operand to AX
-         load_value_to_ax(arg1);
-         
-         // Multiply by second operand
-         fprintf(output_file, "    mov cx, ax    ; Save first operand\n");
-         load_value_to_ax(arg2);
-         fprintf(output_file, "    imul cx       ; Multiply (result in DX:AX)\n");
-         
-         // Store result (only using AX part for simplicity)
-         store_ax_to_result(result);
-     }
-     else if (strcmp(op, "/") == 0) {
-         // Load first operand to AX
-         load_value_to_ax(arg1);
-         
-         // Divide by second operand
-         fprintf(output_file, "    mov cx, ax    ; Save dividend\n");
-         load_value_to_ax(arg2);
-         fprintf(output_file, "    mov bx, ax    ; Move divisor to BX\n");
-         fprintf(output_file, "    mov ax, cx    ; Move dividend to AX\n");
-         fprintf(output_file, "    cwd           ; Sign extend to DX:AX\n");
-         fprintf(output_file, "    idiv bx       ; Divide, quotient in AX\n");
-         
-         // Store result
-         store_ax_to_result(result);
+     else if (strcmp(op, "*") == 0 || strcmp(op, "/") == 0 || strcmp(op, "%") == 0) {
+         // Multiply, divide or remainder (by constants without imul/idiv when cheaper)
+         emit_multiplicative(op, arg1, arg2, result);
      }
      // Branches and jumps
      else if (strcmp(op, "SAUT") == 0) {
-         // Unconditional jump
-         fprintf(output_file, "    jmp %s\n", arg1);
+         // Unconditional jump (older IR kept the target in the result field)
+         emit_instr("jmp %s", arg1[0] != '\0' ? arg1 : result);
      }
      else if (strcmp(op, "BG") == 0) {
          // Branch if greater
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    jg %s\n", arg1);
+         emit_instr("%s %s", emit_compare(arg2, result) ? "ja" : "jg", arg1);
      }
      else if (strcmp(op, "BGE") == 0) {
          // Branch if greater or equal
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    jge %s\n", arg1);
+         emit_instr("%s %s", emit_compare(arg2, result) ? "jae" : "jge", arg1);
      }
      else if (strcmp(op, "BL") == 0) {
          // Branch if less
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    jl %s\n", arg1);
+         emit_instr("%s %s", emit_compare(arg2, result) ? "jb" : "jl", arg1);
      }
      else if (strcmp(op, "BLE") == 0) {
          // Branch if less or equal
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    jle %s\n", arg1);
+         emit_instr("%s %s", emit_compare(arg2, result) ? "jbe" : "jle", arg1);
      }
      else if (strcmp(op, "BE") == 0) {
          // Branch if equal
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    je %s\n", arg1);
+         emit_compare(arg2, result);
+         emit_instr("je %s", arg1);
      }
      else if (strcmp(op, "BNE") == 0) {
          // Branch if not equal
-         fprintf(output_file, "    mov ax, [%s]\n", arg2);
-         fprintf(output_file, "    cmp ax, [%s]\n", result);
-         fprintf(output_file, "    jne %s\n", arg1);
+         emit_compare(arg2, result);
+         emit_instr("jne %s", arg1);
      }
      // Labels
      else if (strcmp(op, "ETIQ") == 0) {
          // Label definition
-         fprintf(output_file, "%s:\n", arg1);
+         emit_label(arg1);
      }
      // I/O Operations
      else if (strcmp(op, "LIRE") == 0) {
-         // Input operation
-         fprintf(output_file, "    ; Input operation\n");
-         fprintf(output_file, "    lea bx, [%s]  ; Get address of target variable\n", result);
-         fprintf(output_file, "    mov ax, 0FFFFh  ; Input hook identifier\n");
-         fprintf(output_file, "    int 80h         ; Call hook\n");
-     }
-     else if (strcmp(op, "AFFICHER") == 0) {
-         // Find the message label for this display string
-         char* msg_label = NULL;
-         for (int i = 0; i < message_count; i++) {
-             if (strcmp(message_strings[i].text, arg1) == 0) {
-                 msg_label = message_strings[i].label;
-                 break;
+         // Input operation; reading into a constant needs its address
+         SymbolNode* target = symboltable_lookup(result);
+         if (!scratch_lines && target && target->category == CATEGORY_CONSTANT) {
+             int known = 0;
+             for (int i = 0; i < addressed_constant_count; i++) {
+                 if (strcmp(addressed_constants[i], result) == 0) known = 1;
+             }
+             if (!known && addressed_constant_count < MAX_ADDRESSED_CONSTANTS) {
+                 snprintf(addressed_constants[addressed_constant_count++], 32, "%s", result);
              }
          }
-         
-         fprintf(output_file, "    ; Output operation\n");
-         
-         if (msg_label) {
-             fprintf(output_file, "    mov dx, %s  ; String message\n", msg_label);
+         emit_comment("Input operation");
+         if (is_char_value(result)) {
+             // The hook stores a word: read into a buffer, keep the byte
+             emit_instr("lea bx, [char_input]  ; Get address of input buffer");
+             emit_instr("mov ax, 0FFFFh  ; Input hook identifier");
+             emit_instr("int 80h         ; Call hook");
+             emit_instr("mov al, [char_input]");
+             store_al_to_result(result);
+             if (!scratch_lines) {
+                 char_input_used = 1;
+             }
          } else {
-             fprintf(output_file, "    mov dx, offset hook_output  ; Message address\n");
+             emit_instr("lea bx, [%s]  ; Get address of target variable", result);
+             emit_instr("mov ax, 0FFFFh  ; Input hook identifier");
+             emit_instr("int 80h         ; Call hook");
          }
+     }
+     else if (strcmp(op, "AFFICHER") == 0) {
+         emit_comment("Output operation");
+         emit_instr("mov dx, msg%d  ; String message", use_message(arg1));
          
-         // If there's a value to output
-         if (arg2[0] != '\0' && strcmp(arg2, "0") != 0 && strcmp(arg2, "ZERO") != 0) {
+         // If there's a value to output (the parser leaves it empty for ZERO)
+         if (arg2[0] != '\0') {
              // Load value to display
              load_value_to_ax(arg2);
-             fprintf(output_file, "    mov bx, ax  ; Value to output\n");
+             emit_instr("mov bx, ax  ; Value to output");
          } else {
-             fprintf(output_file, "    mov bx, 0     ; No value to output\n");
+             emit_instr("mov bx, 0     ; No value to output");
          }
          
-         fprintf(output_file, "    mov ax, 0FFFEh  ; Output hook identifier\n");
-         fprintf(output_file, "    int 80h         ; Call hook\n");
+         emit_instr("mov ax, 0FFFEh  ; Output hook identifier");
+         emit_instr("int 80h         ; Call hook");
      }
      // Array operations
+     else if (strcmp(op, "BOUNDS") == 0 && strchr(arg1, '[')) {
+         // Access check "BOUNDS A[i] size": one unsigned compare catches i < 0 and i >= size
+         char array_name[64] = {0};
+         char index[64] = {0};
+         sscanf(arg1, "%[^[][%[^]]", array_name, index);
+         
+         emit_comment("Range check on %s", arg1);
+         load_index_to_bx(index);
+         emit_instr("cmp bx, %s   ; Elements in %s", arg2, array_name);
+         emit_instr("jae array_range_error");
+         range_check_used = 1;
+     }
      else if (strcmp(op, "BOUNDS") == 0) {
-         // Array bounds checking
-         fprintf(output_file, "    ; Array bounds checking\n");
-         // No actual code generated for bounds checking in this simple implementation
+         // Declared bounds of the array that follows (checked at compile time)
+         emit_comment("Array bounds checking");
      }
      else if (strcmp(op, "ADEC") == 0) {
          // Array declaration
-         fprintf(output_file, "    ; Array declaration: %s\n", arg1);
+         emit_comment("Array declaration: %s", arg1);
          // No code needed, as array declaration is handled in data segment
      }
+     // Block operations on arrays (one range check, then a string instruction)
+     else if (strcmp(op, "AFILL") == 0) {
+         emit_comment("Fill %s elements from %s", arg2, result);
+         load_operand_to("cx", arg2);
+         emit_block_address(result, arg2, "di");
+         emit_instr("push ds");
+         emit_instr("pop es        ; String stores go through ES");
+         load_value_to_ax(arg1);
+         emit_instr("cld");
+         emit_instr("rep stosw");
+     }
+     else if (strcmp(op, "ACOPY") == 0) {
+         emit_comment("Copy %s elements from %s to %s", arg2, arg1, result);
+         load_operand_to("cx", arg2);
+         emit_block_address(arg1, arg2, "si");
+         emit_block_address(result, arg2, "di");
+         emit_instr("push ds");
+         emit_instr("pop es        ; String stores go through ES");
+         emit_instr("cld");
+         emit_instr("rep movsw");
+     }
      // Unsupported operations
      else {
-         fprintf(output_file, "    ; Unsupported operation: %s\n", op);
+         emit_comment("Unsupported operation: %s", op);
      }
  }
\ No newline at end of file
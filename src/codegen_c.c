@@ -0,0 +1,433 @@
+/*
+ * codegen_c.c - Portable C code generator for the PHYLOG compiler
+ *
+ * Translates the quadruples into one C function: ETIQ becomes a label, SAUT
+ * and the conditional branches become gotos, and the host C compiler does the
+ * register allocation and optimization. Values keep the 16-bit layout of the
+ * 8086 backend (int16_t scalars and arrays, computed in int and truncated on
+ * store), so the executable is a reference for the 8086 and x86-64 output.
+ * Array indexes in the IR are already relative to the lower bound, so arrays
+ * are plain zero-based C arrays. LIRE and AFFICHER call a small stdio runtime
+ * emitted into the same file.
+ */
+
+#include <stdarg.h>
+#include "../include/codegen_c.h"
+#include "../include/symboltable.h"
+#include "../include/quadgen.h"
+#include "../include/irbin.h"
+#include "../include/strpool.h"
+
+// Output file handle
+static FILE* output_file = NULL;
+
+// Input quadruples: a mapped binary IR file, or the quadruplet generator for CSV input
+static IrBinFile* input_ir = NULL;
+
+// Operands that need storage but are not in the symbol table (temporaries)
+static StrPool* extra_variables = NULL;
+
+// Set once the unsupported FLOAT/STRING warning has been given
+static int value_warning_given = 0;
+
+// Emit a statement line
+static void emit(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(output_file, "    ");
+    vfprintf(output_file, format, args);
+    fprintf(output_file, "\n");
+    va_end(args);
+}
+
+// Number of input quadruples
+static int input_quad_count(void) {
+    return input_ir ? (int)input_ir->header->quad_count : quadgen_get_count();
+}
+
+// Fields of an input quadruple
+static void input_quad(int index, const char** op, const char** arg1, const char** arg2, const char** result) {
+    if (input_ir) {
+        const IrBinQuad* q = &input_ir->quads[index];
+        *op = irbin_quad_op(input_ir, q);
+        *arg1 = irbin_string(input_ir, q->arg1);
+        *arg2 = irbin_string(input_ir, q->arg2);
+        *result = irbin_string(input_ir, q->result);
+    } else {
+        Quadruplet* q = quadgen_get(index);
+        *op = q->op;
+        *arg1 = q->arg1;
+        *arg2 = q->arg2;
+        *result = q->result;
+    }
+}
+
+// Check if an operand is an immediate (number or character literal)
+static int is_immediate(const char* value) {
+    return (value[0] >= '0' && value[0] <= '9') || value[0] == '-' || value[0] == '\'';
+}
+
+// Check if an operand is an array element "A[i]"
+static int is_element(const char* value) {
+    return strchr(value, '[') && strchr(value, ']');
+}
+
+// Integer value of an immediate or of an integer/character constant (returns 0 if not known)
+static int immediate_value(const char* value, int* result) {
+    if (value[0] == '"' || (is_immediate(value) && strchr(value, '.'))) {
+        if (!value_warning_given) {
+            report_error(ERROR_LEVEL_WARNING, 0, 0,
+                         "FLOAT and STRING values are not supported by the C backend yet (%s)", value);
+            value_warning_given = 1;
+        }
+        *result = value[0] == '"' ? 0 : (int)(short)atoi(value);
+        return 1;
+    }
+    if (is_immediate(value)) {
+        *result = value[0] == '\'' ? (unsigned char)value[1] : (int)(short)atoi(value);
+        return 1;
+    }
+    SymbolNode* symbol = symboltable_lookup(value);
+    if (symbol && symbol->category == CATEGORY_CONSTANT && symbol->is_initialized) {
+        if (symbol->type == TYPE_INTEGER) {
+            *result = symbol->value.int_value;
+            return 1;
+        }
+        if (symbol->type == TYPE_CHAR) {
+            *result = (unsigned char)symbol->value.char_value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Split "A[i]" into the array name and the index operand
+static void split_element(const char* element, char* array_name, char* index) {
+    array_name[0] = index[0] = '\0';
+    sscanf(element, "%63[^[][%63[^]]", array_name, index);
+}
+
+// Record a scalar operand that has no symbol table entry
+static void note_variable(const char* value) {
+    int immediate;
+    if (value[0] == '\0' || immediate_value(value, &immediate)) {
+        return;
+    }
+    if (is_element(value)) {
+        char array_name[64], index[64];
+        split_element(value, array_name, index);
+        note_variable(index);
+    } else if (!symboltable_lookup(value)) {
+        strpool_intern(extra_variables, value);
+    }
+}
+
+// C expression for an operand (an int value)
+static const char* c_value(const char* value, char* buffer, size_t size) {
+    int immediate;
+    if (value[0] == '\0') {
+        snprintf(buffer, size, "0");
+    } else if (immediate_value(value, &immediate)) {
+        snprintf(buffer, size, "%d", immediate);
+    } else if (is_element(value)) {
+        char array_name[64], index[64], index_text[96];
+        split_element(value, array_name, index);
+        snprintf(buffer, size, "v_%s[%s]", array_name, c_value(index, index_text, sizeof(index_text)));
+    } else {
+        snprintf(buffer, size, "v_%s", value);
+    }
+    return buffer;
+}
+
+// Emit an assignment of an int expression, truncated to the 16-bit storage
+static void emit_store(const char* result, const char* expression) {
+    char target[160];
+    emit("%s = (int16_t)(%s);", c_value(result, target, sizeof(target)), expression);
+}
+
+// Translate a single quadruple
+static void process_quadruple(int id, const char* op, const char* arg1, const char* arg2, const char* result) {
+    static const struct { const char* op; const char* compare; } branches[] = {
+        { "BG", ">" }, { "BGE", ">=" }, { "BL", "<" },
+        { "BLE", "<=" }, { "BE", "==" }, { "BNE", "!=" }
+    };
+    char a[160], b[160], expression[400];
+
+    // A "*/" in a message must not end the comment early
+    char comment[200];
+    snprintf(comment, sizeof(comment), "Quad %d: %s %s %s %s", id, op, arg1, arg2, result);
+    for (char* end = strstr(comment, "*/"); end; end = strstr(end, "*/")) {
+        *end = '+';
+    }
+    fprintf(output_file, "    /* %s */\n", comment);
+
+    for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++) {
+        if (strcmp(op, branches[i].op) == 0) {
+            emit("if (%s %s %s) goto Lq_%s;", c_value(arg2, a, sizeof(a)), branches[i].compare,
+                 c_value(result, b, sizeof(b)), arg1);
+            return;
+        }
+    }
+
+    if (strcmp(op, ":=") == 0) {
+        emit_store(result, c_value(arg1, a, sizeof(a)));
+    }
+    else if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0 ||
+             strcmp(op, "/") == 0 || strcmp(op, "%") == 0) {
+        // Integer division truncates toward zero, like idiv
+        snprintf(expression, sizeof(expression), "%s %s %s",
+                 c_value(arg1, a, sizeof(a)), op, c_value(arg2, b, sizeof(b)));
+        emit_store(result, expression);
+    }
+    else if (strcmp(op, "SAUT") == 0) {
+        // Unconditional jump (older IR kept the target in the result field)
+        emit("goto Lq_%s;", arg1[0] != '\0' ? arg1 : result);
+    }
+    else if (strcmp(op, "ETIQ") == 0) {
+        // The empty statement lets a label end the function
+        fprintf(output_file, "Lq_%s: ;\n", arg1);
+    }
+    else if (strcmp(op, "LIRE") == 0) {
+        // '&' reads a character, every other format an integer
+        emit_store(result, strchr(arg1, '&') ? "phylog_read_char()" : "phylog_read_int()");
+    }
+    else if (strcmp(op, "AFFICHER") == 0) {
+        int has_value = arg2[0] != '\0';
+        fprintf(output_file, "    phylog_display(\"");
+        for (const char* p = arg1; *p; p++) {
+            if (*p == '"' || *p == '\\') {
+                fputc('\\', output_file);
+            }
+            fputc(*p, output_file);
+        }
+        fprintf(output_file, "\", %s, %d);\n", has_value ? c_value(arg2, a, sizeof(a)) : "0", has_value);
+    }
+    else if (strcmp(op, "BOUNDS") == 0 && strchr(arg1, '[')) {
+        // Access check "BOUNDS A[i] size": one unsigned compare catches i < 0 and i >= size
+        char array_name[64], index[64];
+        split_element(arg1, array_name, index);
+        emit("if ((unsigned)(%s) >= %su) phylog_exit(1);", c_value(index, a, sizeof(a)), arg2);
+    }
+    else if (strcmp(op, "BOUNDS") == 0 || strcmp(op, "ADEC") == 0) {
+        // Declarations only, checked at compile time
+    }
+    else if (strcmp(op, "AFILL") == 0 || strcmp(op, "ACOPY") == 0) {
+        // Block operations on "count" elements from element [first] of an array
+        char array_name[64], index[64], first[160];
+        split_element(result, array_name, index);
+        SymbolNode* array = symboltable_lookup(array_name);
+        c_value(index, first, sizeof(first));
+        if (op[1] == 'F') {
+            emit("phylog_fill(v_%s, %d, %s, %s, %s);", array_name, array ? array->array_size : 0,
+                 first, c_value(arg2, b, sizeof(b)), c_value(arg1, a, sizeof(a)));
+        } else {
+            char source_name[64], source_index[64], source_first[160];
+            split_element(arg1, source_name, source_index);
+            SymbolNode* source = symboltable_lookup(source_name);
+            c_value(source_index, source_first, sizeof(source_first));
+            emit("phylog_copy(v_%s, %d, %s, v_%s, %d, %s, %s);", array_name, array ? array->array_size : 0,
+                 first, source_name, source ? source->array_size : 0, source_first, c_value(arg2, b, sizeof(b)));
+        }
+    }
+    else {
+        fprintf(output_file, "    /* Unsupported operation: %s */\n", op);
+    }
+}
+
+// Runtime: integer formatting and parsing on stdio, block operations, exit
+static const char* const runtime_text[] = {
+    "#include <stdio.h>",
+    "#include <stdint.h>",
+    "#include <stdlib.h>",
+    "#include <string.h>",
+    "",
+    "/* Flush the output and exit with a status (1 after an access out of bounds) */",
+    "static void phylog_exit(int status) {",
+    "    fflush(stdout);",
+    "    exit(status);",
+    "}",
+    "",
+    "/* Display a message and a line break; when has_value is set the value",
+    "   replaces the first format character ($ % # as a number, & as a",
+    "   character) or follows the message if it has none */",
+    "static void phylog_display(const char* message, int value, int has_value) {",
+    "    for (const char* p = message; *p; p++) {",
+    "        if (*p == '$' || *p == '%' || *p == '#' || *p == '&') {",
+    "            if (has_value && *p == '&') putchar((unsigned char)value);",
+    "            else if (has_value) printf(\"%d\", value);",
+    "            has_value = 0;",
+    "        } else {",
+    "            putchar(*p);",
+    "        }",
+    "    }",
+    "    if (has_value) printf(\"%d\", value);",
+    "    putchar('\\n');",
+    "}",
+    "",
+    "/* Next input character after blanks and line breaks (EOF at the end) */",
+    "static int phylog_skip_blanks(void) {",
+    "    int c;",
+    "    fflush(stdout);",
+    "    do {",
+    "        c = getchar();",
+    "    } while (c == ' ' || (c >= 9 && c <= 13));",
+    "    return c;",
+    "}",
+    "",
+    "/* Read a signed decimal integer (0 if there is none); the character after",
+    "   the digits is consumed */",
+    "static int phylog_read_int(void) {",
+    "    int c = phylog_skip_blanks(), value = 0, negative = 0;",
+    "    if (c == '-') {",
+    "        negative = 1;",
+    "        c = getchar();",
+    "    }",
+    "    while (c >= '0' && c <= '9') {",
+    "        value = value * 10 + (c - '0');",
+    "        c = getchar();",
+    "    }",
+    "    return negative ? -value : value;",
+    "}",
+    "",
+    "/* Read one non-blank character (0 at the end of the input) */",
+    "static int phylog_read_char(void) {",
+    "    int c = phylog_skip_blanks();",
+    "    return c == EOF ? 0 : c;",
+    "}",
+    "",
+    "/* Check that count elements from element first lie inside an array */",
+    "static void phylog_check_block(int size, int first, int count) {",
+    "    if (first < 0 || first + count > size) phylog_exit(1);",
+    "}",
+    "",
+    "/* Set count elements from element first to a value */",
+    "static void phylog_fill(int16_t* array, int size, int first, int count, int value) {",
+    "    if (count <= 0) return;",
+    "    phylog_check_block(size, first, count);",
+    "    for (int i = 0; i < count; i++) array[first + i] = (int16_t)value;",
+    "}",
+    "",
+    "/* Copy count elements between arrays, first to last like rep movsw (an",
+    "   overlapping copy forward repeats the leading elements) */",
+    "static void phylog_copy(int16_t* target, int target_size, int target_first,",
+    "                        const int16_t* source, int source_size, int source_first, int count) {",
+    "    if (count <= 0) return;",
+    "    phylog_check_block(source_size, source_first, count);",
+    "    phylog_check_block(target_size, target_first, count);",
+    "    for (int i = 0; i < count; i++) target[target_first + i] = source[source_first + i];",
+    "}",
+    NULL
+};
+
+// Emit the storage of the program's variables
+static void emit_variables(void) {
+    int symbol_count = symboltable_get_count();
+
+    fprintf(output_file, "\n/* Program variables */\n");
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        int value;
+        if (!symbol) continue;
+        if (symbol->category == CATEGORY_CONSTANT) {
+            // Used as immediates; the variable is only read back after LIRE into it
+            fprintf(output_file, "static int16_t v_%s = %d;\n", symbol->name,
+                    immediate_value(symbol->name, &value) ? value : 0);
+        } else if (symbol->category == CATEGORY_VARIABLE || symbol->category == CATEGORY_TEMP) {
+            fprintf(output_file, "static int16_t v_%s;\n", symbol->name);
+        } else if (symbol->category == CATEGORY_ARRAY) {
+            fprintf(output_file, "static int16_t v_%s[%d];\n", symbol->name,
+                    symbol->array_size > 0 ? symbol->array_size : 1);
+        }
+    }
+    for (int i = 0; i < strpool_count(extra_variables); i++) {
+        fprintf(output_file, "static int16_t v_%s;\n", strpool_get(extra_variables, i));
+    }
+}
+
+// Main C code generation function
+int codegen_c_generate(const char* quad_file, const char* c_file) {
+    // Binary IR is mapped and read in place; CSV goes through the quadruplet reader
+    if (irbin_is_binary(quad_file)) {
+        input_ir = irbin_open(quad_file);
+        if (!input_ir) {
+            return 0;
+        }
+    } else if (!quadgen_read_from_file(quad_file)) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open quadruple file '%s'", quad_file);
+        return 0;
+    }
+
+    output_file = fopen(c_file, "w");
+    if (!output_file) {
+        irbin_close(input_ir);
+        input_ir = NULL;
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open output file '%s'", c_file);
+        return 0;
+    }
+
+    value_warning_given = 0;
+    extra_variables = strpool_create();
+
+    // Temporaries may only appear in the quadruples
+    int quad_count = input_quad_count();
+    const char *op, *arg1, *arg2, *result;
+    for (int i = 0; i < quad_count; i++) {
+        input_quad(i, &op, &arg1, &arg2, &result);
+        if (strcmp(op, "ETIQ") == 0 || strcmp(op, "SAUT") == 0 || strcmp(op, "ADEC") == 0 ||
+            (strcmp(op, "BOUNDS") == 0 && !strchr(arg1, '['))) {
+            continue;
+        }
+        // Branch labels, messages and read formats are not operands
+        if ((op[0] != 'B' || strcmp(op, "BOUNDS") == 0) &&
+            strcmp(op, "AFFICHER") != 0 && strcmp(op, "LIRE") != 0) {
+            note_variable(arg1);
+        }
+        note_variable(arg2);
+        note_variable(result);
+    }
+
+    fprintf(output_file, "/* Generated by PHYLOG Compiler (portable C) */\n");
+    for (int i = 0; runtime_text[i]; i++) {
+        fprintf(output_file, "%s\n", runtime_text[i]);
+    }
+    emit_variables();
+
+    fprintf(output_file, "\nint main(void) {\n");
+    for (int i = 0; i < quad_count; i++) {
+        input_quad(i, &op, &arg1, &arg2, &result);
+        process_quadruple(i, op, arg1, arg2, result);
+    }
+    fprintf(output_file, "    /* Program termination */\n");
+    emit("phylog_exit(0);");
+    emit("return 0;");
+    fprintf(output_file, "}\n");
+
+    irbin_close(input_ir);
+    input_ir = NULL;
+    fclose(output_file);
+    output_file = NULL;
+
+    strpool_destroy(extra_variables);
+    extra_variables = NULL;
+
+    printf("C code generated to '%s'\n", c_file);
+    return 1;
+}
+
+// Compile generated C into an executable with the host compiler
+int codegen_c_compile(const char* c_file, const char* exe_file) {
+    char command[1600];
+    const char* compiler = getenv("CC");
+    if (!compiler || compiler[0] == '\0') {
+        compiler = "cc";
+    }
+
+    snprintf(command, sizeof(command), "%s -O2 -o '%s' '%s'", compiler, exe_file, c_file);
+    if (system(command) != 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "C compiler failed on '%s'", c_file);
+        return 0;
+    }
+
+    printf("C program compiled to '%s'\n", exe_file);
+    return 1;
+}
@@ -0,0 +1,678 @@
+/*
+ * codegen_x64.c - x86-64 Linux code generator for the PHYLOG compiler
+ *
+ * Lowers the quadruples to GNU as (Intel syntax) for x86-64 Linux. Values keep
+ * the 16-bit layout of the 8086 backend (one word per INTEGER/CHAR, arrays of
+ * words) and are computed in 32-bit registers, sign-extended on load and
+ * truncated on store, so programs print the same results on both targets.
+ * LIRE and AFFICHER call a small runtime emitted into the same file, which
+ * uses Linux system calls directly: no libc, no external runtime to link.
+ */
+
+#include <stdarg.h>
+#include "../include/codegen_x64.h"
+#include "../include/symboltable.h"
+#include "../include/quadgen.h"
+#include "../include/irbin.h"
+#include "../include/strpool.h"
+
+// Output file handle
+static FILE* output_file = NULL;
+
+// Input quadruples: a mapped binary IR file, or the quadruplet generator for CSV input
+static IrBinFile* input_ir = NULL;
+
+// Display strings (msgN is message number N) and which of them are displayed
+static StrPool* messages = NULL;
+static char* message_used = NULL;
+static int message_used_capacity = 0;
+
+// Set once the unsupported FLOAT/STRING warning has been given
+static int value_warning_given = 0;
+
+// Emit an instruction or directive line
+static void emit(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(output_file, "    ");
+    vfprintf(output_file, format, args);
+    fprintf(output_file, "\n");
+    va_end(args);
+}
+
+// Emit a label definition
+static void emit_label(const char* name) {
+    fprintf(output_file, "%s:\n", name);
+}
+
+// Emit a comment line
+static void emit_comment(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    fprintf(output_file, "    # ");
+    vfprintf(output_file, format, args);
+    fprintf(output_file, "\n");
+    va_end(args);
+}
+
+// Number of input quadruples
+static int input_quad_count(void) {
+    return input_ir ? (int)input_ir->header->quad_count : quadgen_get_count();
+}
+
+// Fields of an input quadruple
+static void input_quad(int index, const char** op, const char** arg1, const char** arg2, const char** result) {
+    if (input_ir) {
+        const IrBinQuad* q = &input_ir->quads[index];
+        *op = irbin_quad_op(input_ir, q);
+        *arg1 = irbin_string(input_ir, q->arg1);
+        *arg2 = irbin_string(input_ir, q->arg2);
+        *result = irbin_string(input_ir, q->result);
+    } else {
+        Quadruplet* q = quadgen_get(index);
+        *op = q->op;
+        *arg1 = q->arg1;
+        *arg2 = q->arg2;
+        *result = q->result;
+    }
+}
+
+// Load the display messages numbered by the IR producer
+static void load_messages(void) {
+    messages = strpool_create();
+    if (input_ir) {
+        for (uint32_t i = 0; i < input_ir->header->message_count; i++) {
+            strpool_intern(messages, irbin_message(input_ir, i));
+        }
+    } else {
+        StrPool* source = quadgen_get_messages();
+        for (int i = 0; i < strpool_count(source); i++) {
+            strpool_intern(messages, strpool_get(source, i));
+        }
+    }
+}
+
+// Number of a display message, marking it as used by the program
+static int use_message(const char* text) {
+    int id = strpool_intern(messages, text);
+    if (id >= message_used_capacity) {
+        int capacity = message_used_capacity ? message_used_capacity : 64;
+        while (capacity <= id) capacity *= 2;
+        message_used = (char*)safe_realloc(message_used, capacity);
+        memset(message_used + message_used_capacity, 0, capacity - message_used_capacity);
+        message_used_capacity = capacity;
+    }
+    message_used[id] = 1;
+    return id;
+}
+
+// Check if an operand is an immediate (number or character literal)
+static int is_immediate(const char* value) {
+    return (value[0] >= '0' && value[0] <= '9') || value[0] == '-' || value[0] == '\'';
+}
+
+// Check if an operand is an array element "A[i]"
+static int is_element(const char* value) {
+    return strchr(value, '[') && strchr(value, ']');
+}
+
+// Integer value of an immediate or of an integer/character constant (returns 0 if not known)
+static int immediate_value(const char* value, int* result) {
+    if (value[0] == '"' || (is_immediate(value) && strchr(value, '.'))) {
+        if (!value_warning_given) {
+            report_error(ERROR_LEVEL_WARNING, 0, 0,
+                         "FLOAT and STRING values are not supported by the x86-64 backend yet (%s)", value);
+            value_warning_given = 1;
+        }
+        *result = value[0] == '"' ? 0 : (int)(short)atoi(value);
+        return 1;
+    }
+    if (is_immediate(value)) {
+        *result = value[0] == '\'' ? (unsigned char)value[1] : (int)(short)atoi(value);
+        return 1;
+    }
+    SymbolNode* symbol = symboltable_lookup(value);
+    if (symbol && symbol->category == CATEGORY_CONSTANT && symbol->is_initialized) {
+        if (symbol->type == TYPE_INTEGER) {
+            *result = symbol->value.int_value;
+            return 1;
+        }
+        if (symbol->type == TYPE_CHAR) {
+            *result = (unsigned char)symbol->value.char_value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Split "A[i]" into the array name and the index operand
+static void split_element(const char* element, char* array_name, char* index) {
+    array_name[0] = index[0] = '\0';
+    sscanf(element, "%63[^[][%63[^]]", array_name, index);
+}
+
+// Sign-extend an index operand into RCX
+static void load_index_to_rcx(const char* index) {
+    int value;
+    if (immediate_value(index, &value)) {
+        emit("mov rcx, %d", value);
+    } else {
+        emit("movsx rcx, word ptr [rip + v_%s]", index);
+    }
+}
+
+// Load an operand, sign-extended, into a 32-bit register (RCX is used for indexes)
+static void load_value(const char* reg, const char* value) {
+    int immediate;
+    if (value[0] == '\0') {
+        emit("xor %s, %s", reg, reg);
+    } else if (immediate_value(value, &immediate)) {
+        emit("mov %s, %d", reg, immediate);
+    } else if (is_element(value)) {
+        char array_name[64], index[64];
+        split_element(value, array_name, index);
+        load_index_to_rcx(index);
+        emit("movsx %s, word ptr [v_%s + rcx*2]", reg, array_name);
+    } else {
+        emit("movsx %s, word ptr [rip + v_%s]", reg, value);
+    }
+}
+
+// Store the low word of EAX to a variable or array element
+static void store_result(const char* result) {
+    if (is_element(result)) {
+        char array_name[64], index[64];
+        split_element(result, array_name, index);
+        load_index_to_rcx(index);
+        emit("mov word ptr [v_%s + rcx*2], ax", array_name);
+    } else {
+        emit("mov word ptr [rip + v_%s], ax", result);
+    }
+}
+
+// Compare two operands (the left one ends up in EAX)
+static void emit_compare(const char* left, const char* right) {
+    int immediate;
+    load_value("eax", left);
+    if (immediate_value(right, &immediate)) {
+        emit("cmp eax, %d", immediate);
+    } else {
+        load_value("edx", right);
+        emit("cmp eax, edx");
+    }
+}
+
+// Load the element count of a block operation into RCX, skipping the
+// operation (to the local label 1) when there is nothing to do
+static void load_block_count(const char* count) {
+    load_value("ecx", count);
+    emit("movsxd rcx, ecx");
+    emit("test rcx, rcx");
+    emit("jle 1f");
+}
+
+// Point RDI or RSI at element [first] of an array after checking that the
+// ECX (= count) elements starting there lie inside it
+static void emit_block_address(const char* element, const char* reg) {
+    char array_name[64], index[64];
+    split_element(element, array_name, index);
+    SymbolNode* array = symboltable_lookup(array_name);
+    int size = array ? array->array_size : 0;
+
+    emit("push rcx");
+    load_index_to_rcx(index);
+    emit("mov rdx, rcx");
+    emit("pop rcx");
+    emit("test rdx, rdx");
+    emit("js phylog_range_error");
+    emit("lea r8, [rdx + rcx]");
+    emit("cmp r8, %d", size);
+    emit("jg phylog_range_error");
+    emit("lea %s, [v_%s + rdx*2]", reg, array_name);
+}
+
+// Lower a single quadruple
+static void process_quadruple(int id, const char* op, const char* arg1, const char* arg2, const char* result) {
+    static const struct { const char* op; const char* jump; } branches[] = {
+        { "BG", "jg" }, { "BGE", "jge" }, { "BL", "jl" },
+        { "BLE", "jle" }, { "BE", "je" }, { "BNE", "jne" }
+    };
+    int immediate;
+
+    fprintf(output_file, "\n");
+    emit_comment("Quad %d: %s %s %s %s", id, op, arg1, arg2, result);
+
+    for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++) {
+        if (strcmp(op, branches[i].op) == 0) {
+            emit_compare(arg2, result);
+            emit("%s .Lq_%s", branches[i].jump, arg1);
+            return;
+        }
+    }
+
+    if (strcmp(op, ":=") == 0) {
+        load_value("eax", arg1);
+        store_result(result);
+    }
+    else if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0) {
+        const char* mnemonic = op[0] == '+' ? "add" : op[0] == '-' ? "sub" : "imul";
+        load_value("eax", arg1);
+        if (immediate_value(arg2, &immediate) && op[0] != '*') {
+            emit("%s eax, %d", mnemonic, immediate);
+        } else if (immediate_value(arg2, &immediate)) {
+            emit("imul eax, eax, %d", immediate);
+        } else {
+            load_value("edx", arg2);
+            emit("%s eax, edx", mnemonic);
+        }
+        store_result(result);
+    }
+    else if (strcmp(op, "/") == 0 || strcmp(op, "%") == 0) {
+        // Quotient in EAX, remainder in EDX (both truncate toward zero like the 8086)
+        load_value("r9d", arg2);
+        load_value("eax", arg1);
+        emit("cdq");
+        emit("idiv r9d");
+        if (op[0] == '%') {
+            emit("mov eax, edx");
+        }
+        store_result(result);
+    }
+    else if (strcmp(op, "SAUT") == 0) {
+        // Unconditional jump (older IR kept the target in the result field)
+        emit("jmp .Lq_%s", arg1[0] != '\0' ? arg1 : result);
+    }
+    else if (strcmp(op, "ETIQ") == 0) {
+        fprintf(output_file, ".Lq_%s:\n", arg1);
+    }
+    else if (strcmp(op, "LIRE") == 0) {
+        // '&' reads a character, every other format an integer
+        emit("call %s", strchr(arg1, '&') ? "phylog_read_char" : "phylog_read_int");
+        store_result(result);
+    }
+    else if (strcmp(op, "AFFICHER") == 0) {
+        int has_value = arg2[0] != '\0';
+        if (has_value) {
+            load_value("edi", arg2);
+        } else {
+            emit("xor edi, edi");
+        }
+        emit("lea rsi, [rip + msg%d]", use_message(arg1));
+        emit("mov edx, %d", has_value);
+        emit("call phylog_display");
+    }
+    else if (strcmp(op, "BOUNDS") == 0 && strchr(arg1, '[')) {
+        // Access check "BOUNDS A[i] size": one unsigned compare catches i < 0 and i >= size
+        char array_name[64], index[64];
+        split_element(arg1, array_name, index);
+        load_index_to_rcx(index);
+        emit("cmp rcx, %s", arg2);
+        emit("jae phylog_range_error");
+        }
+    else if (strcmp(op, "BOUNDS") == 0 || strcmp(op, "ADEC") == 0) {
+        // Declarations only, checked at compile time
+    }
+    else if (strcmp(op, "AFILL") == 0) {
+        load_value("eax", arg1);
+        load_block_count(arg2);
+        emit_block_address(result, "rdi");
+        emit("rep stosw");
+        emit_label("1");
+    }
+    else if (strcmp(op, "ACOPY") == 0) {
+        load_block_count(arg2);
+        emit_block_address(arg1, "rsi");
+        emit_block_address(result, "rdi");
+        emit("rep movsw");
+        emit_label("1");
+    }
+    else {
+        emit_comment("Unsupported operation: %s", op);
+    }
+}
+
+// Emit a message as an .asciz string
+static void emit_message(int id, const char* text) {
+    fprintf(output_file, "msg%d: .asciz \"", id);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            fputc('\\', output_file);
+        }
+        fputc(*p, output_file);
+    }
+    fprintf(output_file, "\"\n");
+}
+
+// Emit the variables and the displayed messages
+static void emit_data(void) {
+    int symbol_count = symboltable_get_count();
+
+    fprintf(output_file, "\n    .data\n    .balign 2\n");
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        int value;
+        if (symbol && symbol->category == CATEGORY_CONSTANT) {
+            // Used as immediates; the slot is only read back after LIRE into it
+            fprintf(output_file, "v_%s: .short %d\n", symbol->name,
+                    immediate_value(symbol->name, &value) ? value : 0);
+        }
+    }
+
+    // A message ending another one is stored inside it
+    int count = strpool_count(messages);
+    if (count > 0) {
+        int* owner = (int*)safe_malloc(count * sizeof(int));
+        int* offset = (int*)safe_malloc(count * sizeof(int));
+        char* stored = (char*)safe_malloc(count);
+        strpool_share_suffixes(messages, owner, offset);
+
+        memset(stored, 0, count);
+        for (int i = 0; i < count && i < message_used_capacity; i++) {
+            if (message_used[i]) stored[owner[i]] = 1;
+        }
+        for (int i = 0; i < count; i++) {
+            if (stored[i]) {
+                emit_message(i, strpool_get(messages, i));
+            } else if (i < message_used_capacity && message_used[i]) {
+                emit(".set msg%d, msg%d + %d", i, owner[i], offset[i]);
+            }
+        }
+        free(owner);
+        free(offset);
+        free(stored);
+    }
+
+    fprintf(output_file, "\n    .bss\n    .balign 2\n");
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        if (!symbol) continue;
+        if (symbol->category == CATEGORY_VARIABLE || symbol->category == CATEGORY_TEMP) {
+            fprintf(output_file, "v_%s: .zero 2\n", symbol->name);
+        } else if (symbol->category == CATEGORY_ARRAY) {
+            fprintf(output_file, "v_%s: .zero %d\n", symbol->name, 2 * (symbol->array_size > 0 ? symbol->array_size : 1));
+        }
+    }
+}
+
+// Runtime: buffered output, integer parsing and formatting, program exit
+static const char* const runtime_text[] = {
+    "# Write the output buffer to stdout",
+    "phylog_flush:",
+    "    mov rdx, [rip + phylog_out_len]",
+    "    test rdx, rdx",
+    "    jz 1f",
+    "    mov eax, 1",
+    "    mov edi, 1",
+    "    lea rsi, [rip + phylog_out_buf]",
+    "    syscall",
+    "    mov qword ptr [rip + phylog_out_len], 0",
+    "1:  ret",
+    "",
+    "# Append the byte in DIL to the output buffer",
+    "phylog_putc:",
+    "    mov rax, [rip + phylog_out_len]",
+    "    lea rcx, [rip + phylog_out_buf]",
+    "    mov [rcx + rax], dil",
+    "    inc rax",
+    "    mov [rip + phylog_out_len], rax",
+    "    cmp rax, 4096",
+    "    je phylog_flush",
+    "    ret",
+    "",
+    "# Append the signed integer in EDI in decimal",
+    "phylog_put_int:",
+    "    push rbx",
+    "    push r12",
+    "    sub rsp, 24",
+    "    mov r12d, edi",
+    "    test r12d, r12d",
+    "    jns 1f",
+    "    mov edi, 45",
+    "    call phylog_putc",
+    "    neg r12d",
+    "1:  xor ebx, ebx",
+    "    mov eax, r12d",
+    "2:  xor edx, edx",
+    "    mov ecx, 10",
+    "    div ecx",
+    "    add dl, 48",
+    "    mov [rsp + rbx], dl",
+    "    inc ebx",
+    "    test eax, eax",
+    "    jnz 2b",
+    "3:  dec ebx",
+    "    movzx edi, byte ptr [rsp + rbx]",
+    "    call phylog_putc",
+    "    test ebx, ebx",
+    "    jnz 3b",
+    "    add rsp, 24",
+    "    pop r12",
+    "    pop rbx",
+    "    ret",
+    "",
+    "# Display the message at RSI and a line break; when EDX is set the value in",
+    "# EDI replaces the first format character ($ % # as a number, & as a",
+    "# character) or follows the message if it has none",
+    "phylog_display:",
+    "    push rbx",
+    "    push r12",
+    "    push r13",
+    "    mov rbx, rsi",
+    "    mov r12d, edi",
+    "    mov r13d, edx",
+    "1:  movzx edi, byte ptr [rbx]",
+    "    test edi, edi",
+    "    jz 4f",
+    "    inc rbx",
+    "    cmp edi, 36",
+    "    je 2f",
+    "    cmp edi, 37",
+    "    je 2f",
+    "    cmp edi, 35",
+    "    je 2f",
+    "    cmp edi, 38",
+    "    je 3f",
+    "    call phylog_putc",
+    "    jmp 1b",
+    "2:  test r13d, r13d",
+    "    jz 1b",
+    "    mov edi, r12d",
+    "    call phylog_put_int",
+    "    xor r13d, r13d",
+    "    jmp 1b",
+    "3:  test r13d, r13d",
+    "    jz 1b",
+    "    movzx edi, r12b",
+    "    call phylog_putc",
+    "    xor r13d, r13d",
+    "    jmp 1b",
+    "4:  test r13d, r13d",
+    "    jz 5f",
+    "    mov edi, r12d",
+    "    call phylog_put_int",
+    "5:  mov edi, 10",
+    "    call phylog_putc",
+    "    pop r13",
+    "    pop r12",
+    "    pop rbx",
+    "    ret",
+    "",
+    "# Next input byte in EAX (-1 at the end of the input); pending output is",
+    "# flushed before blocking so prompts appear",
+    "phylog_getc:",
+    "    mov rax, [rip + phylog_in_pos]",
+    "    cmp rax, [rip + phylog_in_len]",
+    "    jb 1f",
+    "    call phylog_flush",
+    "    xor eax, eax",
+    "    xor edi, edi",
+    "    lea rsi, [rip + phylog_in_buf]",
+    "    mov edx, 4096",
+    "    syscall",
+    "    test rax, rax",
+    "    jle 2f",
+    "    mov [rip + phylog_in_len], rax",
+    "    xor eax, eax",
+    "1:  lea rcx, [rip + phylog_in_buf]",
+    "    movzx edx, byte ptr [rcx + rax]",
+    "    inc rax",
+    "    mov [rip + phylog_in_pos], rax",
+    "    mov eax, edx",
+    "    ret",
+    "2:  mov qword ptr [rip + phylog_in_len], 0",
+    "    mov qword ptr [rip + phylog_in_pos], 0",
+    "    mov eax, -1",
+    "    ret",
+    "",
+    "# Skip blanks and line breaks; next input byte in EAX",
+    "phylog_skip_blanks:",
+    "    call phylog_getc",
+    "    cmp eax, 32",
+    "    je phylog_skip_blanks",
+    "    lea ecx, [rax - 9]",
+    "    cmp ecx, 4",
+    "    jbe phylog_skip_blanks",
+    "    ret",
+    "",
+    "# Read a signed decimal integer into EAX (0 if there is none)",
+    "phylog_read_int:",
+    "    push rbx",
+    "    push r12",
+    "    xor ebx, ebx",
+    "    xor r12d, r12d",
+    "    call phylog_skip_blanks",
+    "    cmp eax, 45",
+    "    jne 1f",
+    "    mov r12d, 1",
+    "    call phylog_getc",
+    "1:  lea ecx, [rax - 48]",
+    "    cmp ecx, 9",
+    "    ja 2f",
+    "    imul ebx, ebx, 10",
+    "    add ebx, ecx",
+    "    call phylog_getc",
+    "    jmp 1b",
+    "2:  mov eax, ebx",
+    "    test r12d, r12d",
+    "    jz 3f",
+    "    neg eax",
+    "3:  pop r12",
+    "    pop rbx",
+    "    ret",
+    "",
+    "# Read one non-blank character into EAX (0 at the end of the input)",
+    "phylog_read_char:",
+    "    call phylog_skip_blanks",
+    "    cmp eax, -1",
+    "    jne 1f",
+    "    xor eax, eax",
+    "1:  ret",
+    "",
+    "# Array access outside its bounds - stop with exit code 1",
+    "phylog_range_error:",
+    "    mov edi, 1",
+    "",
+    "# Flush the output and exit with the status in EDI",
+    "phylog_exit:",
+    "    push rdi",
+    "    call phylog_flush",
+    "    pop rdi",
+    "    mov eax, 60",
+    "    syscall",
+    "",
+    "    .bss",
+    "phylog_out_buf: .zero 4096",
+    "phylog_in_buf: .zero 4096",
+    "    .balign 8",
+    "phylog_out_len: .zero 8",
+    "phylog_in_pos: .zero 8",
+    "phylog_in_len: .zero 8",
+    NULL
+};
+
+// Main x86-64 code generation function
+int codegen_x64_generate(const char* quad_file, const char* asm_file) {
+    // Binary IR is mapped and read in place; CSV goes through the quadruplet reader
+    if (irbin_is_binary(quad_file)) {
+        input_ir = irbin_open(quad_file);
+        if (!input_ir) {
+            return 0;
+        }
+    } else if (!quadgen_read_from_file(quad_file)) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open quadruple file '%s'", quad_file);
+        return 0;
+    }
+
+    output_file = fopen(asm_file, "w");
+    if (!output_file) {
+        irbin_close(input_ir);
+        input_ir = NULL;
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open output file '%s'", asm_file);
+        return 0;
+    }
+
+    load_messages();
+    value_warning_given = 0;
+
+    fprintf(output_file, "# Generated by PHYLOG Compiler (x86-64 Linux)\n");
+    fprintf(output_file, "    .intel_syntax noprefix\n");
+    fprintf(output_file, "    .text\n");
+    fprintf(output_file, "    .globl _start\n");
+    emit_label("_start");
+    emit("cld");
+
+    int quad_count = input_quad_count();
+    const char *op, *arg1, *arg2, *result;
+    for (int i = 0; i < quad_count; i++) {
+        input_quad(i, &op, &arg1, &arg2, &result);
+        process_quadruple(i, op, arg1, arg2, result);
+    }
+
+    fprintf(output_file, "\n");
+    emit_comment("Program termination");
+    emit("xor edi, edi");
+    emit("jmp phylog_exit");
+    fprintf(output_file, "\n");
+    for (int i = 0; runtime_text[i]; i++) {
+        fprintf(output_file, "%s\n", runtime_text[i]);
+    }
+
+    emit_data();
+
+    irbin_close(input_ir);
+    input_ir = NULL;
+    fclose(output_file);
+    output_file = NULL;
+
+    strpool_destroy(messages);
+    messages = NULL;
+    free(message_used);
+    message_used = NULL;
+    message_used_capacity = 0;
+
+    printf("x86-64 assembly generated to '%s'\n", asm_file);
+    return 1;
+}
+
+// Assemble and link generated x86-64 assembly into a static ELF executable
+int codegen_x64_link(const char* asm_file, const char* exe_file) {
+    char object_file[512];
+    char command[1600];
+    snprintf(object_file, sizeof(object_file), "%s.o", exe_file);
+
+    snprintf(command, sizeof(command), "as --64 -o '%s' '%s'", object_file, asm_file);
+    if (system(command) != 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Assembler failed on '%s'", asm_file);
+        return 0;
+    }
+    snprintf(command, sizeof(command), "ld -static -o '%s' '%s'", exe_file, object_file);
+    int status = system(command);
+    remove(object_file);
+    if (status != 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Linker failed on '%s'", object_file);
+        return 0;
+    }
+
+    printf("x86-64 executable linked to '%s'\n", exe_file);
+    return 1;
+}
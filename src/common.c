@@ -3,6 +3,7 @@
  */
 
  #include "../include/common.h"
+ #include <ctype.h>
 
  // Report an error with file location
  void report_error(ErrorLevel level, int line, int column, const char* format, ...) {
@@ -108,8 +109,18 @@
      // Must have at least one digit or a dot
      if (!str[i]) return 0;
      
-     // All remaining characters must be digits or a single dot
+     // All remaining characters must be digits or a single dot, then an
+     // optional exponent (literals written back by format_float)
      for (; str[i]; i++) {
+         if ((str[i] == 'e' || str[i] == 'E') && i > 0 && isdigit((unsigned char)str[i - 1])) {
+             i++;
+             if (str[i] == '+' || str[i] == '-') i++;
+             if (!str[i]) return 0;
+             for (; str[i]; i++) {
+                 if (!isdigit((unsigned char)str[i])) return 0;
+             }
+             break;
+         }
          if (str[i] == '.') {
              if (seen_dot) return 0;  // Second dot found - not a valid float
              seen_dot = 1;
@@ -132,4 +143,26 @@
  float string_to_float(const char* str) {
      if (!str) return 0.0f;
      return atof(str);
+ }
+ 
+ // Write a float as the shortest literal that reads back to the same value
+ void format_float(char* buffer, size_t size, float value) {
+     // Fewest significant digits that round-trip (9 always do)
+     char digits[32];
+     for (int precision = 1; precision <= 9; precision++) {
+         snprintf(digits, sizeof(digits), "%.*g", precision, value);
+         if (strtof(digits, NULL) == value) {
+             break;
+         }
+     }
+     
+     // Keep a decimal point so that the text is still a float literal
+     char* exponent = strchr(digits, 'e');
+     if (strchr(digits, '.') || !isdigit((unsigned char)digits[strlen(digits) - 1])) {
+         snprintf(buffer, size, "%s", digits);  // Has one already, or inf/nan
+     } else if (exponent) {
+         snprintf(buffer, size, "%.*s.0%s", (int)(exponent - digits), digits, exponent);
+     } else {
+         snprintf(buffer, size, "%s.0", digits);
+     }
  }
\ No newline at end of file
@@ -0,0 +1,693 @@
+/*
+ * costmodel.c - Static 8086 cost model and performance report for generated code
+ *
+ * Cycle counts follow the 8086 instruction timing tables (execution clocks
+ * plus effective-address time for memory operands). Byte counts are an
+ * estimate of the encoded size. Both ignore prefetch-queue effects, so the
+ * numbers are meant for comparing code, not for predicting wall-clock time.
+ */
+
+#include "../include/costmodel.h"
+#include "../include/codegen.h"
+#include <ctype.h>
+
+// Assumed iteration count per loop level when weighting blocks
+#define ASSUMED_TRIP_COUNT 10
+
+// Assumed CX value for REP/shift-by-CL when it cannot be determined
+#define ASSUMED_REPEAT_COUNT 16
+
+// Maximum number of lines produced for one quadruple in a cost estimate
+#define MAX_QUAD_LINES 64
+
+// Operand classes used by the timing table
+typedef enum {
+    OPND_NONE,
+    OPND_REG16,
+    OPND_REG8,
+    OPND_SEG,
+    OPND_MEM,
+    OPND_IMM
+} OperandClass;
+
+// A classified operand
+typedef struct {
+    OperandClass cls;
+    int ea_cycles;     // Effective address calculation time (memory only)
+    int disp_bytes;    // Displacement bytes (memory only)
+    int imm_small;     // Immediate fits in a sign-extended byte
+    int is_acc;        // Operand is AX/AL
+} Operand86;
+
+// Basic block of the generated code
+typedef struct {
+    char name[32];     // First label of the block (or generated name)
+    int first_line;    // First stream line
+    int last_line;     // Last stream line
+    int instructions;
+    int cycles;
+    int bytes;
+    int depth;         // Loop nesting depth
+} CostBlock;
+
+// Loop found from a backward jump
+typedef struct {
+    char header[32];   // Header label
+    int first_block;
+    int last_block;
+    int depth;
+} CostLoop;
+
+// Source constructs used for the per-construct summary
+typedef enum {
+    CONSTRUCT_ASSIGNMENT,
+    CONSTRUCT_ARITHMETIC,
+    CONSTRUCT_ARRAY_LOAD,
+    CONSTRUCT_ARRAY_STORE,
+    CONSTRUCT_CONDITION,
+    CONSTRUCT_JUMP,
+    CONSTRUCT_IO,
+    CONSTRUCT_CONVERSION,
+    CONSTRUCT_OTHER,
+    CONSTRUCT_RUNTIME,
+    CONSTRUCT_COUNT
+} SourceConstruct;
+
+static const char* construct_names[CONSTRUCT_COUNT] = {
+    "Assignment", "Arithmetic", "Array load", "Array store", "Condition/branch",
+    "Jump", "I/O", "Type conversion", "Other", "Startup/runtime"
+};
+
+// Check if a string names a 16-bit general register
+static int is_reg16(const char* s) {
+    static const char* regs[] = { "ax", "bx", "cx", "dx", "si", "di", "sp", "bp", NULL };
+    for (int i = 0; regs[i]; i++) {
+        if (strcmp(s, regs[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+// Check if a string names an 8-bit register
+static int is_reg8(const char* s) {
+    static const char* regs[] = { "al", "bl", "cl", "dl", "ah", "bh", "ch", "dh", NULL };
+    for (int i = 0; regs[i]; i++) {
+        if (strcmp(s, regs[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+// Check if a string names a segment register
+static int is_segreg(const char* s) {
+    return strcmp(s, "ds") == 0 || strcmp(s, "es") == 0 ||
+           strcmp(s, "cs") == 0 || strcmp(s, "ss") == 0;
+}
+
+// Classify one operand string
+static Operand86 classify_operand(const char* text) {
+    Operand86 op = { OPND_NONE, 0, 0, 0, 0 };
+    char buf[128];
+
+    // Skip size and distance qualifiers
+    while (*text == ' ') text++;
+    const char* qualifiers[] = { "word ", "byte ", "dword ", "qword ", "short ", "near ", NULL };
+    for (int i = 0; qualifiers[i]; i++) {
+        size_t len = strlen(qualifiers[i]);
+        if (strncmp(text, qualifiers[i], len) == 0) {
+            text += len;
+            i = -1;  // Restart, several qualifiers may follow each other
+        }
+    }
+
+    snprintf(buf, sizeof(buf), "%s", text);
+    size_t len = strlen(buf);
+    while (len > 0 && buf[len - 1] == ' ') buf[--len] = '\0';
+
+    if (len == 0) {
+        return op;
+    }
+
+    if (strchr(buf, '[')) {
+        op.cls = OPND_MEM;
+        int has_base = strstr(buf, "bx") != NULL || strstr(buf, "bp") != NULL;
+        int has_index = strstr(buf, "si") != NULL || strstr(buf, "di") != NULL;
+
+        // Displacement: anything in the brackets other than the registers
+        int has_disp = 0;
+        char* p = strchr(buf, '[') + 1;
+        while (*p && *p != ']') {
+            if (isalnum((unsigned char)*p) || *p == '_') {
+                char word[64];
+                int n = 0;
+                while ((isalnum((unsigned char)*p) || *p == '_') && n < 63) word[n++] = *p++;
+                word[n] = '\0';
+                if (!is_reg16(word)) has_disp = 1;
+            } else {
+                p++;
+            }
+        }
+
+        if (has_base && has_index) {
+            op.ea_cycles = has_disp ? 12 : 8;
+        } else if (has_base || has_index) {
+            op.ea_cycles = has_disp ? 9 : 5;
+        } else {
+            op.ea_cycles = 6;  // Direct address
+        }
+        op.disp_bytes = has_disp || (!has_base && !has_index) ? 2 : 0;
+        return op;
+    }
+
+    if (is_reg16(buf)) {
+        op.cls = OPND_REG16;
+        op.is_acc = strcmp(buf, "ax") == 0;
+        return op;
+    }
+    if (is_reg8(buf)) {
+        op.cls = OPND_REG8;
+        op.is_acc = strcmp(buf, "al") == 0;
+        return op;
+    }
+    if (is_segreg(buf)) {
+        op.cls = OPND_SEG;
+        return op;
+    }
+
+    // Anything else is an immediate (number, character or address)
+    op.cls = OPND_IMM;
+    if (is_integer_literal(buf)) {
+        int value = atoi(buf);
+        op.imm_small = value >= -128 && value <= 127;
+    }
+    return op;
+}
+
+// Split "a, b" into its two operands (commas inside quotes or brackets do not count)
+static int split_operands(const char* operands, char* first, char* second, size_t size) {
+    int depth = 0, in_quote = 0;
+    const char* comma = NULL;
+
+    first[0] = second[0] = '\0';
+    for (const char* p = operands; *p; p++) {
+        if (*p == '\'') in_quote = !in_quote;
+        else if (!in_quote && *p == '[') depth++;
+        else if (!in_quote && *p == ']') depth--;
+        else if (!in_quote && depth == 0 && *p == ',') {
+            comma = p;
+            break;
+        }
+    }
+
+    if (!comma) {
+        snprintf(first, size, "%s", operands);
+        return first[0] ? 1 : 0;
+    }
+
+    size_t len = comma - operands;
+    if (len >= size) len = size - 1;
+    memcpy(first, operands, len);
+    first[len] = '\0';
+    snprintf(second, size, "%s", comma + 1);
+    return 2;
+}
+
+// Check if a mnemonic is one of the listed names
+static int mnemonic_in(const char* mnemonic, const char* const* names) {
+    for (int i = 0; names[i]; i++) {
+        if (strcmp(mnemonic, names[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+// Cost of an ALU instruction (add, sub, and, ...) with the given operands
+static CostEstimate alu_cost(Operand86 dst, Operand86 src, int is_compare) {
+    CostEstimate c = { 0, 0, 1 };
+
+    if (dst.cls == OPND_MEM) {
+        if (src.cls == OPND_IMM) {
+            c.cycles = (is_compare ? 10 : 17) + dst.ea_cycles;
+            c.bytes = 2 + dst.disp_bytes + (src.imm_small ? 1 : 2);
+        } else {
+            c.cycles = (is_compare ? 9 : 16) + dst.ea_cycles;
+            c.bytes = 2 + dst.disp_bytes;
+        }
+    } else if (src.cls == OPND_MEM) {
+        c.cycles = 9 + src.ea_cycles;
+        c.bytes = 2 + src.disp_bytes;
+    } else if (src.cls == OPND_IMM) {
+        c.cycles = 4;
+        if (dst.cls == OPND_REG8) c.bytes = dst.is_acc ? 2 : 3;
+        else if (src.imm_small) c.bytes = 3;
+        else c.bytes = dst.is_acc ? 3 : 4;
+    } else {
+        c.cycles = 3;
+        c.bytes = 2;
+    }
+    return c;
+}
+
+// Cost of an instruction, with an explicit repeat count for REP and shift-by-CL
+static CostEstimate instr_cost(const char* mnemonic, const char* operands, int repeat) {
+    static const char* const alu_ops[] = { "add", "sub", "and", "or", "xor", "adc", "sbb", NULL };
+    static const char* const shift_ops[] = { "shl", "sal", "shr", "sar", "rol", "ror", "rcl", "rcr", NULL };
+    static const char* const jcc_ops[] = { "je", "jne", "jz", "jnz", "jg", "jge", "jl", "jle",
+                                           "ja", "jae", "jb", "jbe", "jc", "jnc", "js", "jns",
+                                           "jo", "jno", "jp", "jnp", NULL };
+    static const char* const flag_ops[] = { "cld", "std", "clc", "stc", "cmc", "cli", "sti", NULL };
+
+    char first[128], second[128];
+    split_operands(operands, first, second, sizeof(first));
+    Operand86 dst = classify_operand(first);
+    Operand86 src = classify_operand(second);
+    CostEstimate c = { 4, 2, 1 };
+
+    if (strcmp(mnemonic, "mov") == 0) {
+        if (dst.cls == OPND_MEM) {
+            c.cycles = (src.cls == OPND_IMM ? 10 : 9) + dst.ea_cycles;
+            c.bytes = 2 + dst.disp_bytes + (src.cls == OPND_IMM ? 2 : 0);
+            if (src.is_acc && dst.disp_bytes == 2 && dst.ea_cycles == 6) c.bytes = 3;
+        } else if (src.cls == OPND_MEM) {
+            c.cycles = 8 + src.ea_cycles;
+            c.bytes = 2 + src.disp_bytes;
+            if (dst.is_acc && src.disp_bytes == 2 && src.ea_cycles == 6) c.bytes = 3;
+        } else if (src.cls == OPND_IMM) {
+            c.cycles = 4;
+            c.bytes = dst.cls == OPND_REG8 ? 2 : 3;
+        } else {
+            c.cycles = 2;
+            c.bytes = 2;
+        }
+    } else if (mnemonic_in(mnemonic, alu_ops)) {
+        c = alu_cost(dst, src, 0);
+    } else if (strcmp(mnemonic, "cmp") == 0 || strcmp(mnemonic, "test") == 0) {
+        c = alu_cost(dst, src, 1);
+    } else if (strcmp(mnemonic, "inc") == 0 || strcmp(mnemonic, "dec") == 0) {
+        if (dst.cls == OPND_MEM) { c.cycles = 15 + dst.ea_cycles; c.bytes = 2 + dst.disp_bytes; }
+        else if (dst.cls == OPND_REG8) { c.cycles = 3; c.bytes = 2; }
+        else { c.cycles = 2; c.bytes = 1; }
+    } else if (strcmp(mnemonic, "neg") == 0 || strcmp(mnemonic, "not") == 0) {
+        if (dst.cls == OPND_MEM) { c.cycles = 16 + dst.ea_cycles; c.bytes = 2 + dst.disp_bytes; }
+        else { c.cycles = 3; c.bytes = 2; }
+    } else if (mnemonic_in(mnemonic, shift_ops)) {
+        int by_cl = strcmp(second, " cl") == 0 || strcmp(second, "cl") == 0;
+        if (dst.cls == OPND_MEM) {
+            c.cycles = (by_cl ? 20 + 4 * repeat : 15) + dst.ea_cycles;
+            c.bytes = 2 + dst.disp_bytes;
+        } else {
+            c.cycles = by_cl ? 8 + 4 * repeat : 2;
+            c.bytes = 2;
+        }
+    } else if (strcmp(mnemonic, "imul") == 0 || strcmp(mnemonic, "mul") == 0) {
+        int is_signed = mnemonic[0] == 'i';
+        if (dst.cls == OPND_REG8) c.cycles = is_signed ? 89 : 73;
+        else c.cycles = is_signed ? 141 : 124;
+        c.bytes = 2;
+        if (dst.cls == OPND_MEM) { c.cycles += 6 + dst.ea_cycles; c.bytes += dst.disp_bytes; }
+    } else if (strcmp(mnemonic, "idiv") == 0 || strcmp(mnemonic, "div") == 0) {
+        int is_signed = mnemonic[0] == 'i';
+        if (dst.cls == OPND_REG8) c.cycles = is_signed ? 107 : 85;
+        else c.cycles = is_signed ? 175 : 153;
+        c.bytes = 2;
+        if (dst.cls == OPND_MEM) { c.cycles += 6 + dst.ea_cycles; c.bytes += dst.disp_bytes; }
+    } else if (strcmp(mnemonic, "cwd") == 0) {
+        c.cycles = 5; c.bytes = 1;
+    } else if (strcmp(mnemonic, "cbw") == 0) {
+        c.cycles = 2; c.bytes = 1;
+    } else if (strcmp(mnemonic, "jmp") == 0) {
+        c.cycles = 15;
+        c.bytes = strncmp(operands, "short", 5) == 0 ? 2 : 3;
+    } else if (mnemonic_in(mnemonic, jcc_ops)) {
+        c.cycles = 10;  // Average of taken (16) and not taken (4)
+        c.bytes = 2;
+    } else if (strcmp(mnemonic, "loop") == 0) {
+        c.cycles = 17; c.bytes = 2;
+    } else if (strcmp(mnemonic, "jcxz") == 0) {
+        c.cycles = 18; c.bytes = 2;
+    } else if (strcmp(mnemonic, "call") == 0) {
+        c.cycles = 19; c.bytes = 3;
+    } else if (strcmp(mnemonic, "ret") == 0) {
+        c.cycles = 8; c.bytes = 1;
+    } else if (strcmp(mnemonic, "push") == 0) {
+        if (dst.cls == OPND_MEM) { c.cycles = 16 + dst.ea_cycles; c.bytes = 2 + dst.disp_bytes; }
+        else { c.cycles = dst.cls == OPND_SEG ? 10 : 11; c.bytes = 1; }
+    } else if (strcmp(mnemonic, "pop") == 0) {
+        if (dst.cls == OPND_MEM) { c.cycles = 17 + dst.ea_cycles; c.bytes = 2 + dst.disp_bytes; }
+        else { c.cycles = 8; c.bytes = 1; }
+    } else if (strcmp(mnemonic, "lea") == 0) {
+        c.cycles = 2 + src.ea_cycles;
+        c.bytes = 2 + src.disp_bytes;
+    } else if (strcmp(mnemonic, "int") == 0) {
+        c.cycles = 51; c.bytes = 2;
+    } else if (strcmp(mnemonic, "xchg") == 0) {
+        c.cycles = (dst.is_acc || src.is_acc) ? 3 : 4;
+        c.bytes = (dst.is_acc || src.is_acc) ? 1 : 2;
+    } else if (mnemonic_in(mnemonic, flag_ops)) {
+        c.cycles = 2; c.bytes = 1;
+    } else if (strcmp(mnemonic, "sahf") == 0 || strcmp(mnemonic, "lahf") == 0) {
+        c.cycles = 4; c.bytes = 1;
+    } else if (strcmp(mnemonic, "nop") == 0) {
+        c.cycles = 3; c.bytes = 1;
+    } else if (strcmp(mnemonic, "stosw") == 0 || strcmp(mnemonic, "stosb") == 0) {
+        c.cycles = 11; c.bytes = 1;
+    } else if (strcmp(mnemonic, "movsw") == 0 || strcmp(mnemonic, "movsb") == 0) {
+        c.cycles = 18; c.bytes = 1;
+    } else if (strcmp(mnemonic, "rep") == 0) {
+        // REP prefix: operands hold the string instruction
+        int per_item = strncmp(operands, "movs", 4) == 0 ? 17 : 10;
+        c.cycles = 9 + per_item * repeat;
+        c.bytes = 2;
+    } else if (mnemonic[0] == 'f') {
+        // 8087 instructions (coprocessor execution clocks)
+        static const struct { const char* name; int cycles; } x87[] = {
+            { "fld", 43 }, { "fst", 84 }, { "fstp", 86 }, { "fild", 50 }, { "fist", 84 },
+            { "fistp", 88 }, { "fadd", 105 }, { "fsub", 105 }, { "fsubr", 105 },
+            { "fmul", 118 }, { "fdiv", 220 }, { "fdivr", 220 }, { "fcom", 65 },
+            { "fcomp", 68 }, { "fcompp", 50 }, { "ftst", 42 }, { "fstsw", 15 },
+            { "fnstsw", 15 }, { "fldcw", 10 }, { "fstcw", 15 }, { "fnstcw", 15 },
+            { "fwait", 4 }, { "fld1", 18 }, { "fldz", 14 }, { "fchs", 12 },
+            { "fabs", 14 }, { "fxch", 12 }, { "finit", 5 }, { "fninit", 5 }, { NULL, 0 }
+        };
+        c.cycles = 50;
+        for (int i = 0; x87[i].name; i++) {
+            if (strcmp(mnemonic, x87[i].name) == 0) {
+                c.cycles = x87[i].cycles;
+                break;
+            }
+        }
+        c.bytes = 2 + dst.disp_bytes;
+        if (dst.cls == OPND_MEM) c.cycles += dst.ea_cycles;
+    }
+
+    return c;
+}
+
+// Estimate the cost of a single 8086 instruction
+CostEstimate costmodel_instr_cost(const char* mnemonic, const char* operands) {
+    return instr_cost(mnemonic, operands ? operands : "", ASSUMED_REPEAT_COUNT);
+}
+
+// Estimate the cost of a single 8086 instruction with a known REP / shift-by-CL count
+CostEstimate costmodel_instr_cost_repeat(const char* mnemonic, const char* operands, int repeat) {
+    return instr_cost(mnemonic, operands ? operands : "", repeat);
+}
+
+// Estimate the cost of the code generated for a quadruple
+CostEstimate costmodel_quad_cost(const Quadruplet* q) {
+    CostEstimate total = { 0, 0, 0 };
+    AsmLine lines[MAX_QUAD_LINES];
+
+    int count = codegen_lower_quad(q, lines, MAX_QUAD_LINES);
+    for (int i = 0; i < count; i++) {
+        if (lines[i].kind != ASM_LINE_INSTR) continue;
+        CostEstimate c = costmodel_instr_cost(lines[i].mnemonic, lines[i].operands);
+        total.cycles += c.cycles;
+        total.bytes += c.bytes;
+        total.instructions++;
+    }
+    return total;
+}
+
+// Check if an instruction transfers control (ends a basic block)
+static int ends_block(const char* mnemonic) {
+    return mnemonic[0] == 'j' || strcmp(mnemonic, "ret") == 0 || strcmp(mnemonic, "loop") == 0;
+}
+
+// Get the branch target of a jump instruction (NULL if none)
+static const char* jump_target(const AsmLine* line) {
+    if (line->mnemonic[0] != 'j' && strcmp(line->mnemonic, "loop") != 0) {
+        return NULL;
+    }
+    const char* target = line->operands;
+    if (strncmp(target, "short ", 6) == 0) target += 6;
+    if (strncmp(target, "near ", 5) == 0) target += 5;
+    return target;
+}
+
+// Classify the quadruple named in a "Quad N: op a b c" comment
+static SourceConstruct classify_quad_comment(const char* comment) {
+    int id;
+    char op[32] = {0};
+
+    if (sscanf(comment, "Quad %d: %31s", &id, op) != 2) {
+        return CONSTRUCT_OTHER;
+    }
+
+    if (strcmp(op, ":=") == 0) {
+        // "Quad N: := arg1 arg2 result" - find which side holds the array access
+        char args[96];
+        snprintf(args, sizeof(args), "%s", strstr(comment, ":=") + 2);
+        size_t len = strlen(args);
+        while (len > 0 && args[len - 1] == ' ') args[--len] = '\0';
+        const char* bracket = strchr(args, '[');
+        if (!bracket) return CONSTRUCT_ASSIGNMENT;
+        const char* last_space = strrchr(args, ' ');
+        return (last_space && bracket > last_space) ? CONSTRUCT_ARRAY_STORE : CONSTRUCT_ARRAY_LOAD;
+    }
+    if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0 || strcmp(op, "*") == 0 ||
+        strcmp(op, "/") == 0 || strcmp(op, "%") == 0) {
+        return CONSTRUCT_ARITHMETIC;
+    }
+    if (strcmp(op, "AFILL") == 0 || strcmp(op, "ACOPY") == 0) return CONSTRUCT_ARRAY_STORE;
+    if (op[0] == 'B' && strcmp(op, "BOUNDS") != 0) return CONSTRUCT_CONDITION;
+    if (strcmp(op, "SAUT") == 0) return CONSTRUCT_JUMP;
+    if (strcmp(op, "LIRE") == 0 || strcmp(op, "AFFICHER") == 0) return CONSTRUCT_IO;
+    if (strcmp(op, "CONVERT") == 0) return CONSTRUCT_CONVERSION;
+    return CONSTRUCT_OTHER;
+}
+
+// Weight of a block at the given loop depth
+static long depth_weight(int depth) {
+    long weight = 1;
+    for (int i = 0; i < depth; i++) weight *= ASSUMED_TRIP_COUNT;
+    return weight;
+}
+
+// Write the per-block / per-loop / per-construct report for the last generated code
+int costmodel_write_report(const char* report_file) {
+    int line_count = codegen_get_line_count();
+    if (line_count == 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "No generated code to analyze");
+        return 0;
+    }
+
+    // Find the start of the code section
+    int text_start = 0;
+    for (int i = 0; i < line_count; i++) {
+        const AsmLine* line = codegen_get_line(i);
+        if (line->kind == ASM_LINE_SECTION && strcmp(line->mnemonic, ".text") == 0) {
+            text_start = i + 1;
+            break;
+        }
+    }
+
+    // Build basic blocks
+    int block_capacity = 64;
+    int block_count = 0;
+    CostBlock* blocks = (CostBlock*)safe_malloc(block_capacity * sizeof(CostBlock));
+    int* line_block = (int*)safe_malloc(line_count * sizeof(int));
+    int need_new_block = 1;
+
+    SourceConstruct construct = CONSTRUCT_RUNTIME;
+    long construct_cycles[CONSTRUCT_COUNT] = {0};
+    int construct_bytes[CONSTRUCT_COUNT] = {0};
+    int construct_instrs[CONSTRUCT_COUNT] = {0};
+    int construct_quads[CONSTRUCT_COUNT] = {0};
+    int known_cx = -1;
+
+    for (int i = 0; i < line_count; i++) {
+        line_block[i] = -1;
+    }
+
+    for (int i = text_start; i < line_count; i++) {
+        const AsmLine* line = codegen_get_line(i);
+
+        // Track the construct of the current quadruple
+        if (line->kind == ASM_LINE_COMMENT) {
+            if (line->quad_id >= 0 && strncmp(line->comment, "Quad ", 5) == 0) {
+                construct = classify_quad_comment(line->comment);
+                construct_quads[construct]++;
+            } else if (line->quad_id < 0) {
+                construct = CONSTRUCT_RUNTIME;
+            }
+            continue;
+        }
+
+        if (line->kind == ASM_LINE_LABEL) {
+            // A label starts a new block unless the current one is still empty
+            if (block_count == 0 || blocks[block_count - 1].instructions > 0) {
+                need_new_block = 1;
+            } else if (blocks[block_count - 1].name[0] == 'B') {
+                snprintf(blocks[block_count - 1].name, sizeof(blocks[0].name), "%s", line->mnemonic);
+            }
+            if (!need_new_block) {
+                line_block[i] = block_count - 1;
+                continue;
+            }
+        }
+
+        if (line->kind != ASM_LINE_LABEL && line->kind != ASM_LINE_INSTR) {
+            continue;
+        }
+
+        if (need_new_block) {
+            if (block_count >= block_capacity) {
+                block_capacity *= 2;
+                blocks = (CostBlock*)safe_realloc(blocks, block_capacity * sizeof(CostBlock));
+            }
+            CostBlock* b = &blocks[block_count++];
+            memset(b, 0, sizeof(CostBlock));
+            if (line->kind == ASM_LINE_LABEL) {
+                snprintf(b->name, sizeof(b->name), "%s", line->mnemonic);
+            } else {
+                snprintf(b->name, sizeof(b->name), "B%d", block_count - 1);
+            }
+            b->first_line = i;
+            need_new_block = 0;
+            known_cx = -1;
+        }
+
+        CostBlock* b = &blocks[block_count - 1];
+        line_block[i] = block_count - 1;
+        b->last_line = i;
+
+        if (line->kind == ASM_LINE_INSTR) {
+            int repeat = known_cx > 0 ? known_cx : ASSUMED_REPEAT_COUNT;
+            if (strcmp(line->mnemonic, "shl") == 0 || strcmp(line->mnemonic, "sal") == 0 ||
+                strcmp(line->mnemonic, "sar") == 0 || strcmp(line->mnemonic, "shr") == 0) {
+                repeat = known_cx > 0 ? (known_cx & 0xFF) : 4;
+            }
+            CostEstimate c = instr_cost(line->mnemonic, line->operands, repeat);
+            b->instructions++;
+            b->cycles += c.cycles;
+            b->bytes += c.bytes;
+            construct_cycles[construct] += c.cycles;
+            construct_bytes[construct] += c.bytes;
+            construct_instrs[construct]++;
+
+            // Track CX/CL loaded with an immediate for REP and shift costs
+            if (strcmp(line->mnemonic, "mov") == 0 &&
+                (strncmp(line->operands, "cx,", 3) == 0 || strncmp(line->operands, "cl,", 3) == 0)) {
+                const char* value = line->operands + 3;
+                while (*value == ' ') value++;
+                known_cx = is_integer_literal(value) ? atoi(value) : -1;
+            }
+
+            if (ends_block(line->mnemonic)) {
+                need_new_block = 1;
+            }
+        }
+    }
+
+    // Find loops: a jump back to a label at or before the jump
+    int loop_capacity = 16;
+    int loop_count = 0;
+    CostLoop* loops = (CostLoop*)safe_malloc(loop_capacity * sizeof(CostLoop));
+
+    for (int i = text_start; i < line_count; i++) {
+        const AsmLine* line = codegen_get_line(i);
+        if (line->kind != ASM_LINE_INSTR || line_block[i] < 0) continue;
+
+        const char* target = jump_target(line);
+        if (!target || target[0] == '\0') continue;
+
+        for (int j = text_start; j <= i; j++) {
+            const AsmLine* label = codegen_get_line(j);
+            if (label->kind == ASM_LINE_LABEL && strcmp(label->mnemonic, target) == 0 && line_block[j] >= 0) {
+                if (loop_count >= loop_capacity) {
+                    loop_capacity *= 2;
+                    loops = (CostLoop*)safe_realloc(loops, loop_capacity * sizeof(CostLoop));
+                }
+                CostLoop* loop = &loops[loop_count++];
+                snprintf(loop->header, sizeof(loop->header), "%s", target);
+                loop->first_block = line_block[j];
+                loop->last_block = line_block[i];
+                loop->depth = 0;
+                break;
+            }
+        }
+    }
+
+    // Loop nesting: a block's depth is the number of loops containing it
+    for (int b = 0; b < block_count; b++) {
+        for (int l = 0; l < loop_count; l++) {
+            if (b >= loops[l].first_block && b <= loops[l].last_block) {
+                blocks[b].depth++;
+            }
+        }
+    }
+    for (int l = 0; l < loop_count; l++) {
+        for (int k = 0; k < loop_count; k++) {
+            if (loops[k].first_block <= loops[l].first_block &&
+                loops[k].last_block >= loops[l].last_block) {
+                loops[l].depth++;
+            }
+        }
+    }
+
+    FILE* file = fopen(report_file, "w");
+    if (!file) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open cost report file '%s'", report_file);
+        free(blocks);
+        free(line_block);
+        free(loops);
+        return 0;
+    }
+
+    // Totals
+    long total_cycles = 0, weighted_total = 0;
+    int total_bytes = 0, total_instrs = 0;
+    for (int b = 0; b < block_count; b++) {
+        total_cycles += blocks[b].cycles;
+        total_bytes += blocks[b].bytes;
+        total_instrs += blocks[b].instructions;
+        weighted_total += blocks[b].cycles * depth_weight(blocks[b].depth);
+    }
+
+    fprintf(file, "PHYLOG static cost report (8086 timing model)\n");
+    fprintf(file, "==============================================\n");
+    fprintf(file, "Instructions: %d\n", total_instrs);
+    fprintf(file, "Code size:    %d bytes (estimated)\n", total_bytes);
+    fprintf(file, "Cycles:       %ld (each instruction once)\n", total_cycles);
+    fprintf(file, "Weighted:     %ld (x%d per loop level)\n\n", weighted_total, ASSUMED_TRIP_COUNT);
+
+    fprintf(file, "Basic blocks\n");
+    fprintf(file, "%-12s %6s %6s %7s %6s %12s\n", "Block", "Instrs", "Bytes", "Cycles", "Depth", "Weighted");
+    fprintf(file, "------------------------------------------------------\n");
+    for (int b = 0; b < block_count; b++) {
+        fprintf(file, "%-12s %6d %6d %7d %6d %12ld\n",
+                blocks[b].name, blocks[b].instructions, blocks[b].bytes, blocks[b].cycles,
+                blocks[b].depth, blocks[b].cycles * depth_weight(blocks[b].depth));
+    }
+
+    fprintf(file, "\nLoops\n");
+    fprintf(file, "%-12s %6s %6s %6s %15s\n", "Header", "Depth", "Blocks", "Bytes", "Cycles/iter");
+    fprintf(file, "------------------------------------------------------\n");
+    if (loop_count == 0) {
+        fprintf(file, "(none)\n");
+    }
+    for (int l = 0; l < loop_count; l++) {
+        int bytes = 0, cycles = 0;
+        for (int b = loops[l].first_block; b <= loops[l].last_block; b++) {
+            bytes += blocks[b].bytes;
+            cycles += blocks[b].cycles;
+        }
+        fprintf(file, "%-12s %6d %6d %6d %15d\n", loops[l].header, loops[l].depth,
+                loops[l].last_block - loops[l].first_block + 1, bytes, cycles);
+    }
+
+    fprintf(file, "\nSource constructs\n");
+    fprintf(file, "%-18s %6s %6s %6s %8s\n", "Construct", "Quads", "Instrs", "Bytes", "Cycles");
+    fprintf(file, "------------------------------------------------------\n");
+    for (int k = 0; k < CONSTRUCT_COUNT; k++) {
+        if (construct_instrs[k] == 0 && construct_quads[k] == 0) continue;
+        fprintf(file, "%-18s %6d %6d %6d %8ld\n", construct_names[k], construct_quads[k],
+                construct_instrs[k], construct_bytes[k], construct_cycles[k]);
+    }
+
+    fclose(file);
+    free(blocks);
+    free(line_block);
+    free(loops);
+
+    printf("Cost report written to %s\n", report_file);
+    return 1;
+}
@@ -0,0 +1,382 @@
+/*
+ * irbin.c - Binary IR container for the PHYLOG compiler
+ *
+ * The container is built in memory while walking the quadruples once and is
+ * written with a single sequence of fwrite calls. Loading maps the file and
+ * points straight into it, so no field is parsed.
+ */
+
+#include "../include/irbin.h"
+#include "../include/symboltable.h"
+#include "../include/strpool.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#define MAX_OPCODES 256
+#define POOL_HASH_SIZE 1024
+
+// String pool being built for a write
+typedef struct {
+    char* data;
+    uint32_t size;
+    uint32_t capacity;
+    uint32_t* slots;           // Open-addressing table of offsets (0 = empty)
+    uint32_t slot_count;
+    uint32_t used;
+} StringPool;
+
+// Round a size up to a multiple of 4
+static uint32_t align4(uint32_t n) {
+    return (n + 3u) & ~3u;
+}
+
+// FNV-1a hash of a string
+static uint32_t hash_string(const char* s) {
+    uint32_t h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void pool_init(StringPool* pool) {
+    pool->capacity = 4096;
+    pool->data = (char*)safe_malloc(pool->capacity);
+    pool->data[0] = '\0';
+    pool->size = 1;
+    pool->slot_count = POOL_HASH_SIZE;
+    pool->slots = (uint32_t*)calloc(pool->slot_count, sizeof(uint32_t));
+    if (!pool->slots) {
+        report_error(ERROR_LEVEL_FATAL, 0, 0, "Memory allocation failed");
+    }
+    pool->used = 0;
+}
+
+static void pool_free(StringPool* pool) {
+    free(pool->data);
+    free(pool->slots);
+}
+
+// Double the hash table and reinsert all strings
+static void pool_grow_slots(StringPool* pool) {
+    uint32_t old_count = pool->slot_count;
+    uint32_t* old_slots = pool->slots;
+
+    pool->slot_count = old_count * 2;
+    pool->slots = (uint32_t*)calloc(pool->slot_count, sizeof(uint32_t));
+    if (!pool->slots) {
+        report_error(ERROR_LEVEL_FATAL, 0, 0, "Memory allocation failed");
+    }
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (old_slots[i] == 0) continue;
+        uint32_t h = hash_string(pool->data + old_slots[i]) & (pool->slot_count - 1);
+        while (pool->slots[h] != 0) h = (h + 1) & (pool->slot_count - 1);
+        pool->slots[h] = old_slots[i];
+    }
+    free(old_slots);
+}
+
+// Intern a string and return its pool offset
+static uint32_t pool_intern(StringPool* pool, const char* s) {
+    if (!s || s[0] == '\0') {
+        return 0;
+    }
+
+    uint32_t h = hash_string(s) & (pool->slot_count - 1);
+    while (pool->slots[h] != 0) {
+        if (strcmp(pool->data + pool->slots[h], s) == 0) {
+            return pool->slots[h];
+        }
+        h = (h + 1) & (pool->slot_count - 1);
+    }
+
+    uint32_t len = (uint32_t)strlen(s) + 1;
+    while (pool->size + len > pool->capacity) {
+        pool->capacity *= 2;
+        pool->data = (char*)safe_realloc(pool->data, pool->capacity);
+    }
+    uint32_t offset = pool->size;
+    memcpy(pool->data + offset, s, len);
+    pool->size += len;
+
+    pool->slots[h] = offset;
+    if (++pool->used * 2 > pool->slot_count) {
+        pool_grow_slots(pool);
+    }
+    return offset;
+}
+
+// Check if a file starts with the binary IR magic
+int irbin_is_binary(const char* filename) {
+    char magic[4];
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return 0;
+    }
+    size_t n = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+    return n == sizeof(magic) && memcmp(magic, IRBIN_MAGIC, sizeof(magic)) == 0;
+}
+
+// Write the current quadruples and symbol table to a binary IR file
+int irbin_write(const char* filename) {
+    int quad_count = quadgen_get_count();
+    int symbol_count = symboltable_get_count();
+
+    StringPool pool;
+    pool_init(&pool);
+
+    uint32_t opcodes[MAX_OPCODES];
+    const char* opcode_names[MAX_OPCODES];
+    uint32_t opcode_count = 0;
+
+    IrBinQuad* quads = (IrBinQuad*)safe_malloc((quad_count + 1) * sizeof(IrBinQuad));
+    IrBinSymbol* symbols = (IrBinSymbol*)safe_malloc((symbol_count + 1) * sizeof(IrBinSymbol));
+
+    StrPool* message_pool = quadgen_get_messages();
+    uint32_t message_count = (uint32_t)strpool_count(message_pool);
+    uint32_t* messages = (uint32_t*)safe_malloc((message_count + 1) * sizeof(uint32_t));
+
+    // Single walk over the quadruples: opcodes and operands
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = quadgen_get(i);
+        IrBinQuad* rec = &quads[i];
+
+        uint32_t op = 0;
+        while (op < opcode_count && strcmp(opcode_names[op], q->op) != 0) op++;
+        if (op == opcode_count) {
+            if (opcode_count >= MAX_OPCODES) {
+                report_error(ERROR_LEVEL_ERROR, 0, 0, "Too many distinct operators for binary IR");
+                free(quads);
+                        free(symbols);
+                free(messages);
+                pool_free(&pool);
+                return 0;
+            }
+            opcode_names[opcode_count] = q->op;
+            opcodes[opcode_count++] = pool_intern(&pool, q->op);
+        }
+
+        rec->opcode = (uint16_t)op;
+        rec->reserved = 0;
+        rec->arg1 = pool_intern(&pool, q->arg1);
+        rec->arg2 = pool_intern(&pool, q->arg2);
+        rec->result = pool_intern(&pool, q->result);
+    }
+
+    // Display messages, in pool order so their numbers are kept
+    for (uint32_t i = 0; i < message_count; i++) {
+        messages[i] = pool_intern(&pool, strpool_get(message_pool, (int)i));
+    }
+
+    // Symbol table
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* node = symboltable_get_by_index(i);
+        IrBinSymbol* rec = &symbols[i];
+
+        memset(rec, 0, sizeof(IrBinSymbol));
+        rec->name = pool_intern(&pool, node->name);
+        rec->category = (uint8_t)node->category;
+        rec->type = (uint8_t)node->type;
+        rec->is_initialized = (uint8_t)node->is_initialized;
+        switch (node->type) {
+            case TYPE_FLOAT:
+                memcpy(&rec->value, &node->value.float_value, sizeof(float));
+                break;
+            case TYPE_CHAR:
+                rec->value = (unsigned char)node->value.char_value;
+                break;
+            case TYPE_STRING:
+                rec->string_value = node->is_initialized ? pool_intern(&pool, node->value.string_value) : 0;
+                break;
+            default:
+                rec->value = (uint32_t)node->value.int_value;
+                break;
+        }
+        rec->array_size = node->array_size;
+        rec->array_lower_bound = node->array_lower_bound;
+        rec->line = node->line;
+        rec->column = node->column;
+    }
+
+    // Section layout
+    IrBinHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IRBIN_MAGIC, 4);
+    header.version = IRBIN_VERSION;
+    header.header_size = sizeof(IrBinHeader);
+    header.byte_order = IRBIN_BYTE_ORDER;
+    header.opcode_count = opcode_count;
+    header.opcode_offset = align4(sizeof(IrBinHeader));
+    header.quad_count = (uint32_t)quad_count;
+    header.quad_offset = header.opcode_offset + opcode_count * sizeof(uint32_t);
+    header.symbol_count = (uint32_t)symbol_count;
+    header.symbol_offset = header.quad_offset + quad_count * sizeof(IrBinQuad);
+    header.message_count = message_count;
+    header.message_offset = header.symbol_offset + symbol_count * sizeof(IrBinSymbol);
+    header.pool_size = pool.size;
+    header.pool_offset = header.message_offset + message_count * sizeof(uint32_t);
+    header.file_size = align4(header.pool_offset + pool.size);
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open file for writing: %s", filename);
+        free(quads);
+        free(symbols);
+        free(messages);
+        pool_free(&pool);
+        return 0;
+    }
+
+    static const char padding[4] = {0};
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(padding, 1, header.opcode_offset - sizeof(header), file);
+    fwrite(opcodes, sizeof(uint32_t), opcode_count, file);
+    fwrite(quads, sizeof(IrBinQuad), quad_count, file);
+    fwrite(symbols, sizeof(IrBinSymbol), symbol_count, file);
+    fwrite(messages, sizeof(uint32_t), message_count, file);
+    fwrite(pool.data, 1, pool.size, file);
+    fwrite(padding, 1, header.file_size - (header.pool_offset + pool.size), file);
+
+    int ok = !ferror(file);
+    fclose(file);
+    if (!ok) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Failed to write binary IR file: %s", filename);
+    }
+
+    free(quads);
+    free(symbols);
+    free(messages);
+    pool_free(&pool);
+    return ok;
+}
+
+// Check that a section lies inside the file
+static int section_fits(size_t file_size, uint32_t offset, uint32_t count, size_t record_size) {
+    if (offset % 4 != 0 || offset > file_size) {
+        return 0;
+    }
+    return (uint64_t)count * record_size <= file_size - offset;
+}
+
+// Map a binary IR file read-only (returns NULL if invalid)
+IrBinFile* irbin_open(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open file for reading: %s", filename);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(IrBinHeader)) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Invalid binary IR file: %s", filename);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* base = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot map binary IR file: %s", filename);
+        return NULL;
+    }
+
+    const IrBinHeader* header = (const IrBinHeader*)base;
+    const char* error = NULL;
+    if (memcmp(header->magic, IRBIN_MAGIC, 4) != 0) {
+        error = "bad magic";
+    } else if (header->version != IRBIN_VERSION) {
+        error = "unsupported version";
+    } else if (header->byte_order != IRBIN_BYTE_ORDER) {
+        error = "byte order mismatch";
+    } else if (header->header_size != sizeof(IrBinHeader) || header->file_size != size) {
+        error = "size mismatch";
+    } else if (!section_fits(size, header->opcode_offset, header->opcode_count, sizeof(uint32_t)) ||
+               !section_fits(size, header->quad_offset, header->quad_count, sizeof(IrBinQuad)) ||
+               !section_fits(size, header->symbol_offset, header->symbol_count, sizeof(IrBinSymbol)) ||
+               !section_fits(size, header->message_offset, header->message_count, sizeof(uint32_t)) ||
+               !section_fits(size, header->pool_offset, header->pool_size, 1) ||
+               header->pool_size == 0) {
+        error = "section out of range";
+    } else if (((const char*)base)[header->pool_offset + header->pool_size - 1] != '\0') {
+        error = "unterminated string pool";
+    }
+
+    if (error) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Invalid binary IR file %s: %s", filename, error);
+        munmap(base, size);
+        return NULL;
+    }
+
+    IrBinFile* ir = (IrBinFile*)safe_malloc(sizeof(IrBinFile));
+    ir->base = base;
+    ir->size = size;
+    ir->header = header;
+    ir->opcodes = (const uint32_t*)((const char*)base + header->opcode_offset);
+    ir->quads = (const IrBinQuad*)((const char*)base + header->quad_offset);
+    ir->symbols = (const IrBinSymbol*)((const char*)base + header->symbol_offset);
+    ir->messages = (const uint32_t*)((const char*)base + header->message_offset);
+    ir->pool = (const char*)base + header->pool_offset;
+    return ir;
+}
+
+// Get a string from the pool ("" for invalid offsets)
+const char* irbin_string(const IrBinFile* ir, uint32_t offset) {
+    if (offset >= ir->header->pool_size) {
+        return "";
+    }
+    return ir->pool + offset;
+}
+
+// Get the operator name of a quadruple record
+const char* irbin_quad_op(const IrBinFile* ir, const IrBinQuad* q) {
+    if (q->opcode >= ir->header->opcode_count) {
+        return "";
+    }
+    return irbin_string(ir, ir->opcodes[q->opcode]);
+}
+
+// Get display message number i ("" if out of range)
+const char* irbin_message(const IrBinFile* ir, uint32_t index) {
+    if (index >= ir->header->message_count) {
+        return "";
+    }
+    return irbin_string(ir, ir->messages[index]);
+}
+
+// Copy the quadruples of a binary IR file into the quadruplet generator
+int irbin_load_quads(const char* filename) {
+    IrBinFile* ir = irbin_open(filename);
+    if (!ir) {
+        return 0;
+    }
+
+    quadgen_init();
+    for (uint32_t i = 0; i < ir->header->message_count; i++) {
+        strpool_intern(quadgen_get_messages(), irbin_message(ir, i));
+    }
+    for (uint32_t i = 0; i < ir->header->quad_count; i++) {
+        const IrBinQuad* q = &ir->quads[i];
+        if (quadgen_generate(irbin_quad_op(ir, q), irbin_string(ir, q->arg1),
+                             irbin_string(ir, q->arg2), irbin_string(ir, q->result)) < 0) {
+            irbin_close(ir);
+            return 0;
+        }
+    }
+
+    irbin_close(ir);
+    return 1;
+}
+
+// Unmap a binary IR file
+void irbin_close(IrBinFile* ir) {
+    if (!ir) {
+        return;
+    }
+    munmap(ir->base, ir->size);
+    free(ir);
+}
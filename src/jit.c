@@ -0,0 +1,665 @@
+/*
+ * jit.c - In-process x86-64 execution of the quadruples for the PHYLOG compiler
+ *
+ * The quadruples are lowered the same way as by the x86-64 backend
+ * (codegen_x64.c), but encoded straight to machine code: 16-bit words in a
+ * data block addressed through R15, values computed in 32-bit registers.
+ * The code is built in a writable buffer, then mapped read/execute and
+ * called as a function; READ and DISPLAY call back into the host. When a
+ * profile is requested, each basic block starts by incrementing its counter
+ * and the counts are written out after the run (see profile.c).
+ */
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "../include/jit.h"
+#include "../include/symboltable.h"
+#include "../include/quadgen.h"
+#include "../include/strpool.h"
+#include "../include/profile.h"
+
+// Register numbers as encoded in ModRM/REX
+enum {
+    RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+    R8 = 8, R9 = 9, R15 = 15
+};
+
+// Condition codes (low nibble of Jcc)
+enum {
+    CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_S = 0x8,
+    CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF
+};
+
+// Machine code being built
+static uint8_t* code = NULL;
+static size_t code_size = 0;
+static size_t code_capacity = 0;
+
+// Labels: IR labels and internal targets, by number
+static StrPool* label_names = NULL;
+static long* label_offsets = NULL;       // -1 until defined
+static int label_capacity = 0;
+static int anonymous_labels = 0;
+
+// Jumps waiting for their target (rel32 at 'position')
+typedef struct {
+    size_t position;
+    int label;
+} Fixup;
+static Fixup* fixups = NULL;
+static int fixup_count = 0;
+static int fixup_capacity = 0;
+
+// Data block: one word per scalar, array_size words per array
+static StrPool* slot_names = NULL;
+static int* slot_offsets = NULL;
+static int slot_capacity = 0;
+static int data_size = 0;
+
+// Set once the unsupported FLOAT/STRING warning has been given
+static int value_warning_given = 0;
+
+// Block execution profile written after the run (NULL: not profiling)
+static const char* profile_file = NULL;
+
+// Append one byte
+static void emit_byte(int byte) {
+    if (code_size >= code_capacity) {
+        code_capacity = code_capacity ? code_capacity * 2 : 4096;
+        code = (uint8_t*)safe_realloc(code, code_capacity);
+    }
+    code[code_size++] = (uint8_t)byte;
+}
+
+// Append a little-endian 32-bit value
+static void emit_u32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        emit_byte((value >> (8 * i)) & 0xFF);
+    }
+}
+
+// Append a little-endian 64-bit value
+static void emit_u64(uint64_t value) {
+    emit_u32((uint32_t)value);
+    emit_u32((uint32_t)(value >> 32));
+}
+
+// Append opcode bytes
+static void emit_opcode(const char* opcode, int length) {
+    for (int i = 0; i < length; i++) {
+        emit_byte((unsigned char)opcode[i]);
+    }
+}
+
+// REX prefix for the given operand width and registers (left out when empty)
+static void emit_rex(int wide, int reg, int index, int base) {
+    int rex = 0x40 | (wide << 3) | ((reg & 8) >> 1) | ((index & 8) >> 2) | ((base & 8) >> 3);
+    if (rex != 0x40) {
+        emit_byte(rex);
+    }
+}
+
+// Instruction with a register and the memory operand [base + index*scale + disp32]
+// (index < 0: no index)
+static void emit_mem(int word, int wide, const char* opcode, int length,
+                     int reg, int base, int index, int scale, int32_t disp) {
+    if (word) {
+        emit_byte(0x66);
+    }
+    emit_rex(wide, reg, index < 0 ? 0 : index, base);
+    emit_opcode(opcode, length);
+    if (index < 0 && (base & 7) != RSP) {
+        emit_byte(0x80 | ((reg & 7) << 3) | (base & 7));
+    } else {
+        int ss = scale == 8 ? 3 : scale == 4 ? 2 : scale == 2 ? 1 : 0;
+        emit_byte(0x80 | ((reg & 7) << 3) | RSP);
+        emit_byte((ss << 6) | (((index < 0 ? RSP : index) & 7) << 3) | (base & 7));
+    }
+    emit_u32((uint32_t)disp);
+}
+
+// Instruction with two register operands (ModRM reg and rm fields)
+static void emit_regs(int wide, const char* opcode, int length, int reg, int rm) {
+    emit_rex(wide, reg, 0, rm);
+    emit_opcode(opcode, length);
+    emit_byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// Group-1 operation with a 32-bit immediate (digit: 0 add, 5 sub, 7 cmp)
+static void emit_group1_imm(int wide, int digit, int rm, int32_t imm) {
+    emit_rex(wide, 0, 0, rm);
+    emit_byte(0x81);
+    emit_byte(0xC0 | (digit << 3) | (rm & 7));
+    emit_u32((uint32_t)imm);
+}
+
+// mov r32, imm32 (or the sign-extended mov r64, imm32)
+static void emit_mov_imm(int wide, int reg, int32_t imm) {
+    if (wide) {
+        emit_rex(1, 0, 0, reg);
+        emit_byte(0xC7);
+        emit_byte(0xC0 | (reg & 7));
+    } else {
+        emit_rex(0, 0, 0, reg);
+        emit_byte(0xB8 + (reg & 7));
+    }
+    emit_u32((uint32_t)imm);
+}
+
+// Number of a label, creating it when needed
+static int label_number(const char* name) {
+    int id = strpool_intern(label_names, name);
+    if (id >= label_capacity) {
+        int capacity = label_capacity ? label_capacity * 2 : 64;
+        while (capacity <= id) capacity *= 2;
+        label_offsets = (long*)safe_realloc(label_offsets, capacity * sizeof(long));
+        for (int i = label_capacity; i < capacity; i++) label_offsets[i] = -1;
+        label_capacity = capacity;
+    }
+    return id;
+}
+
+// A label only the JIT jumps to ('$' cannot appear in IR labels)
+static int new_label(void) {
+    char name[32];
+    snprintf(name, sizeof(name), "$%d", anonymous_labels++);
+    return label_number(name);
+}
+
+// Define a label at the current position
+static void place_label(int label) {
+    label_offsets[label] = (long)code_size;
+}
+
+// Jump (cc < 0: unconditional) to a label, resolved once all code is built
+static void emit_jump(int cc, int label) {
+    if (cc < 0) {
+        emit_byte(0xE9);
+    } else {
+        emit_byte(0x0F);
+        emit_byte(0x80 | cc);
+    }
+    if (fixup_count >= fixup_capacity) {
+        fixup_capacity = fixup_capacity ? fixup_capacity * 2 : 256;
+        fixups = (Fixup*)safe_realloc(fixups, fixup_capacity * sizeof(Fixup));
+    }
+    fixups[fixup_count].position = code_size;
+    fixups[fixup_count].label = label;
+    fixup_count++;
+    emit_u32(0);
+}
+
+// Call a host function
+static void emit_call(void* function) {
+    emit_byte(0x48);
+    emit_byte(0xB8);                          // mov rax, imm64
+    emit_u64((uint64_t)(uintptr_t)function);
+    emit_byte(0xFF);
+    emit_byte(0xD0);                          // call rax
+}
+
+// Count one execution of a block: mov rax, counter; inc qword [rax]
+static void emit_block_counter(long* counter) {
+    emit_byte(0x48);
+    emit_byte(0xB8);
+    emit_u64((uint64_t)(uintptr_t)counter);
+    emit_byte(0x48);
+    emit_byte(0xFF);
+    emit_byte(0x00);
+}
+
+// Offset of a variable in the data block (words are added for unknown names)
+static int slot_offset(const char* name, int words) {
+    int id = strpool_intern(slot_names, name);
+    if (id >= slot_capacity) {
+        int capacity = slot_capacity ? slot_capacity * 2 : 64;
+        while (capacity <= id) capacity *= 2;
+        slot_offsets = (int*)safe_realloc(slot_offsets, capacity * sizeof(int));
+        for (int i = slot_capacity; i < capacity; i++) slot_offsets[i] = -1;
+        slot_capacity = capacity;
+    }
+    if (slot_offsets[id] < 0) {
+        slot_offsets[id] = data_size;
+        data_size += 2 * (words > 0 ? words : 1);
+    }
+    return slot_offsets[id];
+}
+
+// Check if an operand is an immediate (number or character literal)
+static int is_immediate(const char* value) {
+    return (value[0] >= '0' && value[0] <= '9') || value[0] == '-' || value[0] == '\'';
+}
+
+// Check if an operand is an array element "A[i]"
+static int is_element(const char* value) {
+    return strchr(value, '[') && strchr(value, ']');
+}
+
+// Integer value of an immediate or of an integer/character constant (returns 0 if not known)
+static int immediate_value(const char* value, int* result) {
+    if (value[0] == '"' || (is_immediate(value) && strchr(value, '.'))) {
+        if (!value_warning_given) {
+            report_error(ERROR_LEVEL_WARNING, 0, 0,
+                         "FLOAT and STRING values are not supported by the JIT yet (%s)", value);
+            value_warning_given = 1;
+        }
+        *result = value[0] == '"' ? 0 : (int)(short)atoi(value);
+        return 1;
+    }
+    if (is_immediate(value)) {
+        *result = value[0] == '\'' ? (unsigned char)value[1] : (int)(short)atoi(value);
+        return 1;
+    }
+    SymbolNode* symbol = symboltable_lookup(value);
+    if (symbol && symbol->category == CATEGORY_CONSTANT && symbol->is_initialized) {
+        if (symbol->type == TYPE_INTEGER) {
+            *result = symbol->value.int_value;
+            return 1;
+        }
+        if (symbol->type == TYPE_CHAR) {
+            *result = (unsigned char)symbol->value.char_value;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Split "A[i]" into the array name and the index operand
+static void split_element(const char* element, char* array_name, char* index) {
+    array_name[0] = index[0] = '\0';
+    sscanf(element, "%63[^[][%63[^]]", array_name, index);
+}
+
+// Sign-extend an index operand into RCX
+static void load_index_to_rcx(const char* index) {
+    int value;
+    if (immediate_value(index, &value)) {
+        emit_mov_imm(1, RCX, value);
+    } else {
+        emit_mem(0, 1, "\x0F\xBF", 2, RCX, R15, -1, 1, slot_offset(index, 1));   // movsx rcx, word
+    }
+}
+
+// Load an operand, sign-extended, into a 32-bit register (RCX is used for indexes)
+static void load_value(int reg, const char* value) {
+    int immediate;
+    if (value[0] == '\0') {
+        emit_regs(0, "\x31", 1, reg, reg);                                       // xor reg, reg
+    } else if (immediate_value(value, &immediate)) {
+        emit_mov_imm(0, reg, immediate);
+    } else if (is_element(value)) {
+        char array_name[64], index[64];
+        split_element(value, array_name, index);
+        load_index_to_rcx(index);
+        emit_mem(0, 0, "\x0F\xBF", 2, reg, R15, RCX, 2, slot_offset(array_name, 1));
+    } else {
+        emit_mem(0, 0, "\x0F\xBF", 2, reg, R15, -1, 1, slot_offset(value, 1));
+    }
+}
+
+// Store the low word of EAX to a variable or array element
+static void store_result(const char* result) {
+    if (is_element(result)) {
+        char array_name[64], index[64];
+        split_element(result, array_name, index);
+        load_index_to_rcx(index);
+        emit_mem(1, 0, "\x89", 1, RAX, R15, RCX, 2, slot_offset(array_name, 1));
+    } else {
+        emit_mem(1, 0, "\x89", 1, RAX, R15, -1, 1, slot_offset(result, 1));
+    }
+}
+
+// Compare two operands (the left one ends up in EAX)
+static void emit_compare(const char* left, const char* right) {
+    int immediate;
+    load_value(RAX, left);
+    if (immediate_value(right, &immediate)) {
+        emit_group1_imm(0, 7, RAX, immediate);
+    } else {
+        load_value(RDX, right);
+        emit_regs(0, "\x39", 1, RDX, RAX);                                        // cmp eax, edx
+    }
+}
+
+// Point RDI or RSI at element [first] of an array after checking that the
+// R8 (= count) elements starting there lie inside it
+static void emit_block_address(const char* element, int reg, int error_label) {
+    char array_name[64], index[64];
+    split_element(element, array_name, index);
+    SymbolNode* array = symboltable_lookup(array_name);
+    int size = array ? array->array_size : 0;
+
+    load_index_to_rcx(index);
+    emit_regs(1, "\x85", 1, RCX, RCX);                                            // test rcx, rcx
+    emit_jump(CC_S, error_label);
+    emit_mem(0, 1, "\x8D", 1, RDX, RCX, R8, 1, 0);                                // lea rdx, [rcx + r8]
+    emit_group1_imm(1, 7, RDX, size);
+    emit_jump(CC_G, error_label);
+    emit_mem(0, 1, "\x8D", 1, reg, R15, RCX, 2, slot_offset(array_name, size));   // lea reg, [element]
+}
+
+// Load the element count of a block operation into R8; returns the label
+// jumped to when there is nothing to do
+static int load_block_count(const char* count) {
+    int skip = new_label();
+    load_value(R8, count);
+    emit_regs(1, "\x63", 1, R8, R8);                                              // movsxd r8, r8d
+    emit_regs(1, "\x85", 1, R8, R8);                                              // test r8, r8
+    emit_jump(CC_LE, skip);
+    return skip;
+}
+
+// Host side of READ: a signed decimal integer (0 if there is none)
+static int host_read_int(void) {
+    int c, value = 0, negative = 0;
+    fflush(stdout);
+    do c = getchar(); while (c == ' ' || (c >= '\t' && c <= '\r'));
+    if (c == '-') {
+        negative = 1;
+        c = getchar();
+    }
+    while (c >= '0' && c <= '9') {
+        value = value * 10 + (c - '0');
+        c = getchar();
+    }
+    return negative ? -value : value;
+}
+
+// Host side of READ with '&': one non-blank character (0 at the end of the input)
+static int host_read_char(void) {
+    int c;
+    fflush(stdout);
+    do c = getchar(); while (c == ' ' || (c >= '\t' && c <= '\r'));
+    return c == EOF ? 0 : c;
+}
+
+// Host side of DISPLAY: the value replaces the first format character
+// ($ % # as a number, & as a character) or follows a message without one
+static void host_display(int value, int message, int has_value) {
+    const char* p = strpool_get(quadgen_get_messages(), message);
+    for (; *p; p++) {
+        if (*p == '$' || *p == '%' || *p == '#' || *p == '&') {
+            if (has_value) {
+                if (*p == '&') putchar(value & 0xFF);
+                else printf("%d", value);
+                has_value = 0;
+            }
+        } else {
+            putchar(*p);
+        }
+    }
+    if (has_value) {
+        printf("%d", value);
+    }
+    putchar('\n');
+}
+
+// Lower a single quadruple
+static void compile_quadruple(const Quadruplet* q, int error_label) {
+    static const struct { const char* op; int cc; } branches[] = {
+        { "BG", CC_G }, { "BGE", CC_GE }, { "BL", CC_L },
+        { "BLE", CC_LE }, { "BE", CC_E }, { "BNE", CC_NE }
+    };
+    const char* op = q->op;
+    int immediate;
+
+    for (size_t i = 0; i < sizeof(branches) / sizeof(branches[0]); i++) {
+        if (strcmp(op, branches[i].op) == 0) {
+            emit_compare(q->arg2, q->result);
+            emit_jump(branches[i].cc, label_number(q->arg1));
+            return;
+        }
+    }
+
+    if (strcmp(op, ":=") == 0) {
+        load_value(RAX, q->arg1);
+        store_result(q->result);
+    }
+    else if (strcmp(op, "+") == 0 || strcmp(op, "-") == 0) {
+        load_value(RAX, q->arg1);
+        if (immediate_value(q->arg2, &immediate)) {
+            emit_group1_imm(0, op[0] == '+' ? 0 : 5, RAX, immediate);
+        } else {
+            load_value(RDX, q->arg2);
+            emit_regs(0, op[0] == '+' ? "\x01" : "\x29", 1, RDX, RAX);           // add/sub eax, edx
+        }
+        store_result(q->result);
+    }
+    else if (strcmp(op, "*") == 0) {
+        load_value(RAX, q->arg1);
+        if (immediate_value(q->arg2, &immediate)) {
+            emit_regs(0, "\x69", 1, RAX, RAX);                                   // imul eax, eax, imm32
+            emit_u32((uint32_t)immediate);
+        } else {
+            load_value(RDX, q->arg2);
+            emit_regs(0, "\x0F\xAF", 2, RAX, RDX);                               // imul eax, edx
+        }
+        store_result(q->result);
+    }
+    else if (strcmp(op, "/") == 0 || strcmp(op, "%") == 0) {
+        // Quotient in EAX, remainder in EDX (both truncate toward zero like the 8086)
+        load_value(R9, q->arg2);
+        load_value(RAX, q->arg1);
+        emit_byte(0x99);                                                         // cdq
+        emit_regs(0, "\xF7", 1, 7, R9);                                          // idiv r9d
+        if (op[0] == '%') {
+            emit_regs(0, "\x89", 1, RDX, RAX);                                   // mov eax, edx
+        }
+        store_result(q->result);
+    }
+    else if (strcmp(op, "SAUT") == 0) {
+        // Unconditional jump (older IR kept the target in the result field)
+        emit_jump(-1, label_number(q->arg1[0] != '\0' ? q->arg1 : q->result));
+    }
+    else if (strcmp(op, "ETIQ") == 0) {
+        place_label(label_number(q->arg1));
+    }
+    else if (strcmp(op, "LIRE") == 0) {
+        // '&' reads a character, every other format an integer
+        emit_call(strchr(q->arg1, '&') ? (void*)host_read_char : (void*)host_read_int);
+        store_result(q->result);
+    }
+    else if (strcmp(op, "AFFICHER") == 0) {
+        int has_value = q->arg2[0] != '\0';
+        if (has_value) {
+            load_value(RDI, q->arg2);
+        } else {
+            emit_regs(0, "\x31", 1, RDI, RDI);
+        }
+        emit_mov_imm(0, RSI, strpool_intern(quadgen_get_messages(), q->arg1));
+        emit_mov_imm(0, RDX, has_value);
+        emit_call((void*)host_display);
+    }
+    else if (strcmp(op, "BOUNDS") == 0 && strchr(q->arg1, '[')) {
+        // Access check "BOUNDS A[i] size": one unsigned compare catches i < 0 and i >= size
+        char array_name[64], index[64];
+        split_element(q->arg1, array_name, index);
+        load_index_to_rcx(index);
+        emit_group1_imm(1, 7, RCX, atoi(q->arg2));
+        emit_jump(CC_AE, error_label);
+    }
+    else if (strcmp(op, "AFILL") == 0) {
+        load_value(RAX, q->arg1);
+        int skip = load_block_count(q->arg2);
+        emit_block_address(q->result, RDI, error_label);
+        emit_regs(1, "\x89", 1, R8, RCX);                                        // mov rcx, r8
+        emit_opcode("\xF3\x66\xAB", 3);                                          // rep stosw
+        place_label(skip);
+    }
+    else if (strcmp(op, "ACOPY") == 0) {
+        int skip = load_block_count(q->arg2);
+        emit_block_address(q->arg1, RSI, error_label);
+        emit_block_address(q->result, RDI, error_label);
+        emit_regs(1, "\x89", 1, R8, RCX);                                        // mov rcx, r8
+        emit_opcode("\xF3\x66\xA5", 3);                                          // rep movsw
+        place_label(skip);
+    }
+    // BOUNDS declarations, ADEC and unknown operations produce no code
+}
+
+// Milliseconds between two clock readings
+static double elapsed_ms(const struct timespec* start, const struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * 1000.0 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Release the compilation state
+static void jit_reset(void) {
+    free(code);
+    code = NULL;
+    code_size = code_capacity = 0;
+    strpool_destroy(label_names);
+    label_names = NULL;
+    free(label_offsets);
+    label_offsets = NULL;
+    label_capacity = 0;
+    anonymous_labels = 0;
+    free(fixups);
+    fixups = NULL;
+    fixup_count = fixup_capacity = 0;
+    strpool_destroy(slot_names);
+    slot_names = NULL;
+    free(slot_offsets);
+    slot_offsets = NULL;
+    slot_capacity = 0;
+    data_size = 0;
+}
+
+// Compile the quadruples to machine code and run them in this process
+int jit_run(void) {
+    struct timespec start, compiled, finished;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    label_names = strpool_create();
+    slot_names = strpool_create();
+    value_warning_given = 0;
+
+    // Data block layout: declared scalars and arrays first
+    int symbol_count = symboltable_get_count();
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        if (symbol) {
+            slot_offset(symbol->name, symbol->category == CATEGORY_ARRAY ? symbol->array_size : 1);
+        }
+    }
+
+    // Prologue: R15 holds the data block (RDI), keeping the stack 16-byte aligned for calls
+    int error_label = new_label();
+    emit_byte(0x41);
+    emit_byte(0x57);                                 // push r15
+    emit_regs(1, "\x89", 1, RDI, R15);               // mov r15, rdi
+
+    // Block counters: after the label of a block that starts with one, so jumps count too
+    int quad_count = quadgen_get_count();
+    int* block_of_quad = NULL;
+    long* block_counts = NULL;
+    int block_count = 0;
+    if (profile_file) {
+        block_of_quad = (int*)safe_malloc((quad_count + 1) * sizeof(int));
+        block_count = profile_find_blocks(block_of_quad);
+        block_counts = (long*)calloc(block_count + 1, sizeof(long));
+        if (!block_counts) {
+            report_error(ERROR_LEVEL_FATAL, 0, 0, "Memory allocation failed");
+        }
+    }
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = quadgen_get(i);
+        int block_start = block_counts && (i == 0 || block_of_quad[i] != block_of_quad[i - 1]);
+        int labelled = strcmp(q->op, "ETIQ") == 0;
+        if (block_start && !labelled) {
+            emit_block_counter(&block_counts[block_of_quad[i]]);
+        }
+        compile_quadruple(q, error_label);
+        if (block_start && labelled) {
+            emit_block_counter(&block_counts[block_of_quad[i]]);
+        }
+    }
+    free(block_of_quad);
+
+    // Epilogue: status 0, or 1 after a range error
+    emit_regs(0, "\x31", 1, RAX, RAX);               // xor eax, eax
+    emit_byte(0x41);
+    emit_byte(0x5F);                                 // pop r15
+    emit_byte(0xC3);                                 // ret
+    place_label(error_label);
+    emit_mov_imm(0, RAX, 1);
+    emit_byte(0x41);
+    emit_byte(0x5F);
+    emit_byte(0xC3);
+
+    // Resolve jumps
+    for (int i = 0; i < fixup_count; i++) {
+        long target = label_offsets[fixups[i].label];
+        if (target < 0) {
+            report_error(ERROR_LEVEL_ERROR, 0, 0, "JIT: jump to undefined label %s",
+                         strpool_get(label_names, fixups[i].label));
+            free(block_counts);
+            jit_reset();
+            return -1;
+        }
+        int32_t rel = (int32_t)(target - (long)(fixups[i].position + 4));
+        memcpy(code + fixups[i].position, &rel, sizeof(rel));
+    }
+
+    // Map the code: written while writable, then made executable (never both)
+    size_t map_size = (code_size + 4095) & ~(size_t)4095;
+    void* text = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (text == MAP_FAILED) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "JIT: cannot map executable memory");
+        free(block_counts);
+        jit_reset();
+        return -1;
+    }
+    memcpy(text, code, code_size);
+    if (mprotect(text, map_size, PROT_READ | PROT_EXEC) != 0) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "JIT: cannot make the code executable");
+        munmap(text, map_size);
+        free(block_counts);
+        jit_reset();
+        return -1;
+    }
+
+    // Data block with the constants' values (read back only after READ into one)
+    int16_t* data = (int16_t*)calloc(data_size / 2 + 1, sizeof(int16_t));
+    if (!data) {
+        report_error(ERROR_LEVEL_FATAL, 0, 0, "Memory allocation failed");
+    }
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        int value;
+        if (symbol && symbol->category == CATEGORY_CONSTANT && immediate_value(symbol->name, &value)) {
+            data[slot_offset(symbol->name, 1) / 2] = (int16_t)value;
+        }
+    }
+
+    int (*entry)(int16_t*);
+    void* entry_address = text;
+    memcpy(&entry, &entry_address, sizeof(entry));
+    size_t bytes = code_size;
+    jit_reset();
+
+    clock_gettime(CLOCK_MONOTONIC, &compiled);
+    int status = entry(data);
+    fflush(stdout);
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+
+    munmap(text, map_size);
+    free(data);
+
+    printf("JIT: %d quadruples compiled to %zu bytes of x86-64 code in %.3f ms\n",
+           quad_count, bytes, elapsed_ms(&start, &compiled));
+    printf("JIT: program ran in %.3f ms (exit status %d)\n", elapsed_ms(&compiled, &finished), status);
+    
+    if (block_counts) {
+        if (profile_write(profile_file, block_counts, block_count)) {
+            printf("JIT: execution counts of %d blocks written to %s\n", block_count, profile_file);
+        }
+        free(block_counts);
+    }
+    return status;
+}
+
+// Record basic block execution counts in a profile file on the next run
+void jit_set_profile(const char* filename) {
+    profile_file = filename;
+}
@@ -12,6 +12,14 @@
  #include "../include/parser.h"
  #include "../include/optimizer.h"
  #include "../include/codegen.h"
+ #include "../include/asm8086.h"
+ #include "../include/codegen_x64.h"
+ #include "../include/codegen_c.h"
+ #include "../include/jit.h"
+ #include "../include/costmodel.h"
+ #include "../include/irbin.h"
+ #include "../include/cache.h"
+ #include "../include/profile.h"
  
  // Print usage information
  void print_usage(const char* program_name) {
@@ -24,7 +32,23 @@
      printf("                      Level 1: Basic optimizations\n");
      printf("                      Level 2: Intermediate optimizations\n");
      printf("                      Level 3: All optimizations\n");
+     printf("  -Os                 All optimizations, favouring code size (no loop unrolling)\n");
+     printf("  -U <factor>         Loop unrolling factor at level 3 (default: 4, 1 disables partial unrolling)\n");
      printf("  -q                  Quiet mode - don't display assembly code in console\n");
+     printf("  -B                  Binary IR only - skip the CSV dumps of the IR and symbol table\n");
+     printf("  -r                  Write a static 8086 cost report (<output_prefix>.cost.txt)\n");
+     printf("  -t <target>         Code generation target: 8086 (default, <output_prefix>.asm),\n");
+     printf("                      x86-64 (<output_prefix>.s linked into the Linux executable <output_prefix>) or\n");
+     printf("                      c (<output_prefix>.c compiled with $CC -O2 into <output_prefix>)\n");
+     printf("  --com               Also encode the 8086 assembly to a DOS binary (<output_prefix>.com)\n");
+     printf("  -msoft-float        Lower FLOAT values to a software runtime instead of 8087 instructions\n");
+     printf("  --run               Compile the IR to x86-64 machine code in memory and run it (no assembly)\n");
+     printf("  -fprofile-generate=<file>\n");
+     printf("                      With --run, add the basic block execution counts of the run to <file>\n");
+     printf("  -fprofile-use=<file>\n");
+     printf("                      Lay out blocks and unroll loops by the counts in <file> (level 3)\n");
+     printf("  -C <cache_dir>      Reuse outputs of identical compilations from a cache directory\n");
+     printf("                      (size bound in KB from PHYLOG_CACHE_MAX_KB, default 64 MB)\n");
  }
  
  // Function to display file contents
@@ -47,18 +71,64 @@
      fclose(file);
  }
  
+ // Passes run at an optimization level (part of the cache key)
+ static const char* optimization_pass_list(int optimize, int opt_level) {
+     if (!optimize) {
+         return "none";
+     }
+     switch (opt_level) {
+         case 1: return "constfold";
+         case 2: return "constfold,copyprop";
+         default: return "branches,idioms,unroll,copyprop,constfold,constprop,cse,arraycse,algebraic,forward,ranges,dce,layout,compaction,unusedvars";
+     }
+ }
+ 
+ // Display the cached output and cache statistics after a hit
+ static int finish_cache_hit(const char* asm_file, int display_asm, int status) {
+     printf("Cache hit: outputs restored without recompiling\n");
+     if (display_asm) {
+         display_file_contents(asm_file);
+     }
+     cache_display_stats();
+     cache_cleanup();
+     return status;
+ }
+ 
  int main(int argc, char* argv[]) {
      // Default values
      const char* input_file = NULL;
      const char* output_prefix = "output";
      int optimize = 1;
      int opt_level = 3;
+     int optimize_size = 0;  // Default: favour speed (loops may be unrolled)
+     int unroll_factor = OPT_UNROLL_DEFAULT_FACTOR;
      int display_asm = 1;  // Default: display assembly code
+     int cost_report = 0;  // Default: no cost report
+     int csv_dump = 1;     // Default: write human-readable CSV dumps
+     const char* cache_path = NULL;  // Default: no compilation cache
+     int target_x64 = 0;   // Default: 16-bit 8086 assembly
+     int target_c = 0;     // Default: assembly rather than C
+     int run_program = 0;  // Default: generate assembly instead of running
+     int write_com = 0;    // Default: no built-in assembler output
+     int soft_float = 0;   // Default: FLOAT values on the 8087
+     const char* profile_generate = NULL;  // Default: no block counts recorded
+     const char* profile_use = NULL;       // Default: no profile-guided optimization
+     int run_status = EXIT_SUCCESS;
      
      // Parse command line arguments
      for (int i = 1; i < argc; i++) {
          if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
              output_prefix = argv[++i];
+         } else if (strcmp(argv[i], "-Os") == 0) {
+             optimize = 1;
+             opt_level = 3;
+             optimize_size = 1;
+         } else if (strcmp(argv[i], "-U") == 0 && i + 1 < argc) {
+             unroll_factor = atoi(argv[++i]);
+             if (unroll_factor < 1) {
+                 printf("Invalid unroll factor: %s\n", argv[i]);
+                 return EXIT_FAILURE;
+             }
          } else if (strncmp(argv[i], "-O", 2) == 0) {
              optimize = 1;
              // Check if optimization level is specified
@@ -67,6 +137,38 @@
              }
          } else if (strcmp(argv[i], "-q") == 0) {
              display_asm = 0;  // Quiet mode - don't display assembly
+         } else if (strcmp(argv[i], "-B") == 0) {
+             csv_dump = 0;  // Binary IR only
+         } else if (strcmp(argv[i], "-r") == 0) {
+             cost_report = 1;  // Write the static cost report
+         } else if (strcmp(argv[i], "-C") == 0 && i + 1 < argc) {
+             cache_path = argv[++i];
+         } else if (strcmp(argv[i], "--com") == 0) {
+             write_com = 1;  // Encode the assembly to a .com binary
+         } else if (strcmp(argv[i], "-msoft-float") == 0) {
+             soft_float = 1;  // No coprocessor: software float routines
+         } else if (strcmp(argv[i], "--run") == 0) {
+             run_program = 1;
+         } else if (strncmp(argv[i], "-fprofile-generate=", 19) == 0 && argv[i][19] != '\0') {
+             profile_generate = argv[i] + 19;
+         } else if (strncmp(argv[i], "-fprofile-use=", 14) == 0 && argv[i][14] != '\0') {
+             profile_use = argv[i] + 14;
+         } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+             i++;
+             if (strcmp(argv[i], "x86-64") == 0) {
+                 target_x64 = 1;
+                 target_c = 0;
+             } else if (strcmp(argv[i], "c") == 0) {
+                 target_x64 = 0;
+                 target_c = 1;
+             } else if (strcmp(argv[i], "8086") == 0) {
+                 target_x64 = 0;
+                 target_c = 0;
+             } else {
+                 printf("Unknown target: %s\n", argv[i]);
+                 print_usage(argv[0]);
+                 return EXIT_FAILURE;
+             }
          } else if (argv[i][0] == '-') {
              printf("Unknown option: %s\n", argv[i]);
              print_usage(argv[0]);
@@ -82,6 +184,52 @@
          }
      }
      
+     // Running needs the compilation itself, not cached outputs
+     if (run_program && cache_path) {
+         printf("The compilation cache is not used with --run\n");
+         cache_path = NULL;
+     }
+     
+     // Counts are taken while running, on the unoptimized IR: its blocks are
+     // the ones the next compilation parses and -fprofile-use looks up
+     if (profile_generate && !run_program) {
+         printf("Profiles are recorded by --run, ignoring -fprofile-generate\n");
+         profile_generate = NULL;
+     }
+     if (profile_generate) {
+         optimize = 0;
+         if (profile_use) {
+             printf("The profiled run is not optimized, ignoring -fprofile-use\n");
+             profile_use = NULL;
+         }
+     }
+     jit_set_profile(profile_generate);
+     
+     // Only the level 3 passes lay out blocks and unroll loops
+     if (profile_use && (!optimize || opt_level != 3)) {
+         printf("Profiles guide level 3 optimization only, ignoring -fprofile-use\n");
+         profile_use = NULL;
+     }
+     
+     // The cost model describes the 8086
+     if ((target_x64 || target_c) && cost_report) {
+         printf("Cost report is only available for the 8086 target, ignoring -r\n");
+         cost_report = 0;
+     }
+     
+     // The built-in assembler encodes 8086 code only
+     if ((target_x64 || target_c) && write_com) {
+         printf("A .com binary is only produced for the 8086 target, ignoring --com\n");
+         write_com = 0;
+     }
+     
+     // Float lowering of the 8086 backend (the optimizer's cost estimates use it too)
+     if ((target_x64 || target_c) && soft_float) {
+         printf("Soft float only applies to the 8086 target, ignoring -msoft-float\n");
+         soft_float = 0;
+     }
+     codegen_set_soft_float(soft_float);
+     
      // Check for input file
      if (input_file == NULL) {
          printf("No input file specified\n");
@@ -89,6 +237,74 @@
          return EXIT_FAILURE;
      }
      
+     // Generate output file names
+     char symtab_file[256];
+     char ir_file[256];
+     char opt_ir_file[256];
+     char ir_bin_file[256];
+     char opt_ir_bin_file[256];
+     char asm_file[256];
+     char cost_file[256];
+     char x64_asm_file[256];
+     char com_file[256];
+     char c_file[256];
+     
+     sprintf(symtab_file, "%s.symtab.csv", output_prefix);
+     sprintf(ir_file, "%s.ir.csv", output_prefix);
+     sprintf(opt_ir_file, "%s.opt.ir.csv", output_prefix);
+     sprintf(ir_bin_file, "%s.ir.bin", output_prefix);
+     sprintf(opt_ir_bin_file, "%s.opt.ir.bin", output_prefix);
+     sprintf(asm_file, "%s.asm", output_prefix);  // Assembly file follows same naming convention
+     sprintf(cost_file, "%s.cost.txt", output_prefix);
+     sprintf(x64_asm_file, "%s.s", output_prefix);
+     sprintf(com_file, "%s.com", output_prefix);
+     sprintf(c_file, "%s.c", output_prefix);
+     
+     // Output files produced by this option set (what the cache stores)
+     const char* output_suffixes[9];
+     int suffix_count = 0;
+     output_suffixes[suffix_count++] = "ir.bin";
+     if (optimize) output_suffixes[suffix_count++] = "opt.ir.bin";
+     output_suffixes[suffix_count++] = target_x64 ? "s" : target_c ? "c" : "asm";
+     if (csv_dump) {
+         output_suffixes[suffix_count++] = "symtab.csv";
+         output_suffixes[suffix_count++] = "ir.csv";
+         if (optimize) output_suffixes[suffix_count++] = "opt.ir.csv";
+     }
+     if (cost_report) output_suffixes[suffix_count++] = "cost.txt";
+     if (write_com) output_suffixes[suffix_count++] = "com";
+     output_suffixes[suffix_count] = NULL;
+     
+     // Look up the compilation cache
+     char cache_key[CACHE_KEY_LENGTH + 1] = {0};
+     if (cache_path) {
+         char options[320];
+         const char* max_kb = getenv("PHYLOG_CACHE_MAX_KB");
+         long max_bytes = max_kb ? atol(max_kb) * 1024L : CACHE_DEFAULT_MAX_BYTES;
+         
+         snprintf(options, sizeof(options), "O%d;passes=%s;csv=%d;cost=%d;unroll=%d;size=%d;target=%s;com=%d;softfloat=%d;profile=%08x",
+                  optimize ? opt_level : 0, optimization_pass_list(optimize, opt_level),
+                  csv_dump, cost_report, unroll_factor, optimize_size, target_x64 ? "x86-64" : target_c ? "c" : "8086", write_com,
+                  soft_float, profile_use ? profile_file_checksum(profile_use) : 0);
+         
+         int status;
+         if (cache_init(cache_path, max_bytes) && cache_compute_key(input_file, options, cache_key) &&
+             cache_lookup(cache_key, output_prefix, output_suffixes, &status)) {
+             printf("Compiling %s...\n", input_file);
+             if (target_x64) {
+                 // The executable is not cached, it is linked again from the assembly
+                 codegen_x64_link(x64_asm_file, output_prefix);
+                 return finish_cache_hit(x64_asm_file, display_asm, status);
+             }
+             if (target_c) {
+                 // Likewise the executable is compiled again from the C source
+                 codegen_c_compile(c_file, output_prefix);
+                 return finish_cache_hit(c_file, display_asm, status);
+             }
+             return finish_cache_hit(asm_file, display_asm, status);
+         }
+     }
+     
      // Initialize components
      if (!lexer_init(input_file)) {
          report_error(ERROR_LEVEL_FATAL, 0, 0, "Failed to initialize lexer");
@@ -99,6 +315,7 @@
      quadgen_init();
      if (optimize) {
          optimizer_init();
+         optimizer_set_unrolling(unroll_factor, optimize_size ? 0 : OPT_UNROLL_MAX_GROWTH);
      }
      
      // Parse the input file
@@ -112,23 +329,16 @@
          printf("Parse completed with errors, but output will still be generated.\n");
      }
      
-     // Generate output file names
-     char symtab_file[256];
-     char ir_file[256];
-     char opt_ir_file[256];
-     char asm_file[256];
-     
-     sprintf(symtab_file, "%s.symtab.csv", output_prefix);
-     sprintf(ir_file, "%s.ir.csv", output_prefix);
-     sprintf(opt_ir_file, "%s.opt.ir.csv", output_prefix);
-     sprintf(asm_file, "%s.asm", output_prefix);  // Assembly file follows same naming convention
-     
      // Write the symbol table and IR to files even if there were errors
-     symboltable_write_to_file(symtab_file);
-     quadgen_write_to_file(ir_file);
-     
-     printf("Symbol table written to %s\n", symtab_file);
-     printf("IR code written to %s\n", ir_file);
+     irbin_write(ir_bin_file);
+     printf("Binary IR written to %s\n", ir_bin_file);
+     if (csv_dump) {
+         symboltable_write_to_file(symtab_file);
+         quadgen_write_to_file(ir_file);
+         
+         printf("Symbol table written to %s\n", symtab_file);
+         printf("IR code written to %s\n", ir_file);
+     }
      
      // Display summary
      printf("\nCompilation Summary:\n");
@@ -136,6 +346,15 @@
      symboltable_display();
      quadgen_display();  // This displays the original IR
      
+     // Block counts of a previous run of this exact code
+     if (profile_use) {
+         if (profile_load(profile_use)) {
+             printf("Using block profile %s (hottest block ran %ld times)\n", profile_use, profile_max_count());
+         } else {
+             printf("Profile %s is missing or was recorded for other code, ignoring it\n", profile_use);
+         }
+     }
+     
      // Run optimizer if requested
      if (optimize) {
          printf("\nRunning code optimization at level %d...\n", opt_level);
@@ -147,19 +366,19 @@
              case 1:
                  // Basic optimization - just constant folding
                  printf("Performing constant folding...\n");
-                 opt_result = optimizer_run_pass(OPT_PASS_CONSTANT_FOLDING, ir_file, opt_ir_file);
+                 opt_result = optimizer_run_pass(OPT_PASS_CONSTANT_FOLDING, ir_bin_file, opt_ir_bin_file);
                  break;
              
              case 2:
                  // Medium optimization - selected passes
                  {
                      char temp_file[256];
-                     sprintf(temp_file, "%s.tmp.csv", output_prefix);
+                     sprintf(temp_file, "%s.tmp.bin", output_prefix);
                      
                      printf("Performing constant folding and copy propagation...\n");
-                     opt_result = optimizer_run_pass(OPT_PASS_CONSTANT_FOLDING, ir_file, temp_file);
+                     opt_result = optimizer_run_pass(OPT_PASS_CONSTANT_FOLDING, ir_bin_file, temp_file);
                      if (opt_result) {
-                         opt_result = optimizer_run_pass(OPT_PASS_COPY_PROPAGATION, temp_file, opt_ir_file);
+                         opt_result = optimizer_run_pass(OPT_PASS_COPY_PROPAGATION, temp_file, opt_ir_bin_file);
                      }
                      
                      // Cleanup temp file
@@ -170,12 +389,16 @@
              case 3:
                  // Full optimization - all passes
                  printf("Performing all optimization passes...\n");
-                 opt_result = optimizer_run_all_passes(ir_file, opt_ir_file);
+                 opt_result = optimizer_run_all_passes(ir_bin_file, opt_ir_bin_file);
                  break;
          }
          
          if (opt_result) {
-             printf("Optimized IR code written to %s\n", opt_ir_file);
+             // The optimized IR is the current quadruple set; dump it before it is reloaded
+             if (csv_dump) {
+                 quadgen_write_to_file(opt_ir_file);
+                 printf("Optimized IR code written to %s\n", opt_ir_file);
+             }
              
              // Display optimization statistics
              optimizer_display_stats();
@@ -183,9 +406,11 @@
              // Load and display the optimized code
              printf("\n--- Optimized IR ---\n");
              symboltable_display();
-             symboltable_write_to_file(symtab_file);  // save the updated symbol table
+             if (csv_dump) {
+                 symboltable_write_to_file(symtab_file);  // save the updated symbol table
+             }
              quadgen_init();  // Reset quadgen to clear original IR
-             quadgen_read_from_file(opt_ir_file);
+             quadgen_read_from_file(opt_ir_bin_file);
              quadgen_display();  // Now display the optimized IR
          } else {
              printf("Optimization failed, using unoptimized code.\n");
@@ -193,23 +418,66 @@
      }
      
      // Generate assembly code
-     if (parse_result || 1) { // Continue even if parsing had errors
+     if (run_program) {
+         // Execute the current (optimized) quadruples in this process
+         printf("\nRunning %s...\n", input_file);
+         fflush(stdout);
+         run_status = jit_run();
+         if (run_status < 0) {
+             run_status = EXIT_FAILURE;
+         }
+     } else if (target_x64) {
+         printf("\nGenerating x86-64 assembly code...\n");
+         if (codegen_x64_generate(optimize ? opt_ir_bin_file : ir_bin_file, x64_asm_file)) {
+             codegen_x64_link(x64_asm_file, output_prefix);
+         }
+         if (display_asm) {
+             display_file_contents(x64_asm_file);
+         }
+     } else if (target_c) {
+         printf("\nGenerating C code...\n");
+         if (codegen_c_generate(optimize ? opt_ir_bin_file : ir_bin_file, c_file)) {
+             codegen_c_compile(c_file, output_prefix);
+         }
+         if (display_asm) {
+             display_file_contents(c_file);
+         }
+     } else if (parse_result || 1) { // Continue even if parsing had errors
          printf("\nGenerating 8086 assembly code...\n");
          codegen_init();
          if (optimize) {
-             codegen_generate(opt_ir_file, asm_file);
+             codegen_generate(opt_ir_bin_file, asm_file);
          } else {
-             codegen_generate(ir_file, asm_file);
+             codegen_generate(ir_bin_file, asm_file);
          }
-         codegen_cleanup();
          printf("Assembly code written to %s\n", asm_file);
          
+         // Encode the same instruction stream to a binary
+         if (write_com) {
+             asm8086_write_com(com_file);
+         }
+         
+         // Estimate the cost of the generated code
+         if (cost_report) {
+             costmodel_write_report(cost_file);
+         }
+         codegen_cleanup();
+         
          // Display the generated assembly code
          if (display_asm) {
              display_file_contents(asm_file);
          }
      }
      
+     // Store the outputs in the compilation cache
+     if (cache_key[0] != '\0') {
+         if (cache_store(cache_key, output_prefix, output_suffixes, parse_result ? EXIT_SUCCESS : EXIT_FAILURE)) {
+             printf("Outputs stored in cache %s (key %s)\n", cache_path, cache_key);
+         }
+         cache_display_stats();
+         cache_cleanup();
+     }
+     
      // Clean up
      lexer_cleanup();
      symboltable_cleanup();
@@ -217,7 +485,11 @@
      if (optimize) {
          optimizer_cleanup();
      }
+     profile_cleanup();
      
-     // Exit with appropriate status code
+     // Exit with appropriate status code (the program's own status with --run)
+     if (run_program) {
+         return run_status;
+     }
      return parse_result ? EXIT_SUCCESS : EXIT_FAILURE;
  }
\ No newline at end of file
@@ -4,16 +4,27 @@
 
  #include "../include/optimizer.h"
  #include "../include/symboltable.h"
+ #include "../include/profile.h"
  #include <ctype.h>
  
  // Optimization statistics
  static OptimizationStats opt_stats;
  
+ // Loop unrolling settings
+ static int unroll_factor = OPT_UNROLL_DEFAULT_FACTOR;
+ static int unroll_max_growth = OPT_UNROLL_MAX_GROWTH;
+ 
  // Initialize the optimizer
  void optimizer_init() {
      memset(&opt_stats, 0, sizeof(opt_stats));
  }
  
+ // Configure loop unrolling (factor 1 disables partial unrolling)
+ void optimizer_set_unrolling(int factor, int max_growth) {
+     unroll_factor = factor < 1 ? 1 : factor;
+     unroll_max_growth = max_growth < 0 ? 0 : max_growth;
+ }
+ 
  // Check if a string is a temporary variable name
  static int is_temporary(const char* var) {
      return var && var[0] == 'T' && isdigit(var[1]);
@@ -34,11 +45,90 @@
      );
  }
  
+// Helper function to check if a string contains array access notation [...]
+static int is_array_access(const char* str) {
+    return str && strchr(str, '[') != NULL && strchr(str, ']') != NULL;
+}
+
+// Helper function to extract variable name from array access (e.g., "NUMBERS[T9]" -> "T9")
+static void extract_array_index_var(const char* array_access, char* index_var, int max_size) {
+    char* open_bracket = strchr(array_access, '[');
+    char* close_bracket = strchr(array_access, ']');
+    
+    if (open_bracket && close_bracket && (close_bracket > open_bracket)) {
+        int len = close_bracket - open_bracket - 1;
+        if (len < max_size) {
+            strncpy(index_var, open_bracket + 1, len);
+            index_var[len] = '\0';
+        }
+    }
+}
+
+// Check if a field names a variable directly or as the index of an array element
+static int field_mentions(const char* field, const char* name) {
+    if (strcmp(field, name) == 0) {
+        return 1;
+    }
+    if (is_array_access(field)) {
+        char index_var[32] = {0};
+        extract_array_index_var(field, index_var, sizeof(index_var));
+        return strcmp(index_var, name) == 0;
+    }
+    return 0;
+}
+
+// Check if a quadruple writes a variable (or an element of the named array)
+static int quad_writes(const Quadruplet* q, const char* name) {
+    if (is_branch_instruction(q->op) || q->result[0] == '\0') {
+        return 0;
+    }
+    if (strcmp(q->result, name) == 0) {
+        return 1;
+    }
+    if (is_array_access(q->result)) {
+        char array_name[32] = {0};
+        sscanf(q->result, "%[^[]", array_name);
+        return strcmp(array_name, name) == 0;
+    }
+    return 0;
+}
+
+// Check if a quadruple writes anything an operand reads
+static int quad_clobbers_operand(const Quadruplet* q, const char* operand) {
+    if (operand[0] == '\0' || is_integer_literal(operand) || is_float_literal(operand)) {
+        return 0;
+    }
+    if (is_array_access(operand)) {
+        char array_name[32] = {0};
+        char index_var[32] = {0};
+        sscanf(operand, "%[^[]", array_name);
+        extract_array_index_var(operand, index_var, sizeof(index_var));
+        return quad_writes(q, array_name) || quad_writes(q, index_var);
+    }
+    return quad_writes(q, operand);
+}
+
  // Perform constant folding on a set of quadruplets
  static void perform_constant_folding(Quadruplet* quads, int quad_count) {
      for (int i = 0; i < quad_count; i++) {
          Quadruplet* q = &quads[i];
          
+         // Conversion of a literal: the converted literal
+         if (strcmp(q->op, "CONVERT") == 0) {
+             if (strcmp(q->arg2, "FLOAT") == 0 && is_integer_literal(q->arg1)) {
+                 format_float(q->arg1, sizeof(q->arg1), (float)string_to_int(q->arg1));
+             } else if (strcmp(q->arg2, "INTEGER") == 0 && is_float_literal(q->arg1) &&
+                        string_to_float(q->arg1) > -32769.0f && string_to_float(q->arg1) < 32768.0f) {
+                 sprintf(q->arg1, "%d", (int)string_to_float(q->arg1));
+             } else {
+                 continue;
+             }
+             strcpy(q->op, ":=");
+             q->arg2[0] = '\0';
+             opt_stats.constants_folded++;
+             continue;
+         }
+         
          // Skip non-arithmetic operations or operations without two arguments
          if ((strcmp(q->op, "+") != 0 && strcmp(q->op, "-") != 0 && 
               strcmp(q->op, "*") != 0 && strcmp(q->op, "/") != 0 && 
@@ -93,7 +183,7 @@
              
              // Replace with assignment of constant
              strcpy(q->op, ":=");
-             sprintf(q->arg1, "%f", result);
+             format_float(q->arg1, sizeof(q->arg1), result);
              q->arg2[0] = '\0';
              
              opt_stats.constants_folded++;
@@ -130,28 +220,18 @@
                      continue;
                  }
                  
-                 // Avoid propagating if source or dest is used in array operations
-                 int is_array_op = 0;
-                 for (int j = 0; j < quad_count; j++) {
-                     if (strstr(quads[j].result, "[") != NULL) {
-                         char array_name[64] = {0};
-                         sscanf(quads[j].result, "%[^[]", array_name);
-                         
-                         if (strcmp(array_name, src) == 0 || strcmp(array_name, dest) == 0) {
-                             is_array_op = 1;
-                             break;
-                         }
-                     }
-                 }
-                 
-                 if (is_array_op) continue;
                  
-                 // Propagate copy for subsequent uses of dest
+                 // Propagate copy for subsequent uses of dest within the basic block
                  for (int j = i + 1; j < quad_count; j++) {
                      Quadruplet* qj = &quads[j];
                      
+                     // Stop at a label: other paths may reach it with other values
+                     if (strcmp(qj->op, "ETIQ") == 0) {
+                         break;
+                     }
+                     
                      // Stop at redefinition of source or dest
-                     if (strcmp(qj->result, src) == 0 || strcmp(qj->result, dest) == 0) {
+                     if (quad_clobbers_operand(qj, src) || quad_clobbers_operand(qj, dest)) {
                          break;
                      }
                      
@@ -203,12 +283,17 @@
                  const char* constant = q->arg1;
                  const char* dest = q->result;
                  
-                 // Propagate constant for subsequent uses of dest
+                 // Propagate constant for subsequent uses of dest within the basic block
                  for (int j = i + 1; j < quad_count; j++) {
                      Quadruplet* qj = &quads[j];
                      
+                     // Stop at a label: other paths may reach it with other values
+                     if (strcmp(qj->op, "ETIQ") == 0) {
+                         break;
+                     }
+                     
                      // Stop at redefinition of dest
-                     if (strcmp(qj->result, dest) == 0) {
+                     if (quad_clobbers_operand(qj, dest)) {
                          break;
                      }
                      
@@ -261,10 +346,20 @@
              continue;
          }
          
-         // Look for later equivalent expressions
+         // An expression that overwrites its own operand is not available afterwards
+         if (quad_clobbers_operand(qi, qi->arg1) || quad_clobbers_operand(qi, qi->arg2)) {
+             continue;
+         }
+         
+         // Look for later equivalent expressions in the same basic block
          for (int j = i + 1; j < quad_count; j++) {
              Quadruplet* qj = &quads[j];
              
+             // Stop at a label: the expression is not available on every path
+             if (strcmp(qj->op, "ETIQ") == 0) {
+                 break;
+             }
+             
              // Skip branch instructions
              if (is_branch_instruction(qj->op)) {
                  continue;
@@ -302,8 +397,9 @@
                  int redefined = 0;
                  for (int k = i + 1; k < j; k++) {
                      Quadruplet* qk = &quads[k];
-                     if (strcmp(qk->result, qi->arg1) == 0 || 
-                         strcmp(qk->result, qi->arg2) == 0) {
+                     if (quad_clobbers_operand(qk, qi->arg1) ||
+                         quad_clobbers_operand(qk, qi->arg2) ||
+                         quad_clobbers_operand(qk, qi->result)) {
                          redefined = 1;
                          break;
                      }
@@ -361,11 +457,9 @@
                  q->arg2[0] = '\0';
                  opt_stats.algebraic_simplifications++;
              }
-         }
-         
-         // 4. Multiplication with 1: x * 1 = x, 1 * x = x
-         else if (strcmp(q->op, "*") == 0) {
-             if (strcmp(q->arg1, "1") == 0) {
+             
+             // 4. Multiplication with 1: x * 1 = x, 1 * x = x
+             else if (strcmp(q->arg1, "1") == 0) {
                  strcpy(q->op, ":=");
                  strcpy(q->arg1, q->arg2);
                  q->arg2[0] = '\0';
@@ -400,25 +494,6 @@
      }
  }
  
-// Helper function to check if a string contains array access notation [...]
-static int is_array_access(const char* str) {
-    return str && strchr(str, '[') != NULL && strchr(str, ']') != NULL;
-}
-
-// Helper function to extract variable name from array access (e.g., "NUMBERS[T9]" -> "T9")
-static void extract_array_index_var(const char* array_access, char* index_var, int max_size) {
-    char* open_bracket = strchr(array_access, '[');
-    char* close_bracket = strchr(array_access, ']');
-    
-    if (open_bracket && close_bracket && (close_bracket > open_bracket)) {
-        int len = close_bracket - open_bracket - 1;
-        if (len < max_size) {
-            strncpy(index_var, open_bracket + 1, len);
-            index_var[len] = '\0';
-        }
-    }
-}
-
 // Helper function to add a variable to the used_vars array if it's not already there
 static int add_to_used_vars(char used_vars[][32], int* used_count, const char* var) {
     if (!var || var[0] == '\0' || is_label(var) || is_integer_literal(var) || is_float_literal(var)) {
@@ -470,23 +545,33 @@ static void perform_dead_code_elimination(Quadruplet* quads, int quad_count) {
             }
         }
         
-        // Also look for array accesses in arg1 and arg2
+        // Also look for array accesses in arg1 and arg2; an array that is read
+        // anywhere keeps all of its stores
         if (is_array_access(q->arg1)) {
             char index_var[32] = {0};
+            char array_name[32] = {0};
             extract_array_index_var(q->arg1, index_var, sizeof(index_var));
+            sscanf(q->arg1, "%31[^[]", array_name);
             
             if (index_var[0] != '\0') {
                 add_to_used_vars(array_indices, &array_index_count, index_var);
             }
+            // A range check does not read the element
+            if (strcmp(q->op, "BOUNDS") != 0) {
+                add_to_used_vars(array_indices, &array_index_count, array_name);
+            }
         }
         
         if (is_array_access(q->arg2)) {
             char index_var[32] = {0};
+            char array_name[32] = {0};
             extract_array_index_var(q->arg2, index_var, sizeof(index_var));
+            sscanf(q->arg2, "%31[^[]", array_name);
             
             if (index_var[0] != '\0') {
                 add_to_used_vars(array_indices, &array_index_count, index_var);
             }
+            add_to_used_vars(array_indices, &array_index_count, array_name);
         }
     }
     
@@ -669,149 +754,1729 @@ static void perform_dead_code_elimination(Quadruplet* quads, int quad_count) {
 }
 
 
-// Perform code compaction
-// A more direct compaction function
-static void perform_code_compaction(Quadruplet* quads, int *quad_count_ptr) {
-    int original_count = *quad_count_ptr;
-    
-    // Print the first 10 quadruples to debug
-    //printf("DEBUG: First 10 operators before compaction:\n");
-    //for (int i = 0; i < 40 && i < original_count; i++) {
-     //   printf("  [%d] op='%s'\n", i, quads[i].op);
-    //}
+// Count the definitions and uses of a temporary
+static void count_temp_references(Quadruplet* quads, int quad_count, const char* temp,
+                                  int* defs, int* uses, int* use_index) {
+    *defs = 0;
+    *uses = 0;
+    *use_index = -1;
     
-    // Count NOPs first
-    int nop_count = 0;
-    for (int i = 0; i < original_count; i++) {
-        if (strcmp(quads[i].op, "NOP") == 0) {
-            nop_count++;
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        if (strcmp(q->op, "NOP") == 0 || strcmp(q->op, "ETIQ") == 0) {
+            continue;
         }
-    }
-    
-    //printf("DEBUG: Found %d NOPs out of %d quadruples\n", nop_count, original_count);
-    
-    // If no NOPs found, nothing to do
-    if (nop_count == 0) {
-        printf("No NOPs found, no compaction needed.\n");
-        return;
-    }
-    
-    int write_idx = 0;
-    
-    // Compact the array
-    for (int read_idx = 0; read_idx < original_count; read_idx++) {
-        if (strcmp(quads[read_idx].op, "NOP") != 0) {
-            // Only copy if positions differ
-            if (write_idx != read_idx) {
-                // Copy the quadruple
-                memcpy(&quads[write_idx], &quads[read_idx], sizeof(Quadruplet));
-            }
-            // Update the ID
-            quads[write_idx].id = write_idx;
-            write_idx++;
+        
+        // Branches compare their arg2 and result fields
+        int result_is_use = is_branch_instruction(q->op) || is_array_access(q->result);
+        if (!is_branch_instruction(q->op) && strcmp(q->result, temp) == 0) {
+            (*defs)++;
+        }
+        
+        int mentions = field_mentions(q->arg1, temp) + field_mentions(q->arg2, temp) +
+                       (result_is_use && field_mentions(q->result, temp));
+        if (mentions > 0) {
+            *uses += mentions;
+            *use_index = i;
         }
     }
-    
-    printf("Code compaction removed %d NOPs. Quadruple count reduced from %d to %d.\n", 
-           nop_count, original_count, write_idx);
-    
-    // Update the count
-    *quad_count_ptr = write_idx;
-    
-    // Update statistics
-    opt_stats.nops_eliminated = nop_count;
 }
 
-
-// Simple unused variable cleanup based on symbol table contents
-// Updated unused variable cleanup function that works on final IR
-static void perform_unused_variable_cleanup(Quadruplet* quads, int quad_count) {
-    printf("Checking for unused variables in final IR...\n");
-    
-    // Get all symbols from the symbol table
-    int symbol_count = symboltable_get_count();
-    
-    // First collect all variables used in the final IR
-    char used_vars[1000][32] = {{0}};
-    int used_count = 0;
-    
-    // Helper function to add to used list
-    void add_to_used(const char* var) {
-        if (!var || var[0] == '\0' || isdigit(var[0]) || var[0] == '-' || 
-            (var[0] == 'L' && isdigit(var[1])) || strcmp(var, "$") == 0) {
-            return;  // Skip literals, labels, etc.
+// Forward results: "T := a op b; ...; X := T" becomes "X := a op b" when T has a single use
+static void perform_result_forwarding(Quadruplet* quads, int quad_count) {
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* producer = &quads[i];
+        
+        // Only value-producing quadruples that define a temporary
+        if (strcmp(producer->op, "NOP") == 0 || strcmp(producer->op, "LIRE") == 0 ||
+            strcmp(producer->op, "AFFICHER") == 0 || strcmp(producer->op, "ETIQ") == 0 ||
+            strcmp(producer->op, "BOUNDS") == 0 || strcmp(producer->op, "ADEC") == 0 ||
+            is_branch_instruction(producer->op) || !is_temporary(producer->result)) {
+            continue;
         }
         
-        // Check if already in list
-        for (int i = 0; i < used_count; i++) {
-            if (strcmp(used_vars[i], var) == 0) {
-                return;  // Already in list
-            }
+        int defs, uses, j;
+        count_temp_references(quads, quad_count, producer->result, &defs, &uses, &j);
+        if (defs != 1 || uses != 1 || j <= i) {
+            continue;
         }
         
-        // Add to list
-        if (used_count < 1000) {
-            strcpy(used_vars[used_count], var);
-            used_count++;
+        // The single use must be a plain copy of the temporary
+        Quadruplet* copy = &quads[j];
+        if (strcmp(copy->op, ":=") != 0 || copy->arg2[0] != '\0' ||
+            strcmp(copy->arg1, producer->result) != 0) {
+            continue;
         }
-    }
-    
-    // Helper for array notation
-    void check_array_notation(const char* expr) {
-        if (!expr || !strchr(expr, '[')) return;
         
-        char name[32] = {0};
-        char index[32] = {0};
+        // The producer moves down to the copy: both must be in the same basic block
+        // and the producer's operands must still hold the same values there
+        int safe = 1;
+        for (int k = i + 1; k < j && safe; k++) {
+            Quadruplet* qk = &quads[k];
+            if (strcmp(qk->op, "ETIQ") == 0 || is_branch_instruction(qk->op) ||
+                quad_clobbers_operand(qk, producer->arg1) ||
+                quad_clobbers_operand(qk, producer->arg2)) {
+                safe = 0;
+            }
+        }
+        if (!safe) {
+            continue;
+        }
         
-        sscanf(expr, "%[^[]", name);
-        add_to_used(name);
+        // Retarget the producer to the copy's destination and delete the copy
+        strcpy(copy->op, producer->op);
+        strcpy(copy->arg1, producer->arg1);
+        strcpy(copy->arg2, producer->arg2);
+        strcpy(producer->op, "NOP");
+        producer->arg1[0] = '\0';
+        producer->arg2[0] = '\0';
+        producer->result[0] = '\0';
         
-        if (sscanf(expr, "%*[^[][%[^]]", index) == 1) {
-            add_to_used(index);
-        }
+        opt_stats.results_forwarded++;
     }
-    
-    // Scan the FINAL IR for all variable references
+}
+
+// Branch with the opposite condition (NULL for non-conditional operators)
+static const char* inverted_branch(const char* op) {
+    if (strcmp(op, "BG") == 0) return "BLE";
+    if (strcmp(op, "BLE") == 0) return "BG";
+    if (strcmp(op, "BGE") == 0) return "BL";
+    if (strcmp(op, "BL") == 0) return "BGE";
+    if (strcmp(op, "BE") == 0) return "BNE";
+    if (strcmp(op, "BNE") == 0) return "BE";
+    return NULL;
+}
+
+// Find the quadruple defining a label
+static int find_label(Quadruplet* quads, int quad_count, const char* label) {
     for (int i = 0; i < quad_count; i++) {
-        Quadruplet* q = &quads[i];
-        
-        // Handle array references
-        if (strchr(q->arg1, '[')) check_array_notation(q->arg1);
-        if (strchr(q->arg2, '[')) check_array_notation(q->arg2);
-        if (strchr(q->result, '[')) check_array_notation(q->result);
-        
-        // Handle direct references
-        if (strcmp(q->op, "AFFICHER") == 0 || strcmp(q->op, "LIRE") == 0) {
-            // Skip arg1 for I/O operations
-            add_to_used(q->arg2);
-            add_to_used(q->result);
-        } else {
-            add_to_used(q->arg1);
-            add_to_used(q->arg2);
-            add_to_used(q->result);
+        if (strcmp(quads[i].op, "ETIQ") == 0 && strcmp(quads[i].arg1, label) == 0) {
+            return i;
         }
     }
+    return -1;
+}
+
+// Check if a label is defined in the run of labels (and NOPs) starting at index
+static int label_follows(Quadruplet* quads, int quad_count, int index, const char* label) {
+    for (int i = index; i < quad_count; i++) {
+        if (strcmp(quads[i].op, "NOP") == 0) continue;
+        if (strcmp(quads[i].op, "ETIQ") != 0) return 0;
+        if (strcmp(quads[i].arg1, label) == 0) return 1;
+    }
+    return 0;
+}
+
+// Index of the next quadruple that is not a NOP
+static int next_quad(Quadruplet* quads, int quad_count, int index) {
+    while (index < quad_count && strcmp(quads[index].op, "NOP") == 0) index++;
+    return index;
+}
+
+// Turn a quadruple into a NOP
+static void make_nop(Quadruplet* q) {
+    strcpy(q->op, "NOP");
+    q->arg1[0] = '\0';
+    q->arg2[0] = '\0';
+    q->result[0] = '\0';
+}
+
+// Simplify the control flow: thread jump chains, invert branches over jumps,
+// remove jumps to the next quadruple, unreachable code and unused labels
+static void perform_branch_simplification(Quadruplet* quads, int quad_count) {
+    int modified;
     
-    printf("Found %d variables used in final IR\n", used_count);
-    
-    // Now check each symbol to see if it's used
-    int removed_count = 0;
-    for (int i = 0; i < symbol_count; i++) {
-        SymbolNode* symbol = symboltable_get_by_index(i);
-        if (!symbol) continue;
+    do {
+        modified = 0;
         
-        // Skip certain types (e.g., constants might not be directly referenced)
-        if (symbol->category != CATEGORY_VARIABLE && 
-            symbol->category != CATEGORY_TEMP) {
-            continue;
+        for (int i = 0; i < quad_count; i++) {
+            Quadruplet* q = &quads[i];
+            if (!is_branch_instruction(q->op)) continue;
+            
+            // 1. Jump to a jump: go straight to the final target
+            // (only when the chain ends, so jump cycles are left alone)
+            char target[32];
+            int resolved = 0;
+            strcpy(target, q->arg1);
+            for (int hops = 0; hops < quad_count; hops++) {
+                int label = find_label(quads, quad_count, target);
+                if (label < 0) {
+                    resolved = 1;
+                    break;
+                }
+                int k = label;
+                while (k < quad_count && (strcmp(quads[k].op, "ETIQ") == 0 || strcmp(quads[k].op, "NOP") == 0)) k++;
+                if (k >= quad_count || strcmp(quads[k].op, "SAUT") != 0 ||
+                    strcmp(quads[k].arg1, target) == 0) {
+                    resolved = 1;
+                    break;
+                }
+                if (strcmp(quads[k].arg1, q->arg1) == 0) {
+                    break;
+                }
+                strcpy(target, quads[k].arg1);
+            }
+            if (resolved && strcmp(target, q->arg1) != 0) {
+                strcpy(q->arg1, target);
+                opt_stats.branches_simplified++;
+                modified = 1;
+            }
+            
+            // 2. "Bxx L1; SAUT L2; ETIQ L1" becomes "B!xx L2; ETIQ L1"
+            const char* inverted = inverted_branch(q->op);
+            int j = next_quad(quads, quad_count, i + 1);
+            if (inverted && j < quad_count && strcmp(quads[j].op, "SAUT") == 0 &&
+                label_follows(quads, quad_count, j + 1, q->arg1)) {
+                strcpy(q->op, inverted);
+                strcpy(q->arg1, quads[j].arg1);
+                make_nop(&quads[j]);
+                opt_stats.branches_simplified++;
+                modified = 1;
+            }
+            
+            // 3. Jump to the next quadruple
+            if (label_follows(quads, quad_count, i + 1, q->arg1)) {
+                make_nop(q);
+                opt_stats.branches_simplified++;
+                modified = 1;
+            }
         }
         
-        // Check if this symbol is used in final IR
-        int is_used = 0;
-        for (int j = 0; j < used_count; j++) {
-            if (strcmp(symbol->name, used_vars[j]) == 0) {
-                is_used = 1;
-                break;
+        // 4. Code after an unconditional jump is unreachable up to the next label
+        for (int i = 0; i < quad_count; i++) {
+            if (strcmp(quads[i].op, "SAUT") != 0) continue;
+            for (int k = i + 1; k < quad_count && strcmp(quads[k].op, "ETIQ") != 0; k++) {
+                if (strcmp(quads[k].op, "NOP") == 0 || strcmp(quads[k].op, "BOUNDS") == 0 ||
+                    strcmp(quads[k].op, "ADEC") == 0) {
+                    continue;
+                }
+                make_nop(&quads[k]);
+                opt_stats.branches_simplified++;
+                modified = 1;
+            }
+        }
+        
+        // 5. Labels that no jump refers to
+        for (int i = 0; i < quad_count; i++) {
+            if (strcmp(quads[i].op, "ETIQ") != 0) continue;
+            int referenced = 0;
+            for (int k = 0; k < quad_count && !referenced; k++) {
+                referenced = is_branch_instruction(quads[k].op) && strcmp(quads[k].arg1, quads[i].arg1) == 0;
+            }
+            if (!referenced) {
+                make_nop(&quads[i]);
+                opt_stats.branches_simplified++;
+                modified = 1;
+            }
+        }
+    } while (modified);
+}
+
+// Value of an integer literal or initialized integer constant
+static int compile_time_int(const char* operand, int* value) {
+    if (is_integer_literal(operand)) {
+        *value = string_to_int(operand);
+        return 1;
+    }
+    SymbolNode* node = symboltable_lookup(operand);
+    if (node && node->category == CATEGORY_CONSTANT && node->type == TYPE_INTEGER && node->is_initialized) {
+        *value = node->value.int_value;
+        return 1;
+    }
+    return 0;
+}
+
+// Highest label number used in the quadruples
+static int max_label_number(Quadruplet* quads, int quad_count) {
+    int max_label = -1;
+    for (int i = 0; i < quad_count; i++) {
+        if (strcmp(quads[i].op, "ETIQ") == 0 && is_label(quads[i].arg1)) {
+            int number = atoi(quads[i].arg1 + 1);
+            if (number > max_label) max_label = number;
+        }
+    }
+    return max_label;
+}
+
+// Growable output buffer for the unroller
+typedef struct {
+    Quadruplet* quads;
+    int count;
+    int capacity;
+} QuadBuffer;
+
+// Append a quadruple to a buffer (a new one: it has no place in the parsed code)
+static void buffer_append(QuadBuffer* buffer, const char* op, const char* arg1, const char* arg2, const char* result) {
+    if (buffer->count >= buffer->capacity) {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+        buffer->quads = (Quadruplet*)safe_realloc(buffer->quads, buffer->capacity * sizeof(Quadruplet));
+    }
+    Quadruplet* q = &buffer->quads[buffer->count];
+    memset(q, 0, sizeof(Quadruplet));
+    q->id = -1;
+    strncpy(q->op, op, sizeof(q->op) - 1);
+    strncpy(q->arg1, arg1, sizeof(q->arg1) - 1);
+    strncpy(q->arg2, arg2, sizeof(q->arg2) - 1);
+    strncpy(q->result, result, sizeof(q->result) - 1);
+    buffer->count++;
+}
+
+// Append a copy of a quadruple, keeping its id (its index in the parsed code,
+// which the block profile is looked up by)
+static void buffer_append_quad(QuadBuffer* buffer, const Quadruplet* q) {
+    buffer_append(buffer, q->op, q->arg1, q->arg2, q->result);
+    buffer->quads[buffer->count - 1].id = q->id;
+}
+
+// Profiled execution count of a quadruple's block (-1 without a profile or for new quadruples)
+static long execution_count(const Quadruplet* q) {
+    return profile_quad_count(q->id);
+}
+
+// Append a copy of quads[first..last), giving the labels defined there fresh names
+static void buffer_append_copy(QuadBuffer* buffer, Quadruplet* quads, int first, int last, int* next_label) {
+    int start = buffer->count;
+    for (int i = first; i < last; i++) {
+        if (strcmp(quads[i].op, "NOP") == 0) continue;
+        buffer_append_quad(buffer, &quads[i]);
+    }
+    
+    for (int i = start; i < buffer->count; i++) {
+        if (strcmp(buffer->quads[i].op, "ETIQ") != 0) continue;
+        char old_label[32], new_label[32];
+        strcpy(old_label, buffer->quads[i].arg1);
+        sprintf(new_label, "L%d", (*next_label)++);
+        for (int j = start; j < buffer->count; j++) {
+            if ((strcmp(buffer->quads[j].op, "ETIQ") == 0 || is_branch_instruction(buffer->quads[j].op)) &&
+                strcmp(buffer->quads[j].arg1, old_label) == 0) {
+                strcpy(buffer->quads[j].arg1, new_label);
+            }
+        }
+    }
+}
+
+// A counted FOR loop found in the quadruples
+typedef struct {
+    int guard;        // Index of the guard branch
+    int body_start;   // First quadruple of the body
+    int body_end;     // Index of the counter increment (end of the body)
+    int exit_index;   // Index of the exit label
+    int init_value;   // Initial counter value
+    int trips;        // Trip count, -1 when the bound is only known at run time
+} CountedLoop;
+
+// Recognize a rotated FOR loop starting at its initialization quadruple:
+//   := init V; Bguard Lexit V bound; ETIQ Lbody; body; + V 1 V; Blatch Lbody V bound; ETIQ Lexit
+// The initial value must be known at compile time; the bound may be a variable the body leaves alone
+static int match_counted_loop(Quadruplet* quads, int quad_count, int init, CountedLoop* loop) {
+    Quadruplet* qi = &quads[init];
+    int init_value, bound_value;
+    if (strcmp(qi->op, ":=") != 0 || qi->arg2[0] != '\0' || is_array_access(qi->result) ||
+        !compile_time_int(qi->arg1, &init_value)) {
+        return 0;
+    }
+    const char* var = qi->result;
+    
+    int guard = next_quad(quads, quad_count, init + 1);
+    int body = guard < quad_count ? next_quad(quads, quad_count, guard + 1) : quad_count;
+    if (body >= quad_count || (strcmp(quads[guard].op, "BG") != 0 && strcmp(quads[guard].op, "BGE") != 0)) {
+        return 0;
+    }
+    Quadruplet* qg = &quads[guard];
+    int bound_known = compile_time_int(qg->result, &bound_value);
+    if (strcmp(qg->arg2, var) != 0 || strcmp(quads[body].op, "ETIQ") != 0 ||
+        (!bound_known && (is_array_access(qg->result) || is_float_literal(qg->result)))) {
+        return 0;
+    }
+    const char* body_label = quads[body].arg1;
+    
+    // Find the latch that jumps back to the body label
+    int latch = -1;
+    for (int i = body + 1; i < quad_count; i++) {
+        if (is_branch_instruction(quads[i].op) && strcmp(quads[i].arg1, body_label) == 0) {
+            latch = i;
+            break;
+        }
+    }
+    if (latch < 0 || strcmp(quads[latch].op, inverted_branch(qg->op)) != 0 ||
+        strcmp(quads[latch].arg2, var) != 0 || strcmp(quads[latch].result, qg->result) != 0) {
+        return 0;
+    }
+    
+    // The increment is the last quadruple before the latch; the exit label follows it
+    int increment = latch - 1;
+    while (increment > body && strcmp(quads[increment].op, "NOP") == 0) increment--;
+    int exit_label = next_quad(quads, quad_count, latch + 1);
+    if (increment <= body || strcmp(quads[increment].op, "+") != 0 ||
+        strcmp(quads[increment].arg1, var) != 0 || strcmp(quads[increment].arg2, "1") != 0 ||
+        strcmp(quads[increment].result, var) != 0 || exit_label >= quad_count ||
+        strcmp(quads[exit_label].op, "ETIQ") != 0 || strcmp(quads[exit_label].arg1, qg->arg1) != 0) {
+        return 0;
+    }
+    
+    // The body must not write the counter or the bound, and its jumps must stay inside it
+    for (int i = body + 1; i < increment; i++) {
+        Quadruplet* q = &quads[i];
+        if (quad_writes(q, var) || (!bound_known && quad_writes(q, qg->result))) {
+            return 0;
+        }
+        if (is_branch_instruction(q->op)) {
+            int target = find_label(quads, quad_count, q->arg1);
+            if (target <= body || target >= increment) {
+                return 0;
+            }
+        }
+    }
+    
+    loop->guard = guard;
+    loop->body_start = body + 1;
+    loop->body_end = increment;
+    loop->exit_index = exit_label;
+    loop->init_value = init_value;
+    loop->trips = -1;
+    
+    // BG guards an I.LE.bound loop, BGE an I.L.bound loop
+    if (bound_known) {
+        int trips = bound_value - init_value + (strcmp(qg->op, "BG") == 0 ? 1 : 0);
+        loop->trips = trips < 0 ? 0 : trips;
+    }
+    return 1;
+}
+
+// Index temporaries of a loop body that hold the counter plus a constant offset
+typedef struct {
+    char name[32];
+    int offset;
+} AffineIndex;
+
+#define MAX_AFFINE_INDEXES 8
+
+// Offset of an index operand from the loop counter (0 if it is not counter + constant)
+static int index_offset(const char* operand, const char* var, AffineIndex* indexes, int index_count, int* offset) {
+    if (strcmp(operand, var) == 0) {
+        *offset = 0;
+        return 1;
+    }
+    for (int i = 0; i < index_count; i++) {
+        if (strcmp(indexes[i].name, operand) == 0) {
+            *offset = indexes[i].offset;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Check if a name is an integer array (array elements are words)
+static int is_integer_array(const char* name) {
+    SymbolNode* node = symboltable_lookup(name);
+    return node && node->category == CATEGORY_ARRAY && node->type == TYPE_INTEGER;
+}
+
+// Check if a value is the same on every iteration of a loop and fits an integer word
+static int is_loop_invariant_word(const char* value, const char* var) {
+    if (is_integer_literal(value)) {
+        return 1;
+    }
+    if (is_temporary(value) || is_array_access(value) || strcmp(value, var) == 0) {
+        return 0;
+    }
+    SymbolNode* node = symboltable_lookup(value);
+    return node && node->type == TYPE_INTEGER &&
+           (node->category == CATEGORY_VARIABLE || node->category == CATEGORY_CONSTANT);
+}
+
+// Check that no quadruple outside [first, last) mentions a name
+static int local_to_range(Quadruplet* quads, int quad_count, int first, int last, const char* name) {
+    for (int i = 0; i < quad_count; i++) {
+        if (i >= first && i < last) continue;
+        Quadruplet* q = &quads[i];
+        if (strcmp(q->op, "NOP") == 0) continue;
+        if (field_mentions(q->arg1, name) || field_mentions(q->arg2, name) || field_mentions(q->result, name)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Recognize a loop body that fills an array with an invariant value (A[I+c] = v) or
+// copies one array into another (A[I+c] = B[I+d]); builds the replacing AFILL/ACOPY
+static int match_array_idiom(Quadruplet* quads, int quad_count, const CountedLoop* loop,
+                             const char* var, Quadruplet* idiom) {
+    AffineIndex indexes[MAX_AFFINE_INDEXES];
+    int index_count = 0;
+    int checks[2];
+    int check_count = 0;
+    int load = -1, store = -1;
+    
+    for (int i = loop->body_start; i < loop->body_end; i++) {
+        Quadruplet* q = &quads[i];
+        int offset;
+        if (strcmp(q->op, "NOP") == 0) {
+            continue;
+        }
+        if (store >= 0) {
+            return 0;  // The store must end the body
+        }
+        
+        // Index arithmetic: T := counter +/- constant
+        if ((strcmp(q->op, "+") == 0 || strcmp(q->op, "-") == 0) && is_temporary(q->result) &&
+            is_integer_literal(q->arg2) && index_count < MAX_AFFINE_INDEXES &&
+            index_offset(q->arg1, var, indexes, index_count, &offset)) {
+            int constant = string_to_int(q->arg2);
+            strcpy(indexes[index_count].name, q->result);
+            indexes[index_count].offset = q->op[0] == '+' ? offset + constant : offset - constant;
+            index_count++;
+        } else if (strcmp(q->op, "BOUNDS") == 0 && is_array_access(q->arg1) && check_count < 2) {
+            checks[check_count++] = i;  // Replaced by the block operation's own range check
+        } else if (strcmp(q->op, ":=") == 0 && q->arg2[0] == '\0' && is_temporary(q->result) &&
+                   is_array_access(q->arg1) && load < 0) {
+            load = i;
+        } else if (strcmp(q->op, ":=") == 0 && q->arg2[0] == '\0' && is_array_access(q->result)) {
+            store = i;
+        } else {
+            return 0;
+        }
+    }
+    if (store < 0) {
+        return 0;
+    }
+    
+    // The stored element must be counter + constant
+    char array_name[32] = {0}, index[32] = {0};
+    int dest_offset, source_offset;
+    sscanf(quads[store].result, "%31[^[]", array_name);
+    extract_array_index_var(quads[store].result, index, sizeof(index));
+    if (!is_integer_array(array_name) || !index_offset(index, var, indexes, index_count, &dest_offset)) {
+        return 0;
+    }
+    
+    // The rewritten elements must fit the quadruple fields
+    char element[64];
+    snprintf(element, sizeof(element), "%s[%d]", array_name, loop->init_value + dest_offset);
+    if (strlen(element) >= sizeof(idiom->result)) {
+        return 0;
+    }
+    memset(idiom, 0, sizeof(Quadruplet));
+    strcpy(idiom->result, element);
+    
+    if (load < 0) {
+        // Fill: the value must not change from one iteration to the next
+        if (!is_loop_invariant_word(quads[store].arg1, var)) {
+            return 0;
+        }
+        strcpy(idiom->op, "AFILL");
+        strcpy(idiom->arg1, quads[store].arg1);
+    } else {
+        // Copy: the loaded element goes straight to the store
+        char source_name[32] = {0}, source_index[32] = {0};
+        sscanf(quads[load].arg1, "%31[^[]", source_name);
+        extract_array_index_var(quads[load].arg1, source_index, sizeof(source_index));
+        if (strcmp(quads[store].arg1, quads[load].result) != 0 || !is_integer_array(source_name) ||
+            !index_offset(source_index, var, indexes, index_count, &source_offset) ||
+            !local_to_range(quads, quad_count, loop->body_start, loop->body_end, quads[load].result)) {
+            return 0;
+        }
+        snprintf(element, sizeof(element), "%s[%d]", source_name, loop->init_value + source_offset);
+        if (strlen(element) >= sizeof(idiom->arg1)) {
+            return 0;
+        }
+        strcpy(idiom->op, "ACOPY");
+        strcpy(idiom->arg1, element);
+    }
+    
+    // Only the accessed elements may be checked
+    for (int i = 0; i < check_count; i++) {
+        const char* checked = quads[checks[i]].arg1;
+        if (strcmp(checked, quads[store].result) != 0 && (load < 0 || strcmp(checked, quads[load].arg1) != 0)) {
+            return 0;
+        }
+    }
+    
+    // The index temporaries disappear with the loop
+    for (int i = 0; i < index_count; i++) {
+        if (!local_to_range(quads, quad_count, loop->body_start, loop->body_end, indexes[i].name)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Replace array fill and copy loops with single AFILL/ACOPY quadruples
+// (lowered to rep stosw / rep movsw after one range check)
+static void perform_loop_idiom_recognition(Quadruplet** quads_ptr, int* quad_count_ptr) {
+    Quadruplet* quads = *quads_ptr;
+    int quad_count = *quad_count_ptr;
+    QuadBuffer out = {NULL, 0, 0};
+    int replaced = 0;
+    
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        CountedLoop loop;
+        Quadruplet idiom;
+        
+        // Loops that never run are left to the unroller
+        if (!match_counted_loop(quads, quad_count, i, &loop) || loop.trips == 0 ||
+            !match_array_idiom(quads, quad_count, &loop, q->result, &idiom)) {
+            if (strcmp(q->op, "NOP") != 0) {
+                buffer_append_quad(&out, q);
+            }
+            continue;
+        }
+        
+        Quadruplet* guard = &quads[loop.guard];
+        int inclusive = strcmp(guard->op, "BG") == 0;
+        const char* var = q->result;
+        char value[32];
+        
+        buffer_append_quad(&out, q);
+        if (loop.trips > 0) {
+            // Element count known at compile time: the guard always falls through
+            sprintf(idiom.arg2, "%d", loop.trips);
+            buffer_append(&out, idiom.op, idiom.arg1, idiom.arg2, idiom.result);
+            sprintf(value, "%d", loop.init_value + loop.trips);
+            buffer_append(&out, ":=", value, "", var);
+            for (int k = 0; k < quad_count; k++) {
+                if ((k < i || k > loop.exit_index) && is_branch_instruction(quads[k].op) &&
+                    strcmp(quads[k].arg1, guard->arg1) == 0) {
+                    buffer_append(&out, "ETIQ", guard->arg1, "", "");
+                    break;
+                }
+            }
+        } else {
+            // Count = bound - init (+ 1 for an inclusive bound), computed once past the guard
+            SymbolNode* count = symboltable_create_temp(TYPE_INTEGER);
+            buffer_append_quad(&out, guard);
+            sprintf(value, "%d", loop.init_value - inclusive);
+            buffer_append(&out, "-", guard->result, value, count->name);
+            strcpy(idiom.arg2, count->name);
+            buffer_append(&out, idiom.op, idiom.arg1, idiom.arg2, idiom.result);
+            if (inclusive) {
+                buffer_append(&out, "+", guard->result, "1", var);
+            } else {
+                buffer_append(&out, ":=", guard->result, "", var);
+            }
+            buffer_append(&out, "ETIQ", guard->arg1, "", "");
+        }
+        
+        printf("Replaced %s loop on %s with %s %s %s %s\n", idiom.op[1] == 'F' ? "fill" : "copy",
+               var, idiom.op, idiom.arg1, idiom.arg2, idiom.result);
+        opt_stats.loop_idioms_replaced++;
+        replaced = 1;
+        i = loop.exit_index;
+    }
+    
+    if (!replaced) {
+        free(out.quads);
+        return;
+    }
+    
+    free(quads);
+    *quads_ptr = out.quads;
+    *quad_count_ptr = out.count;
+}
+
+// Unroll FOR loops with compile-time trip counts: small loops completely,
+// larger ones by the unroll factor with the original loop as remainder
+static void perform_loop_unrolling(Quadruplet** quads_ptr, int* quad_count_ptr) {
+    Quadruplet* quads = *quads_ptr;
+    int quad_count = *quad_count_ptr;
+    int next_label = max_label_number(quads, quad_count) + 1;
+    QuadBuffer out = {NULL, 0, 0};
+    int unrolled = 0;
+    
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        CountedLoop loop;
+        if (!match_counted_loop(quads, quad_count, i, &loop) || loop.trips < 0) {
+            if (strcmp(q->op, "NOP") != 0) {
+                buffer_append_quad(&out, q);
+            }
+            continue;
+        }
+        
+        const char* var = q->result;
+        int init_value = loop.init_value;
+        int trips = loop.trips;
+        int body_start = loop.body_start, body_end = loop.body_end, exit_index = loop.exit_index;
+        
+        int body_size = 0;
+        for (int k = body_start; k < body_end; k++) {
+            if (strcmp(quads[k].op, "NOP") != 0) body_size++;
+        }
+        int loop_size = body_size + 5;  // guard, body label, increment, latch, exit label
+        char value[32];
+        
+        // With a profile, loops that hardly run stay rolled and the hottest
+        // ones get twice the unroll factor when the growth budget allows it
+        int factor = unroll_factor, max_growth = unroll_max_growth;
+        long body_count = execution_count(&quads[body_start - 1]);
+        if (body_count >= 0 && body_count * OPT_PROFILE_COLD_RATIO < profile_max_count()) {
+            printf("Loop on %s is cold in the profile (body ran %ld times), not unrolled\n", var, body_count);
+            buffer_append_quad(&out, q);
+            continue;
+        }
+        if (body_count >= 0 && body_count * OPT_PROFILE_HOT_RATIO >= profile_max_count() && factor > 1 &&
+            (2 * factor - 1) * (body_size + 1) + 2 <= 2 * max_growth) {
+            factor *= 2;
+            max_growth *= 2;
+        }
+        
+        // Full unrolling: one copy of the body per iteration, the counter set before each
+        if (trips <= OPT_UNROLL_FULL_MAX_TRIPS && trips * (body_size + 1) <= loop_size + unroll_max_growth) {
+            buffer_append_quad(&out, q);
+            for (int t = 0; t < trips; t++) {
+                if (t > 0) {
+                    sprintf(value, "%d", init_value + t);
+                    buffer_append(&out, ":=", value, "", var);
+                }
+                buffer_append_copy(&out, quads, body_start, body_end, &next_label);
+            }
+            if (trips > 0) {
+                sprintf(value, "%d", init_value + trips);
+                buffer_append(&out, ":=", value, "", var);
+            }
+            printf("Fully unrolled loop on %s (%d iterations)\n", var, trips);
+            opt_stats.loops_unrolled++;
+            unrolled = 1;
+            i = exit_index;
+            continue;
+        }
+        
+        // Partial unrolling: factor copies per iteration of a new loop, then the
+        // original loop runs the remaining iterations
+        int main_trips = factor > 1 ? trips / factor : 0;
+        if (main_trips > 0 && (factor - 1) * (body_size + 1) + 2 <= max_growth) {
+            char label[32];
+            sprintf(label, "L%d", next_label++);
+            
+            buffer_append_quad(&out, q);
+            buffer_append(&out, "ETIQ", label, "", "");
+            for (int u = 0; u < factor; u++) {
+                buffer_append_copy(&out, quads, body_start, body_end, &next_label);
+                buffer_append(&out, "+", var, "1", var);
+            }
+            sprintf(value, "%d", init_value + main_trips * factor);
+            buffer_append(&out, "BL", label, var, value);
+            
+            // Remainder: the original loop, whose guard fails when nothing is left
+            if (trips % factor != 0) {
+                for (int k = i + 1; k <= exit_index; k++) {
+                    if (strcmp(quads[k].op, "NOP") != 0) {
+                        buffer_append_quad(&out, &quads[k]);
+                    }
+                }
+            }
+            printf("Unrolled loop on %s by %d (%d iterations, %d left to the remainder loop)\n",
+                   var, factor, trips, trips % factor);
+            opt_stats.loops_unrolled++;
+            unrolled = 1;
+            i = exit_index;
+            continue;
+        }
+        
+        buffer_append_quad(&out, q);
+    }
+    
+    if (!unrolled) {
+        free(out.quads);
+        return;
+    }
+    
+    free(quads);
+    *quads_ptr = out.quads;
+    *quad_count_ptr = out.count;
+}
+
+// Move regions the profile shows are rarely entered out of line, so that
+// the hot path falls through instead of jumping around them:
+//   Bcc Lx; R; ETIQ Lx   becomes  Binv Lc; ETIQ Lx ...  ETIQ Lc; R; SAUT Lx
+//   SAUT Lx; R; ETIQ Lx  becomes  ETIQ Lx ...            R; SAUT Lx
+// The moved regions go after the last quadruple, behind a jump over them.
+static void perform_block_layout(Quadruplet** quads_ptr, int* quad_count_ptr) {
+    if (!profile_loaded()) {
+        return;
+    }
+    Quadruplet* quads = *quads_ptr;
+    int quad_count = *quad_count_ptr;
+    int next_label = max_label_number(quads, quad_count) + 1;
+    QuadBuffer out = {NULL, 0, 0};
+    QuadBuffer cold = {NULL, 0, 0};
+    
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        if (strcmp(q->op, "NOP") == 0) {
+            continue;
+        }
+        
+        // The region runs from the next quadruple up to the branch's label,
+        // and after an unconditional jump it can only be entered at a label
+        int jump = strcmp(q->op, "SAUT") == 0;
+        int region = is_branch_instruction(q->op) ? next_quad(quads, quad_count, i + 1) : quad_count;
+        int end = region;
+        while (end < quad_count && !(strcmp(quads[end].op, "ETIQ") == 0 && strcmp(quads[end].arg1, q->arg1) == 0)) {
+            end++;
+        }
+        long branch_count = execution_count(q);
+        long region_count = region < end ? execution_count(&quads[region]) : -1;
+        if (end >= quad_count || region_count < 0 || branch_count <= 0 ||
+            region_count * OPT_PROFILE_RARE_RATIO >= branch_count || (jump && strcmp(quads[region].op, "ETIQ") != 0)) {
+            buffer_append_quad(&out, q);
+            continue;
+        }
+        
+        int last = end - 1;
+        while (strcmp(quads[last].op, "NOP") == 0) last--;
+        if (!jump) {
+            char label[32];
+            sprintf(label, "L%d", next_label++);
+            buffer_append_quad(&out, q);
+            strcpy(out.quads[out.count - 1].op, inverted_branch(q->op));
+            strcpy(out.quads[out.count - 1].arg1, label);
+            buffer_append(&cold, "ETIQ", label, "", "");
+        }
+        int moved = 0;
+        for (int k = region; k < end; k++) {
+            if (strcmp(quads[k].op, "NOP") != 0) {
+                buffer_append_quad(&cold, &quads[k]);
+                moved++;
+            }
+        }
+        if (strcmp(quads[last].op, "SAUT") != 0) {
+            buffer_append(&cold, "SAUT", q->arg1, "", "");
+        }
+        printf("Moved %d rarely run quadruples ahead of %s out of line (entered %ld of %ld times)\n",
+               moved, q->arg1, region_count, branch_count);
+        opt_stats.blocks_moved++;
+        i = end - 1;
+    }
+    
+    if (cold.count == 0) {
+        free(out.quads);
+        return;
+    }
+    
+    // Jump over the moved regions at the end of the program
+    char label[32];
+    sprintf(label, "L%d", next_label++);
+    buffer_append(&out, "SAUT", label, "", "");
+    for (int k = 0; k < cold.count; k++) {
+        buffer_append_quad(&out, &cold.quads[k]);
+    }
+    buffer_append(&out, "ETIQ", label, "", "");
+    free(cold.quads);
+    
+    free(quads);
+    *quads_ptr = out.quads;
+    *quad_count_ptr = out.count;
+}
+
+// Integer interval of a 16-bit variable
+typedef struct {
+    int lo;
+    int hi;
+} ValueRange;
+
+#define RANGE_MIN (-32768)
+#define RANGE_MAX 32767
+#define RANGE_WIDEN_AFTER 4           // Block updates before bounds are widened
+#define RANGE_NARROW_ROUNDS 2         // Passes that tighten widened bounds again
+#define RANGE_MAX_CELLS (4L * 1024 * 1024)
+
+// Variables whose values the range analysis tracks, and the constants
+// that widened bounds stop at
+typedef struct {
+    char (*names)[32];
+    int count;
+    int capacity;
+    int* thresholds;     // Sorted, distinct
+    int threshold_count;
+} RangeVars;
+
+// Basic block of the range analysis
+typedef struct {
+    int first;
+    int last;         // Index of the last quadruple (inclusive)
+    int succ[2];      // Fall-through and branch target blocks (-1 if none)
+    int updates;
+    int reached;
+} RangeBlock;
+
+static ValueRange full_range(void) {
+    ValueRange r = { RANGE_MIN, RANGE_MAX };
+    return r;
+}
+
+// Clamp an exact result to a range, giving up when it may wrap around
+static ValueRange make_range(long lo, long hi) {
+    if (lo < RANGE_MIN || hi > RANGE_MAX) {
+        return full_range();
+    }
+    ValueRange r = { (int)lo, (int)hi };
+    return r;
+}
+
+// Index of a tracked variable (-1 if the name is not tracked)
+static int range_var_index(const RangeVars* vars, const char* name) {
+    for (int i = 0; i < vars->count; i++) {
+        if (strcmp(vars->names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+// Track a name if it is an integer scalar
+static void range_var_add(RangeVars* vars, const char* name) {
+    if (name[0] == '\0' || is_array_access(name) || is_label(name) ||
+        is_integer_literal(name) || is_float_literal(name) || range_var_index(vars, name) >= 0) {
+        return;
+    }
+    SymbolNode* node = symboltable_lookup(name);
+    if (!node || node->type != TYPE_INTEGER ||
+        (node->category != CATEGORY_VARIABLE && node->category != CATEGORY_TEMP)) {
+        return;
+    }
+    if (vars->count >= vars->capacity) {
+        vars->capacity = vars->capacity ? vars->capacity * 2 : 64;
+        vars->names = safe_realloc(vars->names, vars->capacity * sizeof(*vars->names));
+    }
+    strcpy(vars->names[vars->count++], name);
+}
+
+// Range of an operand in a state
+static ValueRange operand_range(const RangeVars* vars, const ValueRange* state, const char* operand) {
+    int value;
+    if (compile_time_int(operand, &value)) {
+        ValueRange r = { value, value };
+        return r;
+    }
+    int index = range_var_index(vars, operand);
+    return index >= 0 ? state[index] : full_range();
+}
+
+// Range of "a op b"
+static ValueRange arithmetic_range(const char* op, ValueRange a, ValueRange b) {
+    if (strcmp(op, "+") == 0) {
+        return make_range((long)a.lo + b.lo, (long)a.hi + b.hi);
+    }
+    if (strcmp(op, "-") == 0) {
+        return make_range((long)a.lo - b.hi, (long)a.hi - b.lo);
+    }
+    if (strcmp(op, "*") == 0 || (strcmp(op, "/") == 0 && (b.lo > 0 || b.hi < 0))) {
+        long corners[4];
+        int divide = op[0] == '/';
+        corners[0] = divide ? (long)a.lo / b.lo : (long)a.lo * b.lo;
+        corners[1] = divide ? (long)a.lo / b.hi : (long)a.lo * b.hi;
+        corners[2] = divide ? (long)a.hi / b.lo : (long)a.hi * b.lo;
+        corners[3] = divide ? (long)a.hi / b.hi : (long)a.hi * b.hi;
+        long lo = corners[0], hi = corners[0];
+        for (int i = 1; i < 4; i++) {
+            if (corners[i] < lo) lo = corners[i];
+            if (corners[i] > hi) hi = corners[i];
+        }
+        return make_range(lo, hi);
+    }
+    if (strcmp(op, "%") == 0 && b.lo == b.hi && b.lo > 0) {
+        // The remainder takes the sign of the dividend
+        return make_range(a.lo >= 0 ? 0 : -(long)(b.lo - 1), a.hi <= 0 ? 0 : b.lo - 1);
+    }
+    return full_range();
+}
+
+// Apply one quadruple to a state
+static void range_transfer(const RangeVars* vars, ValueRange* state, const Quadruplet* q) {
+    if (strcmp(q->op, "NOP") == 0) {
+        return;
+    }
+    
+    // A passed access check bounds its index from then on
+    if (strcmp(q->op, "BOUNDS") == 0 && is_array_access(q->arg1)) {
+        char index[32] = {0};
+        extract_array_index_var(q->arg1, index, sizeof(index));
+        int v = range_var_index(vars, index);
+        if (v >= 0) {
+            int size = string_to_int(q->arg2);
+            if (state[v].lo < 0) state[v].lo = 0;
+            if (state[v].hi > size - 1) state[v].hi = size - 1;
+        }
+        return;
+    }
+    if (is_branch_instruction(q->op) || q->result[0] == '\0' || is_array_access(q->result)) {
+        return;
+    }
+    
+    int r = range_var_index(vars, q->result);
+    if (r < 0) {
+        return;
+    }
+    if (strcmp(q->op, ":=") == 0 && q->arg2[0] == '\0') {
+        state[r] = operand_range(vars, state, q->arg1);
+    } else if (q->op[1] == '\0' && strchr("+-*/%", q->op[0])) {
+        state[r] = arithmetic_range(q->op, operand_range(vars, state, q->arg1),
+                                    operand_range(vars, state, q->arg2));
+    } else {
+        state[r] = full_range();
+    }
+}
+
+// Narrow the operands of a comparison "a op b" that is known to hold;
+// returns 0 if it cannot hold in this state
+static int range_assume(const RangeVars* vars, ValueRange* state, const char* op, const char* left, const char* right) {
+    ValueRange a = operand_range(vars, state, left);
+    ValueRange b = operand_range(vars, state, right);
+    
+    if (strcmp(op, "BL") == 0 || strcmp(op, "BLE") == 0) {
+        int strict = op[2] == '\0';
+        if (a.hi > b.hi - strict) a.hi = b.hi - strict;
+        if (b.lo < a.lo + strict) b.lo = a.lo + strict;
+    } else if (strcmp(op, "BG") == 0 || strcmp(op, "BGE") == 0) {
+        int strict = op[2] == '\0';
+        if (a.lo < b.lo + strict) a.lo = b.lo + strict;
+        if (b.hi > a.hi - strict) b.hi = a.hi - strict;
+    } else if (strcmp(op, "BE") == 0) {
+        if (a.lo < b.lo) a.lo = b.lo;
+        if (a.hi > b.hi) a.hi = b.hi;
+        b = a;
+    } else {
+        return 1;
+    }
+    if (a.lo > a.hi || b.lo > b.hi) {
+        return 0;
+    }
+    
+    int l = range_var_index(vars, left);
+    int r = range_var_index(vars, right);
+    if (l >= 0) state[l] = a;
+    if (r >= 0) state[r] = b;
+    return 1;
+}
+
+// Add a widening threshold
+static void range_threshold_add(RangeVars* vars, int value) {
+    int i = 0;
+    while (i < vars->threshold_count && vars->thresholds[i] < value) i++;
+    if (i < vars->threshold_count && vars->thresholds[i] == value) {
+        return;
+    }
+    memmove(&vars->thresholds[i + 1], &vars->thresholds[i], (vars->threshold_count - i) * sizeof(int));
+    vars->thresholds[i] = value;
+    vars->threshold_count++;
+}
+
+// Widen a lower bound to the closest threshold below it
+static int widen_down(const RangeVars* vars, int value) {
+    for (int i = vars->threshold_count - 1; i >= 0; i--) {
+        if (vars->thresholds[i] <= value) return vars->thresholds[i];
+    }
+    return RANGE_MIN;
+}
+
+// Widen an upper bound to the closest threshold above it
+static int widen_up(const RangeVars* vars, int value) {
+    for (int i = 0; i < vars->threshold_count; i++) {
+        if (vars->thresholds[i] >= value) return vars->thresholds[i];
+    }
+    return RANGE_MAX;
+}
+
+// Merge a state into a block's entry state; returns 1 if it grew
+static int range_merge(const RangeVars* vars, RangeBlock* block, ValueRange* entry, const ValueRange* state) {
+    if (!block->reached) {
+        memcpy(entry, state, vars->count * sizeof(ValueRange));
+        block->reached = 1;
+        return 1;
+    }
+    int widen = block->updates >= RANGE_WIDEN_AFTER;
+    int changed = 0;
+    for (int i = 0; i < vars->count; i++) {
+        if (state[i].lo < entry[i].lo) {
+            entry[i].lo = widen ? widen_down(vars, state[i].lo) : state[i].lo;
+            changed = 1;
+        }
+        if (state[i].hi > entry[i].hi) {
+            entry[i].hi = widen ? widen_up(vars, state[i].hi) : state[i].hi;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+// Run a block from its entry state and pass the result to its successors.
+// With a NULL next table the successors' entries are merged into (fixpoint);
+// otherwise the exit states are joined into next (narrowing).
+static int range_propagate(Quadruplet* quads, const RangeVars* vars, RangeBlock* blocks, int b,
+                           ValueRange** entry, ValueRange** next, int* next_reached, ValueRange* state) {
+    RangeBlock* block = &blocks[b];
+    int var_count = vars->count;
+    int changed = 0;
+    memcpy(state, entry[b], var_count * sizeof(ValueRange));
+    for (int i = block->first; i <= block->last; i++) {
+        range_transfer(vars, state, &quads[i]);
+    }
+    
+    Quadruplet* last = &quads[block->last];
+    int conditional = is_branch_instruction(last->op) && strcmp(last->op, "SAUT") != 0;
+    ValueRange* edge = state + var_count;
+    
+    for (int s = 0; s < 2; s++) {
+        int target = block->succ[s];
+        if (target < 0) continue;
+        memcpy(edge, state, var_count * sizeof(ValueRange));
+        
+        // succ[1] is the taken edge, succ[0] the fall-through (branch not taken)
+        if (conditional) {
+            const char* op = s == 1 ? last->op : inverted_branch(last->op);
+            if (!range_assume(vars, edge, op, last->arg2, last->result)) {
+                continue;
+            }
+        }
+        
+        if (next) {
+            if (!next_reached[target]) {
+                memcpy(next[target], edge, var_count * sizeof(ValueRange));
+                next_reached[target] = 1;
+            } else {
+                for (int i = 0; i < var_count; i++) {
+                    if (edge[i].lo < next[target][i].lo) next[target][i].lo = edge[i].lo;
+                    if (edge[i].hi > next[target][i].hi) next[target][i].hi = edge[i].hi;
+                }
+            }
+        } else if (range_merge(vars, &blocks[target], entry[target], edge)) {
+            blocks[target].updates++;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+// Interval-based value range propagation over the control flow graph; access
+// checks whose index is proven inside the array are removed
+static void perform_range_check_elimination(Quadruplet* quads, int quad_count) {
+    RangeVars vars = { NULL, 0, 0, NULL, 0 };
+    int check_count = 0;
+    
+    // Widened bounds stop at the program's constants (and one past them)
+    vars.thresholds = safe_malloc((6 * quad_count + 1) * sizeof(int));
+    for (int i = 0; i < quad_count; i++) {
+        const char* fields[3] = { quads[i].arg1, quads[i].arg2, quads[i].result };
+        for (int f = 0; f < 3; f++) {
+            int value;
+            if (!is_array_access(fields[f]) && compile_time_int(fields[f], &value)) {
+                range_threshold_add(&vars, value);
+                range_threshold_add(&vars, value - 1);
+            }
+            range_var_add(&vars, fields[f]);
+        }
+        if (strcmp(quads[i].op, "BOUNDS") == 0 && is_array_access(quads[i].arg1)) check_count++;
+    }
+    if (check_count == 0) {
+        free(vars.names);
+        free(vars.thresholds);
+        return;
+    }
+    
+    // Basic blocks: a label or the quadruple after a branch starts a new one
+    RangeBlock* blocks = safe_malloc((quad_count + 1) * sizeof(RangeBlock));
+    int* block_of = safe_malloc((quad_count + 1) * sizeof(int));
+    int block_count = 0;
+    for (int i = 0; i < quad_count; i++) {
+        if (i == 0 || strcmp(quads[i].op, "ETIQ") == 0 || is_branch_instruction(quads[i - 1].op)) {
+            blocks[block_count].first = i;
+            block_count++;
+        }
+        blocks[block_count - 1].last = i;
+        block_of[i] = block_count - 1;
+    }
+    
+    if ((long)block_count * vars.count > RANGE_MAX_CELLS || vars.count == 0) {
+        printf("Range analysis skipped (%d blocks, %d variables)\n", block_count, vars.count);
+        free(blocks);
+        free(block_of);
+        free(vars.names);
+        free(vars.thresholds);
+        return;
+    }
+    
+    for (int b = 0; b < block_count; b++) {
+        Quadruplet* last = &quads[blocks[b].last];
+        int target = is_branch_instruction(last->op) ? find_label(quads, quad_count, last->arg1) : -1;
+        blocks[b].succ[0] = strcmp(last->op, "SAUT") == 0 || b + 1 >= block_count ? -1 : b + 1;
+        blocks[b].succ[1] = target >= 0 ? block_of[target] : -1;
+        blocks[b].updates = 0;
+        blocks[b].reached = 0;
+    }
+    
+    ValueRange** entry = safe_malloc(block_count * sizeof(ValueRange*));
+    ValueRange** next = safe_malloc(block_count * sizeof(ValueRange*));
+    int* next_reached = safe_malloc(block_count * sizeof(int));
+    for (int b = 0; b < block_count; b++) {
+        entry[b] = safe_malloc(vars.count * sizeof(ValueRange));
+        next[b] = safe_malloc(vars.count * sizeof(ValueRange));
+    }
+    ValueRange* state = safe_malloc(2 * vars.count * sizeof(ValueRange));
+    
+    // Variables start out as zero (the data segment is zero-filled)
+    blocks[0].reached = 1;
+    memset(entry[0], 0, vars.count * sizeof(ValueRange));
+    
+    // Fixpoint with widening
+    int changed;
+    do {
+        changed = 0;
+        for (int b = 0; b < block_count; b++) {
+            if (blocks[b].reached) {
+                changed |= range_propagate(quads, &vars, blocks, b, entry, NULL, NULL, state);
+            }
+        }
+    } while (changed);
+    
+    // Narrowing: recompute every entry from the stable states
+    for (int round = 0; round < RANGE_NARROW_ROUNDS; round++) {
+        memset(next_reached, 0, block_count * sizeof(int));
+        next_reached[0] = 1;
+        memset(next[0], 0, vars.count * sizeof(ValueRange));
+        for (int b = 0; b < block_count; b++) {
+            if (blocks[b].reached) {
+                range_propagate(quads, &vars, blocks, b, entry, next, next_reached, state);
+            }
+        }
+        for (int b = 0; b < block_count; b++) {
+            if (blocks[b].reached && next_reached[b]) {
+                memcpy(entry[b], next[b], vars.count * sizeof(ValueRange));
+            }
+        }
+    }
+    
+    // Remove the checks that cannot fail
+    for (int b = 0; b < block_count; b++) {
+        if (!blocks[b].reached) continue;
+        memcpy(state, entry[b], vars.count * sizeof(ValueRange));
+        for (int i = blocks[b].first; i <= blocks[b].last; i++) {
+            Quadruplet* q = &quads[i];
+            if (strcmp(q->op, "BOUNDS") == 0 && is_array_access(q->arg1)) {
+                char index[32] = {0};
+                extract_array_index_var(q->arg1, index, sizeof(index));
+                ValueRange r = operand_range(&vars, state, index);
+                if (r.lo >= 0 && r.hi < string_to_int(q->arg2)) {
+                    make_nop(q);
+                    opt_stats.bounds_checks_removed++;
+                    continue;
+                }
+            }
+            range_transfer(&vars, state, q);
+        }
+    }
+    
+    printf("Range analysis removed %d of %d array range checks\n", opt_stats.bounds_checks_removed, check_count);
+    
+    for (int b = 0; b < block_count; b++) {
+        free(entry[b]);
+        free(next[b]);
+    }
+    free(entry);
+    free(next);
+    free(next_reached);
+    free(state);
+    free(blocks);
+    free(block_of);
+    free(vars.names);
+    free(vars.thresholds);
+}
+
+// Value numbers of the array element pass
+typedef enum {
+    VN_NAME,        // Value a variable had when the block was entered
+    VN_CONST,       // Integer constant
+    VN_AFFINE,      // Another value number plus a constant offset
+    VN_EXPR,        // Any other computed or loaded value
+} ValueNumberKind;
+
+typedef struct {
+    ValueNumberKind kind;
+    int base;               // VN_AFFINE base value number
+    int offset;             // VN_CONST value, VN_AFFINE offset
+    char op[4];             // VN_EXPR operator ("" for an opaque value)
+    int left;
+    int right;
+} ValueNumber;
+
+// Value numbering state of an extended basic block
+typedef struct {
+    ValueNumber* numbers;
+    int number_count;
+    int number_capacity;
+    
+    char (*names)[32];      // Variable -> value number
+    int* name_numbers;
+    int name_count;
+    int name_capacity;
+    
+    struct {
+        char array[32];
+        int index;          // Value number of the 0-based index
+        int value;          // Value number of the element
+        char holder[32];    // Operand that held the value when it was recorded
+    }* elements;
+    int element_count;
+    int element_capacity;
+} ElementTable;
+
+// Append a value number
+static int vn_new(ElementTable* t, ValueNumberKind kind, int base, int offset, const char* op, int left, int right) {
+    if (t->number_count >= t->number_capacity) {
+        t->number_capacity = t->number_capacity ? t->number_capacity * 2 : 128;
+        t->numbers = safe_realloc(t->numbers, t->number_capacity * sizeof(ValueNumber));
+    }
+    ValueNumber* n = &t->numbers[t->number_count];
+    memset(n, 0, sizeof(ValueNumber));
+    n->kind = kind;
+    n->base = base;
+    n->offset = offset;
+    strncpy(n->op, op, sizeof(n->op) - 1);
+    n->left = left;
+    n->right = right;
+    return t->number_count++;
+}
+
+// Value number of an integer constant
+static int vn_const(ElementTable* t, int value) {
+    for (int i = 0; i < t->number_count; i++) {
+        if (t->numbers[i].kind == VN_CONST && t->numbers[i].offset == value) return i;
+    }
+    return vn_new(t, VN_CONST, -1, value, "", -1, -1);
+}
+
+// Value number of "vn + offset", folded onto the underlying base
+static int vn_affine(ElementTable* t, int vn, int offset) {
+    ValueNumber* n = &t->numbers[vn];
+    if (n->kind == VN_CONST) {
+        return vn_const(t, n->offset + offset);
+    }
+    int base = vn;
+    if (n->kind == VN_AFFINE) {
+        base = n->base;
+        offset += n->offset;
+    }
+    if (offset == 0) {
+        return base;
+    }
+    for (int i = 0; i < t->number_count; i++) {
+        if (t->numbers[i].kind == VN_AFFINE && t->numbers[i].base == base && t->numbers[i].offset == offset) {
+            return i;
+        }
+    }
+    return vn_new(t, VN_AFFINE, base, offset, "", -1, -1);
+}
+
+// Current value number of a variable
+static int vn_name_slot(ElementTable* t, const char* name) {
+    for (int i = 0; i < t->name_count; i++) {
+        if (strcmp(t->names[i], name) == 0) return i;
+    }
+    return -1;
+}
+
+// Bind a variable to a value number
+static void vn_set_name(ElementTable* t, const char* name, int vn) {
+    int slot = vn_name_slot(t, name);
+    if (slot < 0) {
+        if (t->name_count >= t->name_capacity) {
+            t->name_capacity = t->name_capacity ? t->name_capacity * 2 : 64;
+            t->names = safe_realloc(t->names, t->name_capacity * sizeof(*t->names));
+            t->name_numbers = safe_realloc(t->name_numbers, t->name_capacity * sizeof(int));
+        }
+        slot = t->name_count++;
+        strcpy(t->names[slot], name);
+    }
+    t->name_numbers[slot] = vn;
+}
+
+// Value number of a scalar operand (literal, constant or variable)
+static int vn_operand(ElementTable* t, const char* operand) {
+    int value;
+    if (compile_time_int(operand, &value)) {
+        return vn_const(t, value);
+    }
+    int slot = vn_name_slot(t, operand);
+    if (slot >= 0) {
+        return t->name_numbers[slot];
+    }
+    int vn = vn_new(t, VN_NAME, -1, 0, "", -1, -1);
+    vn_set_name(t, operand, vn);
+    return vn;
+}
+
+// Value number of "left op right"
+static int vn_expression(ElementTable* t, const char* op, int left, int right) {
+    if (strcmp(op, "+") == 0 && t->numbers[right].kind == VN_CONST) {
+        return vn_affine(t, left, t->numbers[right].offset);
+    }
+    if (strcmp(op, "+") == 0 && t->numbers[left].kind == VN_CONST) {
+        return vn_affine(t, right, t->numbers[left].offset);
+    }
+    if (strcmp(op, "-") == 0 && t->numbers[right].kind == VN_CONST) {
+        return vn_affine(t, left, -t->numbers[right].offset);
+    }
+    if ((strcmp(op, "+") == 0 || strcmp(op, "*") == 0) && left > right) {
+        int swap = left;
+        left = right;
+        right = swap;
+    }
+    for (int i = 0; i < t->number_count; i++) {
+        ValueNumber* n = &t->numbers[i];
+        if (n->kind == VN_EXPR && strcmp(n->op, op) == 0 && n->left == left && n->right == right) {
+            return i;
+        }
+    }
+    return vn_new(t, VN_EXPR, -1, 0, op, left, right);
+}
+
+// Check if two indexes may name the same element: equal value numbers do,
+// the same base with different offsets (or different constants) do not
+static int vn_may_alias(ElementTable* t, int a, int b) {
+    if (a == b) {
+        return 1;
+    }
+    ValueNumber* na = &t->numbers[a];
+    ValueNumber* nb = &t->numbers[b];
+    int base_a = na->kind == VN_AFFINE ? na->base : na->kind == VN_CONST ? -1 : a;
+    int base_b = nb->kind == VN_AFFINE ? nb->base : nb->kind == VN_CONST ? -1 : b;
+    int offset_a = na->kind == VN_AFFINE || na->kind == VN_CONST ? na->offset : 0;
+    int offset_b = nb->kind == VN_AFFINE || nb->kind == VN_CONST ? nb->offset : 0;
+    return !(base_a == base_b && offset_a != offset_b);
+}
+
+// Variable that currently holds a value number (NULL if none)
+static const char* vn_holder(ElementTable* t, int vn) {
+    for (int i = 0; i < t->name_count; i++) {
+        if (t->name_numbers[i] == vn) return t->names[i];
+    }
+    return NULL;
+}
+
+// Check if an operand still holds a value number
+static int vn_holds(ElementTable* t, const char* operand, int vn) {
+    if (operand[0] == '\0') {
+        return 0;
+    }
+    return vn_operand(t, operand) == vn;
+}
+
+// Check if the variable a quadruple loads into is read before being rewritten
+static int loaded_value_read_later(Quadruplet* quads, int quad_count, int index) {
+    const char* name = quads[index].result;
+    for (int j = index + 1; j < quad_count; j++) {
+        if (field_mentions(quads[j].arg1, name) || field_mentions(quads[j].arg2, name) ||
+            (is_array_access(quads[j].result) && field_mentions(quads[j].result, name)) ||
+            (is_branch_instruction(quads[j].op) && strcmp(quads[j].result, name) == 0)) {
+            return 1;
+        }
+        if (quad_writes(&quads[j], name)) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// Find a recorded element
+static int element_find(ElementTable* t, const char* array, int index) {
+    for (int i = 0; i < t->element_count; i++) {
+        if (t->elements[i].index == index && strcmp(t->elements[i].array, array) == 0) return i;
+    }
+    return -1;
+}
+
+// Forget the elements of an array a store to [index] may overwrite (all of them for index -1)
+static void element_kill(ElementTable* t, const char* array, int index) {
+    int kept = 0;
+    for (int i = 0; i < t->element_count; i++) {
+        if (strcmp(t->elements[i].array, array) == 0 &&
+            (index < 0 || vn_may_alias(t, t->elements[i].index, index))) {
+            continue;
+        }
+        t->elements[kept++] = t->elements[i];
+    }
+    t->element_count = kept;
+}
+
+// Record the value of an element
+static void element_record(ElementTable* t, const char* array, int index, int value, const char* holder) {
+    int slot = element_find(t, array, index);
+    if (slot < 0) {
+        if (t->element_count >= t->element_capacity) {
+            t->element_capacity = t->element_capacity ? t->element_capacity * 2 : 32;
+            t->elements = safe_realloc(t->elements, t->element_capacity * sizeof(*t->elements));
+        }
+        slot = t->element_count++;
+        strcpy(t->elements[slot].array, array);
+        t->elements[slot].index = index;
+    }
+    t->elements[slot].value = value;
+    strcpy(t->elements[slot].holder, holder ? holder : "");
+}
+
+// Split an element reference and give its index the earliest variable holding
+// the same value; returns the index value number
+static int element_index(ElementTable* t, char* field, char* array) {
+    char index[32] = {0};
+    sscanf(field, "%31[^[]", array);
+    extract_array_index_var(field, index, sizeof(index));
+    int vn = vn_operand(t, index);
+    
+    const char* holder = vn_holder(t, vn);
+    if (holder && strcmp(holder, index) != 0 && !is_integer_literal(index) &&
+        strlen(array) + strlen(holder) + 2 < 32) {
+        sprintf(field, "%s[%s]", array, holder);
+        opt_stats.array_accesses_reused++;
+    }
+    return vn;
+}
+
+// Value of an element read; replaces the read with a variable already holding
+// the value when there is one. Returns the value number.
+static int element_read(ElementTable* t, char* field, const char* op) {
+    char array[32] = {0};
+    int index = element_index(t, field, array);
+    int slot = element_find(t, array, index);
+    if (slot < 0) {
+        int value = vn_new(t, VN_EXPR, -1, 0, "", -1, -1);
+        element_record(t, array, index, value, NULL);
+        return value;
+    }
+    
+    int value = t->elements[slot].value;
+    const char* holder = t->elements[slot].holder;
+    if (vn_holds(t, holder, value) && strcmp(op, "BOUNDS") != 0) {
+        strcpy(field, holder);
+        opt_stats.array_accesses_reused++;
+    }
+    return value;
+}
+
+// Array element CSE over extended basic blocks: loads of an element whose value is
+// already in a variable (from an earlier load or store) become copies. Distinct
+// arrays never alias; indexes of one array are compared by value number.
+static void perform_array_element_cse(Quadruplet* quads, int quad_count) {
+    ElementTable t;
+    memset(&t, 0, sizeof(t));
+    
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        if (strcmp(q->op, "NOP") == 0) {
+            continue;
+        }
+        
+        // A label may be reached with other values
+        if (strcmp(q->op, "ETIQ") == 0) {
+            t.number_count = 0;
+            t.name_count = 0;
+            t.element_count = 0;
+            continue;
+        }
+        
+        // Reads: an element in arg1/arg2 (branches compare arg2 with result,
+        // AFFICHER's arg1 is the message text)
+        int arg1_value = -1, arg2_value = -1;
+        if (is_array_access(q->arg1) && !is_branch_instruction(q->op) && strcmp(q->op, "AFFICHER") != 0) {
+            arg1_value = element_read(&t, q->arg1, q->op);
+        }
+        if (is_array_access(q->arg2)) {
+            arg2_value = element_read(&t, q->arg2, q->op);
+        }
+        if (is_branch_instruction(q->op)) {
+            if (is_array_access(q->result)) element_read(&t, q->result, q->op);
+            continue;
+        }
+        if (q->result[0] == '\0') {
+            continue;
+        }
+        
+        // Value written by the quadruple (-1 if unknown)
+        int value = -1;
+        int arithmetic = q->op[1] == '\0' && strchr("+-*/%", q->op[0]) != NULL;
+        if (strcmp(q->op, ":=") == 0 && q->arg2[0] == '\0') {
+            value = arg1_value >= 0 ? arg1_value : vn_operand(&t, q->arg1);
+        } else if (arithmetic) {
+            int left = arg1_value >= 0 ? arg1_value : vn_operand(&t, q->arg1);
+            int right = arg2_value >= 0 ? arg2_value : vn_operand(&t, q->arg2);
+            value = vn_expression(&t, q->op, left, right);
+        }
+        
+        if (is_array_access(q->result)) {
+            char array[32] = {0};
+            if (value < 0) {
+                // Block operations and reads into elements: forget the whole array
+                sscanf(q->result, "%31[^[]", array);
+                element_kill(&t, array, -1);
+                continue;
+            }
+            int index = element_index(&t, q->result, array);
+            element_kill(&t, array, index);
+            element_record(&t, array, index, value, is_array_access(q->arg1) ? NULL : q->arg1);
+        } else {
+            vn_set_name(&t, q->result, value >= 0 ? value : vn_new(&t, VN_EXPR, -1, 0, "", -1, -1));
+            
+            // A loaded element is now held by the result (unless the load
+            // was only kept for uses copy propagation already replaced)
+            if (arg1_value >= 0 && strcmp(q->op, ":=") == 0 && loaded_value_read_later(quads, quad_count, i)) {
+                char array[32] = {0};
+                char element[32];
+                strcpy(element, quads[i].arg1);
+                if (is_array_access(element)) {
+                    int index = element_index(&t, element, array);
+                    element_record(&t, array, index, value, q->result);
+                }
+            }
+        }
+    }
+    
+    free(t.numbers);
+    free(t.names);
+    free(t.name_numbers);
+    free(t.elements);
+}
+
+// Perform code compaction
+// A more direct compaction function
+static void perform_code_compaction(Quadruplet* quads, int *quad_count_ptr) {
+    int original_count = *quad_count_ptr;
+    
+    // Print the first 10 quadruples to debug
+    //printf("DEBUG: First 10 operators before compaction:\n");
+    //for (int i = 0; i < 40 && i < original_count; i++) {
+     //   printf("  [%d] op='%s'\n", i, quads[i].op);
+    //}
+    
+    // Count NOPs first
+    int nop_count = 0;
+    for (int i = 0; i < original_count; i++) {
+        if (strcmp(quads[i].op, "NOP") == 0) {
+            nop_count++;
+        }
+    }
+    
+    //printf("DEBUG: Found %d NOPs out of %d quadruples\n", nop_count, original_count);
+    
+    // If no NOPs found, nothing to do
+    if (nop_count == 0) {
+        printf("No NOPs found, no compaction needed.\n");
+        return;
+    }
+    
+    int write_idx = 0;
+    
+    // Compact the array
+    for (int read_idx = 0; read_idx < original_count; read_idx++) {
+        if (strcmp(quads[read_idx].op, "NOP") != 0) {
+            // Only copy if positions differ
+            if (write_idx != read_idx) {
+                // Copy the quadruple
+                memcpy(&quads[write_idx], &quads[read_idx], sizeof(Quadruplet));
+            }
+            // Update the ID
+            quads[write_idx].id = write_idx;
+            write_idx++;
+        }
+    }
+    
+    printf("Code compaction removed %d NOPs. Quadruple count reduced from %d to %d.\n", 
+           nop_count, original_count, write_idx);
+    
+    // Update the count
+    *quad_count_ptr = write_idx;
+    
+    // Update statistics
+    opt_stats.nops_eliminated = nop_count;
+}
+
+
+// Simple unused variable cleanup based on symbol table contents
+// Updated unused variable cleanup function that works on final IR
+static void perform_unused_variable_cleanup(Quadruplet* quads, int quad_count) {
+    printf("Checking for unused variables in final IR...\n");
+    
+    // Get all symbols from the symbol table
+    int symbol_count = symboltable_get_count();
+    
+    // First collect all variables used in the final IR
+    char used_vars[1000][32] = {{0}};
+    int used_count = 0;
+    
+    // Helper function to add to used list
+    void add_to_used(const char* var) {
+        if (!var || var[0] == '\0' || isdigit(var[0]) || var[0] == '-' || 
+            (var[0] == 'L' && isdigit(var[1])) || strcmp(var, "$") == 0) {
+            return;  // Skip literals, labels, etc.
+        }
+        
+        // Check if already in list
+        for (int i = 0; i < used_count; i++) {
+            if (strcmp(used_vars[i], var) == 0) {
+                return;  // Already in list
+            }
+        }
+        
+        // Add to list
+        if (used_count < 1000) {
+            strcpy(used_vars[used_count], var);
+            used_count++;
+        }
+    }
+    
+    // Helper for array notation
+    void check_array_notation(const char* expr) {
+        if (!expr || !strchr(expr, '[')) return;
+        
+        char name[32] = {0};
+        char index[32] = {0};
+        
+        sscanf(expr, "%[^[]", name);
+        add_to_used(name);
+        
+        if (sscanf(expr, "%*[^[][%[^]]", index) == 1) {
+            add_to_used(index);
+        }
+    }
+    
+    // Scan the FINAL IR for all variable references
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = &quads[i];
+        
+        // Handle array references
+        if (strchr(q->arg1, '[')) check_array_notation(q->arg1);
+        if (strchr(q->arg2, '[')) check_array_notation(q->arg2);
+        if (strchr(q->result, '[')) check_array_notation(q->result);
+        
+        // Handle direct references
+        if (strcmp(q->op, "AFFICHER") == 0 || strcmp(q->op, "LIRE") == 0) {
+            // Skip arg1 for I/O operations
+            add_to_used(q->arg2);
+            add_to_used(q->result);
+        } else {
+            add_to_used(q->arg1);
+            add_to_used(q->arg2);
+            add_to_used(q->result);
+        }
+    }
+    
+    printf("Found %d variables used in final IR\n", used_count);
+    
+    // Now check each symbol to see if it's used
+    int removed_count = 0;
+    for (int i = 0; i < symbol_count; i++) {
+        SymbolNode* symbol = symboltable_get_by_index(i);
+        if (!symbol) continue;
+        
+        // Skip certain types (e.g., constants might not be directly referenced)
+        if (symbol->category != CATEGORY_VARIABLE && 
+            symbol->category != CATEGORY_TEMP) {
+            continue;
+        }
+        
+        // Check if this symbol is used in final IR
+        int is_used = 0;
+        for (int j = 0; j < used_count; j++) {
+            if (strcmp(symbol->name, used_vars[j]) == 0) {
+                is_used = 1;
+                break;
             }
         }
         
@@ -871,6 +2536,11 @@ int optimizer_run_pass(OptimizationPass pass, const char* input_file, const char
             perform_common_subexpr_elimination(quads, quad_count);
             break;
         
+        case OPT_PASS_ARRAY_ELEMENT_CSE:
+            printf("Running array element CSE pass...\n");
+            perform_array_element_cse(quads, quad_count);
+            break;
+        
         case OPT_PASS_DEAD_CODE_ELIMINATION:
             printf("Running dead code elimination pass...\n");
             perform_dead_code_elimination(quads, quad_count);
@@ -881,6 +2551,36 @@ int optimizer_run_pass(OptimizationPass pass, const char* input_file, const char
             perform_algebraic_simplifications(quads, quad_count);
             break;
 
+        case OPT_PASS_BRANCH_SIMPLIFICATION:
+            printf("Running branch simplification pass...\n");
+            perform_branch_simplification(quads, quad_count);
+            break;
+
+        case OPT_PASS_LOOP_IDIOMS:
+            printf("Running loop idiom recognition pass...\n");
+            perform_loop_idiom_recognition(&quads, &quad_count);
+            break;
+
+        case OPT_PASS_LOOP_UNROLLING:
+            printf("Running loop unrolling pass...\n");
+            perform_loop_unrolling(&quads, &quad_count);
+            break;
+
+        case OPT_PASS_BLOCK_LAYOUT:
+            printf("Running block layout pass...\n");
+            perform_block_layout(&quads, &quad_count);
+            break;
+
+        case OPT_PASS_RANGE_CHECK_ELIMINATION:
+            printf("Running range check elimination pass...\n");
+            perform_range_check_elimination(quads, quad_count);
+            break;
+
+        case OPT_PASS_RESULT_FORWARDING:
+            printf("Running result forwarding pass...\n");
+            perform_result_forwarding(quads, quad_count);
+            break;
+
         case OPT_PASS_CODE_COMPACTION:
             printf("Running code compaction pass...\n");
             perform_code_compaction(quads, &quad_count);
@@ -937,28 +2637,55 @@ int optimizer_run_pass(OptimizationPass pass, const char* input_file, const char
     }
     
     // Run all optimization passes in memory
-    printf("Running optimization pass 1/8: Copy Propagation\n");
-    perform_copy_propagation(quads, quad_count);
+    printf("Running optimization pass 1/14: Branch Simplification\n");
+    perform_branch_simplification(quads, quad_count);
+    
+    printf("Running optimization pass 2/14: Loop Idiom Recognition\n");
+    perform_loop_idiom_recognition(&quads, &quad_count);
+    
+    printf("Running optimization pass 3/14: Loop Unrolling\n");
+    perform_loop_unrolling(&quads, &quad_count);
     
-    printf("Running optimization pass 2/8: Constant Folding\n");
-    perform_constant_folding(quads, quad_count);
+    printf("Running optimization pass 4/14: Copy Propagation\n");
+    perform_copy_propagation(quads, quad_count);
     
-    printf("Running optimization pass 3/8: Constant Propagation\n");
-    perform_constant_propagation(quads, quad_count);
+    // Folding and propagation feed each other (unrolled loop counters in particular)
+    printf("Running optimization pass 5/14: Constant Folding and Propagation\n");
+    for (int round = 0; round < 8; round++) {
+        int before = opt_stats.constants_folded + opt_stats.constants_propagated;
+        perform_constant_folding(quads, quad_count);
+        perform_constant_propagation(quads, quad_count);
+        if (opt_stats.constants_folded + opt_stats.constants_propagated == before) {
+            break;
+        }
+    }
     
-    printf("Running optimization pass 4/8: Common Subexpression Elimination\n");
+    printf("Running optimization pass 6/14: Common Subexpression Elimination\n");
     perform_common_subexpr_elimination(quads, quad_count);
     
-    printf("Running optimization pass 5/8: Algebraic Simplification\n");
+    printf("Running optimization pass 7/14: Array Element CSE\n");
+    perform_array_element_cse(quads, quad_count);
+    
+    printf("Running optimization pass 8/14: Algebraic Simplification\n");
     perform_algebraic_simplifications(quads, quad_count);
     
-    printf("Running optimization pass 6/8: Dead Code Elimination\n");
+    printf("Running optimization pass 9/14: Result Forwarding\n");
+    perform_result_forwarding(quads, quad_count);
+    
+    printf("Running optimization pass 10/14: Range Check Elimination\n");
+    perform_range_check_elimination(quads, quad_count);
+    
+    printf("Running optimization pass 11/14: Dead Code Elimination\n");
     perform_dead_code_elimination(quads, quad_count);
     
-    printf("Running optimization pass 7/8: Code Compaction\n");
+    // Last of the rewrites, so the moved regions hold their final code
+    printf("Running optimization pass 12/14: Profile-Guided Block Layout\n");
+    perform_block_layout(&quads, &quad_count);
+    
+    printf("Running optimization pass 13/14: Code Compaction\n");
     perform_code_compaction(quads, &quad_count);
     
-    printf("Running optimization pass 8/8: Unused Variable Cleanup\n");
+    printf("Running optimization pass 14/14: Unused Variable Cleanup\n");
     perform_unused_variable_cleanup(quads, quad_count);
     
     // Clear quadgen and regenerate the compacted code
@@ -990,15 +2717,29 @@ int optimizer_run_pass(OptimizationPass pass, const char* input_file, const char
      printf("Constants propagated:             %d\n", opt_stats.constants_propagated);
      printf("Common subexpressions eliminated: %d\n", opt_stats.common_subexprs_eliminated);
      printf("Dead code eliminated:             %d\n", opt_stats.dead_code_eliminated);
+     printf("Array accesses reused:            %d\n", opt_stats.array_accesses_reused);
      printf("Algebraic simplifications:        %d\n", opt_stats.algebraic_simplifications);
+     printf("Results forwarded:                %d\n", opt_stats.results_forwarded);
+     printf("Branches simplified:              %d\n", opt_stats.branches_simplified);
+     printf("Loop idioms replaced:             %d\n", opt_stats.loop_idioms_replaced);
+     printf("Range checks removed:             %d\n", opt_stats.bounds_checks_removed);
+     printf("Loops unrolled:                   %d\n", opt_stats.loops_unrolled);
+     printf("Blocks moved out of line:         %d\n", opt_stats.blocks_moved);
      printf("NOPs eliminated (compacted):      %d\n", opt_stats.nops_eliminated);
      printf("Total optimizations:              %d\n", 
             opt_stats.copies_propagated + 
             opt_stats.constants_folded + 
             opt_stats.constants_propagated + 
             opt_stats.common_subexprs_eliminated +
+            opt_stats.array_accesses_reused +
             opt_stats.dead_code_eliminated +
             opt_stats.algebraic_simplifications +
+            opt_stats.results_forwarded +
+            opt_stats.branches_simplified +
+            opt_stats.loop_idioms_replaced +
+            opt_stats.bounds_checks_removed +
+            opt_stats.loops_unrolled +
+            opt_stats.blocks_moved +
             opt_stats.nops_eliminated);//
      printf("*******************************************\n\n");
  }
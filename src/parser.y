@@ -36,6 +36,7 @@ int yyerror(const char* s);
     ConditionAttrs* cond; // Condition attributes
     PatchList* patch;    // Patch list for backpatching
     AssignmentTarget* target; // For left-side variables
+    Operand operand;     // Typed expression value
 }
 
 
@@ -63,7 +64,8 @@ int yyerror(const char* s);
 /* Non-terminal types */
 %type <str> program data_section code_section
 %type <type> type
-%type <str> id_list variable expression term factor
+%type <str> id_list
+%type <operand> variable expression term factor
 %type <str> declaration var_declaration const_declaration array_declaration
 %type <str> statement statement_list assignment
 %type <cond> condition
@@ -156,32 +158,20 @@ const_declaration:
     CONST COLON IDENTIFIER ASSIGN INT_LITERAL SEMICOLON {
         int value = $5;
         symboltable_insert_constant($3, TYPE_INTEGER, &value, current_line, current_column);
-        char value_str[32];
-        sprintf(value_str, "%d", $5);
-        quadgen_generate(":=", value_str, "", $3);
         $$ = "";
     }
     | CONST COLON IDENTIFIER ASSIGN FLOAT_LITERAL SEMICOLON {
         float value = $5;
         symboltable_insert_constant($3, TYPE_FLOAT, &value, current_line, current_column);
-        char value_str[32];
-        sprintf(value_str, "%f", $5);
-        quadgen_generate(":=", value_str, "", $3);
         $$ = "";
     }
     | CONST COLON IDENTIFIER ASSIGN CHAR_LITERAL SEMICOLON {
         char value = $5;
         symboltable_insert_constant($3, TYPE_CHAR, &value, current_line, current_column);
-        char value_str[8];
-        sprintf(value_str, "'%c'", $5);
-        quadgen_generate(":=", value_str, "", $3);
         $$ = "";
     }
     | CONST COLON IDENTIFIER ASSIGN STRING_LITERAL SEMICOLON {
         symboltable_insert_constant($3, TYPE_STRING, $5, current_line, current_column);
-        char value_str[256];
-        sprintf(value_str, "\"%s\"", $5);
-        quadgen_generate(":=", value_str, "", $3);
         $$ = "";
     }
     ;
@@ -229,7 +219,6 @@ assignment:
         }
         
         free(target->name);
-        if (target->index) free(target->index);
         free(target);
         
         $$ = "";
@@ -242,7 +231,7 @@ variable_left:
         // Create a structure to hold assignment target info
         AssignmentTarget* target = malloc(sizeof(AssignmentTarget));
         target->name = safe_strdup($1);
-        target->index = NULL;
+        target->index = operand_error(NULL);
         target->is_array = 0;
         $$ = target;
     }
@@ -250,7 +239,7 @@ variable_left:
         // Create structure with array info
         AssignmentTarget* target = malloc(sizeof(AssignmentTarget));
         target->name = safe_strdup($1);
-        target->index = safe_strdup($3);
+        target->index = $3;
         target->is_array = 1;
         $$ = target;
     }
@@ -269,11 +258,11 @@ variable:
 expression:
     term { $$ = $1; }
     | expression PLUS term {
-        SymbolType result_type = check_arithmetic_types("+", $1, $3);
+        SymbolType result_type = check_arithmetic_types("+", &$1, &$3);
         $$ = gen_expr_quad("+", $1, $3, result_type);
     }
     | expression MINUS term {
-        SymbolType result_type = check_arithmetic_types("-", $1, $3);
+        SymbolType result_type = check_arithmetic_types("-", &$1, &$3);
         $$ = gen_expr_quad("-", $1, $3, result_type);
     }
     ;
@@ -281,41 +270,33 @@ expression:
 term:
     factor { $$ = $1; }
     | term MULT factor {
-        SymbolType result_type = check_arithmetic_types("*", $1, $3);
+        SymbolType result_type = check_arithmetic_types("*", &$1, &$3);
         $$ = gen_expr_quad("*", $1, $3, result_type);
     }
     | term DIV factor {
-        SymbolType result_type = check_arithmetic_types("/", $1, $3);
+        SymbolType result_type = check_arithmetic_types("/", &$1, &$3);
         $$ = gen_expr_quad("/", $1, $3, result_type);
     }
     | term MOD factor {
         // Modulo only works on integers
-        SymbolType result_type = check_arithmetic_types("%", $1, $3);
+        SymbolType result_type = check_arithmetic_types("%", &$1, &$3);
         $$ = gen_expr_quad("%", $1, $3, result_type);
     }
     ;
 
 factor:
-    variable { $$ = $1; }
+    variable { $$ = operand_fold_constant($1); }
     | INT_LITERAL {
-        char temp[32];
-        sprintf(temp, "%d", $1);
-        $$ = process_literal(temp, TYPE_INTEGER);
+        $$ = operand_int($1);
     }
     | FLOAT_LITERAL {
-        char temp[32];
-        sprintf(temp, "%f", $1);
-        $$ = process_literal(temp, TYPE_FLOAT);
+        $$ = operand_float($1);
     }
     | CHAR_LITERAL {
-        char temp[4];
-        sprintf(temp, "'%c'", $1);
-        $$ = process_literal(temp, TYPE_CHAR);
+        $$ = operand_char($1);
     }
     | STRING_LITERAL {
-        char temp[256];
-        sprintf(temp, "\"%s\"", $1);
-        $$ = process_literal(temp, TYPE_STRING);
+        $$ = operand_string($1);
     }
     | LPAREN expression RPAREN {
         $$ = $2;
@@ -385,6 +366,7 @@ optional_else:
 
 loop_statement:
     for_statement { $$ = $1; }
+    | while_statement { $$ = $1; }
     ;
 
 for_statement:
@@ -397,7 +379,7 @@ for_statement:
         begin_for_loop_condition($8);
     }
     statement_list {
-        // Generate increment, jump back and end label
+        // Generate increment, bottom test and end label
         end_for_loop();
     }
     END {
@@ -406,8 +388,19 @@ for_statement:
     ;
 
 while_statement:
-    WHILE LPAREN condition RPAREN statement_list END {
-        process_while_loop($3);
+    WHILE LPAREN {
+        // The condition code that follows is the loop guard
+        begin_while_loop();
+    }
+    condition RPAREN {
+        // Generate condition checking code
+        begin_while_loop_body($4);
+    }
+    statement_list {
+        // Generate bottom test and end label
+        end_while_loop();
+    }
+    END {
         $$ = NULL;
     }
     ;
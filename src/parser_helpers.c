@@ -27,35 +27,233 @@
      return TYPE_UNKNOWN;
  }
  
- // Process a literal expression
- char* process_literal(const char* literal_str, SymbolType type) {
-     // Create a temporary symbol to hold the literal
-     SymbolNode* temp = symboltable_create_temp(type);
-     if (!temp) {
-         parser_semantic_error("Failed to create temporary for literal");
-         return safe_strdup("ERROR");
+ // Build an operand referring to a symbol table entry
+ Operand operand_symbol(SymbolNode* node) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_SYMBOL;
+     operand.type = node->type;
+     operand.symbol = node;
+     operand.name = node->name;
+     return operand;
+ }
+ 
+ // Build an integer immediate
+ Operand operand_int(int value) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_IMMEDIATE;
+     operand.type = TYPE_INTEGER;
+     operand.imm.int_value = value;
+     return operand;
+ }
+ 
+ // Build a float immediate
+ Operand operand_float(float value) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_IMMEDIATE;
+     operand.type = TYPE_FLOAT;
+     operand.imm.float_value = value;
+     return operand;
+ }
+ 
+ // Build a character immediate
+ Operand operand_char(char value) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_IMMEDIATE;
+     operand.type = TYPE_CHAR;
+     operand.imm.char_value = value;
+     return operand;
+ }
+ 
+ // Build a string immediate (the text is not copied)
+ Operand operand_string(const char* value) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_IMMEDIATE;
+     operand.type = TYPE_STRING;
+     operand.imm.string_value = value;
+     return operand;
+ }
+ 
+ // Replace an initialized constant by its value, so constants never need storage
+ Operand operand_fold_constant(Operand operand) {
+     if (operand.kind != OPERAND_SYMBOL || operand.symbol->category != CATEGORY_CONSTANT ||
+         !operand.symbol->is_initialized) {
+         return operand;
+     }
+     switch (operand.symbol->type) {
+         case TYPE_INTEGER: return operand_int(operand.symbol->value.int_value);
+         case TYPE_FLOAT:   return operand_float(operand.symbol->value.float_value);
+         case TYPE_CHAR:    return operand_char(operand.symbol->value.char_value);
+         case TYPE_STRING:  return operand_string(operand.symbol->value.string_value);
+         default:           return operand;
+     }
+ }
+ 
+ // Build an operand for a missing or erroneous value
+ Operand operand_error(const char* name) {
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_NONE;
+     operand.type = TYPE_UNKNOWN;
+     operand.name = name ? name : "ERROR";
+     return operand;
+ }
+ 
+ // Format an operand the way it appears in a quadruple
+ const char* operand_text(const Operand* operand, char* buffer, size_t size) {
+     if (operand->kind != OPERAND_IMMEDIATE) {
+         snprintf(buffer, size, "%s", operand->name);
+         return buffer;
      }
      
-     // Set the value based on the type
-     if (type == TYPE_INTEGER) {
-         int value = string_to_int(literal_str);
-         symboltable_set_value(temp, &value);
-     } else if (type == TYPE_FLOAT) {
-         float value = string_to_float(literal_str);
-         symboltable_set_value(temp, &value);
+     switch (operand->type) {
+         case TYPE_INTEGER:
+             snprintf(buffer, size, "%d", operand->imm.int_value);
+             break;
+         case TYPE_FLOAT:
+             format_float(buffer, size, operand->imm.float_value);
+             break;
+         case TYPE_CHAR:
+             snprintf(buffer, size, "'%c'", operand->imm.char_value);
+             break;
+         case TYPE_STRING:
+             snprintf(buffer, size, "\"%s\"", operand->imm.string_value);
+             break;
+         default:
+             snprintf(buffer, size, "0");
+             break;
+     }
+     return buffer;
+ }
+ 
+ // Node of the expression DAG. Arithmetic, conversions and element reads are
+ // recorded while an expression is parsed and lowered to quadruples only when a
+ // statement uses the value: a subexpression repeated in the statement is
+ // emitted once, and the operand needing more temporaries is evaluated first
+ // (Sethi-Ullman order), so fewer temporaries are live at the same time.
+ typedef struct ExprNode {
+     const char* op;            // "+", "-", "*", "/", "%", "CONVERT", "[]", or NULL for a leaf
+     SymbolType type;           // Type of the value
+     Operand leaf;              // Leaf value (symbol or immediate)
+     SymbolNode* array;         // Array read by "[]"
+     struct ExprNode* left;     // First operand, converted value or element index
+     struct ExprNode* right;    // Second operand
+     int need;                  // Temporaries live while evaluating it (Sethi-Ullman number)
+     int lowered;               // Set once its quadruples are emitted
+     Operand value;             // Where the value is once lowered
+     struct ExprNode* next;     // Nodes of the current statement
+ } ExprNode;
+ 
+ static ExprNode* expr_nodes = NULL;
+ 
+ // Same leaf value (erroneous operands are never shared)
+ static int same_leaf(const Operand* a, const Operand* b) {
+     if (a->kind != b->kind || a->type != b->type) {
+         return 0;
+     }
+     if (a->kind == OPERAND_SYMBOL) {
+         return a->symbol == b->symbol;
+     }
+     if (a->kind != OPERAND_IMMEDIATE) {
+         return 0;
+     }
+     switch (a->type) {
+         case TYPE_INTEGER: return a->imm.int_value == b->imm.int_value;
+         case TYPE_FLOAT:   return a->imm.float_value == b->imm.float_value;
+         case TYPE_CHAR:    return a->imm.char_value == b->imm.char_value;
+         case TYPE_STRING:  return a->imm.string_value == b->imm.string_value;
+         default:           return 0;
+     }
+ }
+ 
+ // Find or create a DAG node of the current statement
+ static ExprNode* expr_node(const char* op, SymbolType type, const Operand* leaf,
+                            SymbolNode* array, ExprNode* left, ExprNode* right) {
+     for (ExprNode* node = expr_nodes; node; node = node->next) {
+         if (node->type != type || node->array != array || node->left != left || node->right != right) {
+             continue;
+         }
+         if (op ? (node->op && strcmp(node->op, op) == 0) : (!node->op && same_leaf(&node->leaf, leaf))) {
+             return node;
+         }
      }
      
-     // Generate assignment of the literal to the temporary
-     quadgen_generate(":=", literal_str, "", temp->name);
+     ExprNode* node = (ExprNode*)safe_malloc(sizeof(ExprNode));
+     memset(node, 0, sizeof(ExprNode));
+     node->op = op;
+     node->type = type;
+     if (leaf) {
+         node->leaf = *leaf;
+     }
+     node->array = array;
+     node->left = left;
+     node->right = right;
+     if (left && right) {
+         node->need = left->need == right->need ? left->need + 1 :
+                      left->need > right->need ? left->need : right->need;
+     } else if (left) {
+         node->need = left->need > 1 ? left->need : 1;
+     }
+     node->next = expr_nodes;
+     expr_nodes = node;
+     return node;
+ }
+ 
+ // DAG node of an operand
+ static ExprNode* expr_leaf(Operand value) {
+     if (value.kind == OPERAND_EXPR) {
+         return value.expr;
+     }
+     return expr_node(NULL, get_expression_type(&value), &value, NULL, NULL, NULL);
+ }
+ 
+ // Operand standing for a DAG node
+ static Operand operand_expr(ExprNode* node) {
+     if (!node->op) {
+         return node->leaf;
+     }
+     Operand operand;
+     memset(&operand, 0, sizeof(operand));
+     operand.kind = OPERAND_EXPR;
+     operand.type = node->type;
+     operand.name = "expression";
+     operand.expr = node;
+     return operand;
+ }
+ 
+ // Forget the DAG once a statement has lowered the values it uses
+ static void expr_dag_reset(void) {
+     while (expr_nodes) {
+         ExprNode* next = expr_nodes->next;
+         free(expr_nodes);
+         expr_nodes = next;
+     }
+ }
+ 
+ // Convert an operand to another type, returning the converted operand
+ static Operand convert_operand(Operand value, SymbolType target_type) {
+     // Numeric immediates are converted at compile time
+     if (value.kind == OPERAND_IMMEDIATE) {
+         if (value.type == TYPE_INTEGER && target_type == TYPE_FLOAT) {
+             return operand_float((float)value.imm.int_value);
+         }
+         if (value.type == TYPE_FLOAT && target_type == TYPE_INTEGER) {
+             return operand_int((int)value.imm.float_value);
+         }
+     }
      
-     return safe_strdup(temp->name);
+     return operand_expr(expr_node("CONVERT", target_type, NULL, NULL, expr_leaf(value), NULL));
  }
  
- // Helper function to create an expression temp and generate quad
- char* gen_expr_quad(const char* op, const char* arg1, const char* arg2, SymbolType result_type) {
+ // Helper function to record an arithmetic operation in the expression DAG
+ Operand gen_expr_quad(const char* op, Operand arg1, Operand arg2, SymbolType result_type) {
      // Check if the operation is valid for the operand types
-     SymbolType type1 = get_expression_type(arg1);
-     SymbolType type2 = get_expression_type(arg2);
+     SymbolType type1 = get_expression_type(&arg1);
+     SymbolType type2 = get_expression_type(&arg2);
      
      // Special case for modulo: both operands must be integers
      if (strcmp(op, "%") == 0) {
@@ -66,91 +264,32 @@
          }
      }
      
-     // Create a new temporary for the result
-     SymbolNode* temp = symboltable_create_temp(result_type);
-     if (!temp) {
-         parser_semantic_error("Failed to create temporary variable");
-         return safe_strdup("ERROR");
-     }
-     
-     // Check if type conversion is needed for operands
-     char* converted_arg1 = safe_strdup(arg1);
-     char* converted_arg2 = safe_strdup(arg2);
-     
-     // Convert arg1 if needed
+     // Convert the operands if needed
      if (type1 != TYPE_UNKNOWN && result_type != TYPE_UNKNOWN && type1 != result_type) {
-         // Need conversion - create a temporary and conversion quad
-         SymbolNode* conv_temp = symboltable_create_temp(result_type);
-         quadgen_generate("CONVERT", arg1, symboltable_type_to_string(result_type), conv_temp->name);
-         free(converted_arg1);
-         converted_arg1 = safe_strdup(conv_temp->name);
+         arg1 = convert_operand(arg1, result_type);
      }
-     
-     // Convert arg2 if needed
      if (type2 != TYPE_UNKNOWN && result_type != TYPE_UNKNOWN && type2 != result_type) {
-         // Need conversion - create a temporary and conversion quad
-         SymbolNode* conv_temp = symboltable_create_temp(result_type);
-         quadgen_generate("CONVERT", arg2, symboltable_type_to_string(result_type), conv_temp->name);
-         free(converted_arg2);
-         converted_arg2 = safe_strdup(conv_temp->name);
+         arg2 = convert_operand(arg2, result_type);
      }
      
-     // Generate the quadruplet with possibly converted operands
-     quadgen_generate(op, converted_arg1, converted_arg2, temp->name);
-     
-     // Free temporary strings
-     free(converted_arg1);
-     free(converted_arg2);
-     
-     // Mark temporary as initialized
-     symboltable_set_initialized(temp);
-     
-     return safe_strdup(temp->name);
+     // The quadruple is generated when a statement uses the value
+     return operand_expr(expr_node(op, result_type, NULL, NULL, expr_leaf(arg1), expr_leaf(arg2)));
  }
  
- // Check types for arithmetic operations
- SymbolType check_arithmetic_types(const char* op, const char* arg1, const char* arg2) {
-     SymbolNode *node1 = NULL, *node2 = NULL;
-     SymbolType type1 = TYPE_UNKNOWN, type2 = TYPE_UNKNOWN;
-     
-     // Get the types of both operands
-     if (is_integer_literal(arg1)) {
-         type1 = TYPE_INTEGER;
-     } else if (is_float_literal(arg1)) {
-         type1 = TYPE_FLOAT;
-     } else {
-         node1 = symboltable_lookup(arg1);
-         if (node1) {
-             // For constants, make sure we use INTEGER type
-             if (node1->category == CATEGORY_CONSTANT) {
-                 if (node1->is_initialized) {
-                     // Determine type based on the actual value
-                     type1 = node1->type;  // Use the actual type of the constant
-                 }
-             } else {
-                 type1 = node1->type;
-             }
-         }
-     }
-     
-     if (is_integer_literal(arg2)) {
-         type2 = TYPE_INTEGER;
-     } else if (is_float_literal(arg2)) {
-         type2 = TYPE_FLOAT;
-     } else {
-         node2 = symboltable_lookup(arg2);
-         if (node2) {
-             // For constants, make sure we use INTEGER type
-             if (node2->category == CATEGORY_CONSTANT) {
-                 if (node2->is_initialized) {
-                     // Determine type based on the actual value
-                     type2 = node2->type;  // Use the actual type of the constant
-                 }
-             } else {
-                 type2 = node2->type;
-             }
-         }
+ // Type of an operand for arithmetic (uninitialized constants are unknown)
+ static SymbolType arithmetic_operand_type(const Operand* operand) {
+     if (operand->kind == OPERAND_SYMBOL &&
+         operand->symbol->category == CATEGORY_CONSTANT &&
+         !operand->symbol->is_initialized) {
+         return TYPE_UNKNOWN;
      }
+     return get_expression_type(operand);
+ }
+ 
+ // Check types for arithmetic operations
+ SymbolType check_arithmetic_types(const char* op, const Operand* arg1, const Operand* arg2) {
+     SymbolType type1 = arithmetic_operand_type(arg1);
+     SymbolType type2 = arithmetic_operand_type(arg2);
      
      // Special case: If both types are UNKNOWN, assume INTEGER type
      if (type1 == TYPE_UNKNOWN && type2 == TYPE_UNKNOWN) {
@@ -185,16 +324,16 @@
  }
  
  // Helper function for evaluating integer expressions
- int eval_int_expr(const char* expr) {
-     // If it's a direct integer literal, convert and return
-     if (is_integer_literal(expr)) {
-         return string_to_int(expr);
+ int eval_int_expr(const Operand* expr) {
+     // If it's a direct integer literal, return its value
+     if (expr->kind == OPERAND_IMMEDIATE && expr->type == TYPE_INTEGER) {
+         return expr->imm.int_value;
      }
      
-     // Try to lookup in the symbol table
-     SymbolNode* node = symboltable_lookup(expr);
-     if (node && node->type == TYPE_INTEGER && node->is_initialized) {
-         return node->value.int_value;
+     // Initialized integer symbols (constants) have a known value
+     if (expr->kind == OPERAND_SYMBOL && expr->symbol->type == TYPE_INTEGER &&
+         expr->symbol->is_initialized) {
+         return expr->symbol->value.int_value;
      }
      
      // Cannot evaluate
@@ -203,16 +342,16 @@
  }
  
  // Helper function for evaluating float expressions
- float eval_float_expr(const char* expr) {
-     // If it's a direct float literal, convert and return
-     if (is_float_literal(expr)) {
-         return string_to_float(expr);
+ float eval_float_expr(const Operand* expr) {
+     // If it's a direct float literal, return its value
+     if (expr->kind == OPERAND_IMMEDIATE && expr->type == TYPE_FLOAT) {
+         return expr->imm.float_value;
      }
      
-     // Try to lookup in the symbol table
-     SymbolNode* node = symboltable_lookup(expr);
-     if (node && node->type == TYPE_FLOAT && node->is_initialized) {
-         return node->value.float_value;
+     // Initialized float symbols (constants) have a known value
+     if (expr->kind == OPERAND_SYMBOL && expr->symbol->type == TYPE_FLOAT &&
+         expr->symbol->is_initialized) {
+         return expr->symbol->value.float_value;
      }
      
      // Cannot evaluate
@@ -308,19 +447,14 @@
          return;
      }
      
-     // Create temporary variables for bounds if needed for quadruples
-     SymbolNode* temp_lower = symboltable_create_temp(TYPE_INTEGER);
+     // Bounds are literal operands of the BOUNDS quadruple
      char lower_str[16];
      sprintf(lower_str, "%d", lower_bound);
-     quadgen_generate(":=", lower_str, "", temp_lower->name);
-     
-     SymbolNode* temp_upper = symboltable_create_temp(TYPE_INTEGER);
      char upper_str[16];
      sprintf(upper_str, "%d", upper_bound);
-     quadgen_generate(":=", upper_str, "", temp_upper->name);
      
      // Generate BOUNDS quadruple
-     quadgen_generate("BOUNDS", temp_lower->name, temp_upper->name, "");
+     quadgen_generate("BOUNDS", lower_str, upper_str, "");
      
      // Declare the vector
      quadgen_generate("ADEC", array_name, "", "");
@@ -340,44 +474,45 @@
  }
  
  // Process a variable reference
- char* process_variable(const char* name) {
+ Operand process_variable(const char* name) {
     SymbolNode* node = symboltable_lookup(name);
     if (!node) {
         parser_semantic_error("Undefined variable");
-        // Create a fallback variable to prevent cascading errors
-        //node = symboltable_insert_variable(name, TYPE_INTEGER, current_line, current_column);
+        // Keep the name so later checks can report it
+        return operand_error(name);
     }
-    return safe_strdup(name);
+    return operand_symbol(node);
 }
  
- // Process array access
- char* process_array_access(const char* array_name, const char* index) {
-    // Check if array exists
-    SymbolNode* array_node = symboltable_lookup(array_name);
-    
-    if (!array_node) {
+ // Check an array index against the array, converting it to INTEGER if needed.
+ // Returns 0 if the index expression is undefined.
+ static int check_array_index(SymbolNode* array_node, Operand* index) {
+    if (index->kind == OPERAND_NONE) {
         char error_msg[256];
-        sprintf(error_msg, "Undefined array '%s'", array_name);
+        sprintf(error_msg, "Undefined index expression '%s'", index->name);
         parser_semantic_error(error_msg);
-        // Create a temporary for error recovery
-        SymbolNode* temp = symboltable_create_temp(TYPE_INTEGER);
-        quadgen_generate(":=", "0", "", temp->name); // Set to 0 for recovery
-        symboltable_set_initialized(temp);
-        return safe_strdup(temp->name);
+        return 0;
     }
     
-    if (array_node->category != CATEGORY_ARRAY) {
-        char error_msg[256];
-        sprintf(error_msg, "'%s' is not an array", array_name);
-        parser_semantic_error(error_msg);
-        // Continue with the variable as if it were scalar
-        return safe_strdup(array_name);
+    if (index->type != TYPE_INTEGER) {
+        parser_semantic_error("Array index must be INTEGER");
+        
+        // Try to convert non-integer index to integer if possible
+        if (index->type == TYPE_FLOAT) {
+            *index = convert_operand(*index, TYPE_INTEGER);
+        } else {
+            // For other types, use a default index
+            SymbolNode* default_idx = symboltable_create_temp(TYPE_INTEGER);
+            quadgen_generate(":=", "0", "", default_idx->name);
+            symboltable_set_initialized(default_idx);
+            *index = operand_symbol(default_idx);
+        }
+        return 1;
     }
     
-    // Verify index is an integer expression
-    if (is_integer_literal(index)) {
+    if (index->kind == OPERAND_IMMEDIATE) {
         // Verify constant index is within bounds
-        int idx_val = string_to_int(index);
+        int idx_val = index->imm.int_value;
         if (idx_val < array_node->array_lower_bound || 
             idx_val >= array_node->array_lower_bound + array_node->array_size) {
             char error_msg[256];
@@ -388,64 +523,134 @@
             parser_semantic_error(error_msg);
             // Continue anyway, bounds error will be evident at runtime
         }
-    } 
-    else {
-        // Check variable index type
-        SymbolNode* index_node = symboltable_lookup(index);
-        if (!index_node) {
-            char error_msg[256];
-            sprintf(error_msg, "Undefined index expression '%s'", index);
-            parser_semantic_error(error_msg);
-            // Create a default index for recovery
-            SymbolNode* default_idx = symboltable_create_temp(TYPE_INTEGER);
-            quadgen_generate(":=", "0", "", default_idx->name);
-            symboltable_set_initialized(default_idx);
-            index = default_idx->name;
-        }
-        else if (index_node->type != TYPE_INTEGER) {
-            parser_semantic_error("Array index must be INTEGER");
-            
-            // Try to convert non-integer index to integer if possible
-            if (index_node->type == TYPE_FLOAT) {
-                // Create a conversion temp
-                SymbolNode* int_index = symboltable_create_temp(TYPE_INTEGER);
-                quadgen_generate("CONVERT", index, "INTEGER", int_index->name);
-                symboltable_set_initialized(int_index);
-                index = int_index->name;
-            } else {
-                // For other types, use a default index
-                SymbolNode* default_idx = symboltable_create_temp(TYPE_INTEGER);
-                quadgen_generate(":=", "0", "", default_idx->name);
-                symboltable_set_initialized(default_idx);
-                index = default_idx->name;
-            }
-        }
     }
-    
-    // Get the lower bound of the array
-    int lower_bound = array_node->array_lower_bound;
-    
+    return 1;
+}
+ 
+ // Generate the 0-based index of an element and format the element reference
+ static void format_array_element(const char* array_name, SymbolNode* array_node,
+                                  const Operand* index, char* element, size_t size) {
     // Create a new temporary for the adjusted index
     SymbolNode* adjusted_index = symboltable_create_temp(TYPE_INTEGER);
     symboltable_set_initialized(adjusted_index);
     
     // Generate code to calculate: adjusted_index = index - lower_bound
+    char index_str[OPERAND_TEXT_SIZE];
     char lower_bound_str[16];
-    sprintf(lower_bound_str, "%d", lower_bound);
-    quadgen_generate("-", index, lower_bound_str, adjusted_index->name);
-    
-    // Create temporary to hold array element value
-    SymbolNode* temp = symboltable_create_temp(array_node->type);
+    sprintf(lower_bound_str, "%d", array_node->array_lower_bound);
+    quadgen_generate("-", operand_text(index, index_str, sizeof(index_str)),
+                     lower_bound_str, adjusted_index->name);
     
     // Format array access according to quadruple format - use adjusted index
-    char array_access[256];
-    sprintf(array_access, "%s[%s]", array_name, adjusted_index->name);
+    snprintf(element, size, "%s[%s]", array_name, adjusted_index->name);
+    
+    // Indexes only known at run time get a range check: BOUNDS element, size
+    if (index->kind != OPERAND_IMMEDIATE) {
+        char size_str[16];
+        sprintf(size_str, "%d", array_node->array_size);
+        quadgen_generate("BOUNDS", element, size_str, "");
+    }
+}
+ 
+ // Emit the quadruples of a DAG node (once) and return the operand holding its value
+ static Operand expr_lower(ExprNode* node) {
+     if (!node->op) {
+         return node->leaf;
+     }
+     if (node->lowered) {
+         return node->value;
+     }
+     
+     char arg1_str[OPERAND_TEXT_SIZE], arg2_str[OPERAND_TEXT_SIZE];
+     SymbolNode* temp;
+     if (strcmp(node->op, "[]") == 0) {
+         // Element read: adjusted index, range check, then the load
+         Operand index = expr_lower(node->left);
+         char element[256];
+         format_array_element(node->array->name, node->array, &index, element, sizeof(element));
+         temp = symboltable_create_temp(node->type);
+         quadgen_generate(":=", element, "", temp->name);
+     } else if (strcmp(node->op, "CONVERT") == 0) {
+         Operand value = expr_lower(node->left);
+         temp = symboltable_create_temp(node->type);
+         quadgen_generate("CONVERT", operand_text(&value, arg1_str, sizeof(arg1_str)),
+                          get_type_name(node->type), temp->name);
+     } else {
+         // The operand needing more temporaries first, the left one on a tie
+         Operand arg1, arg2;
+         if (node->right->need > node->left->need) {
+             arg2 = expr_lower(node->right);
+             arg1 = expr_lower(node->left);
+         } else {
+             arg1 = expr_lower(node->left);
+             arg2 = expr_lower(node->right);
+         }
+         temp = symboltable_create_temp(node->type);
+         quadgen_generate(node->op, operand_text(&arg1, arg1_str, sizeof(arg1_str)),
+                          operand_text(&arg2, arg2_str, sizeof(arg2_str)), temp->name);
+     }
+     symboltable_set_initialized(temp);
+     
+     node->lowered = 1;
+     node->value = operand_symbol(temp);
+     return node->value;
+ }
+ 
+ // Lower the values used by a statement, in Sethi-Ullman order, and start a new DAG
+ static void expr_emit_pair(Operand* first, Operand* second) {
+     ExprNode* a = first->kind == OPERAND_EXPR ? first->expr : NULL;
+     ExprNode* b = second && second->kind == OPERAND_EXPR ? second->expr : NULL;
+     if (a && b && b->need > a->need) {
+         *second = expr_lower(b);
+         *first = expr_lower(a);
+     } else {
+         if (a) *first = expr_lower(a);
+         if (b) *second = expr_lower(b);
+     }
+     expr_dag_reset();
+ }
+ 
+ // Lower the value used by a statement and start a new DAG
+ static Operand expr_emit(Operand value) {
+     expr_emit_pair(&value, NULL);
+     return value;
+ }
+ 
+ // Process array access
+ Operand process_array_access(const char* array_name, Operand index) {
+    // Check if array exists
+    SymbolNode* array_node = symboltable_lookup(array_name);
     
-    // Generate the quadruple
-    quadgen_generate(":=", array_access, "", temp->name);
+    if (!array_node) {
+        char error_msg[256];
+        sprintf(error_msg, "Undefined array '%s'", array_name);
+        parser_semantic_error(error_msg);
+        // Create a temporary for error recovery
+        SymbolNode* temp = symboltable_create_temp(TYPE_INTEGER);
+        quadgen_generate(":=", "0", "", temp->name); // Set to 0 for recovery
+        symboltable_set_initialized(temp);
+        return operand_symbol(temp);
+    }
+    
+    if (array_node->category != CATEGORY_ARRAY) {
+        char error_msg[256];
+        sprintf(error_msg, "'%s' is not an array", array_name);
+        parser_semantic_error(error_msg);
+        // Continue with the variable as if it were scalar
+        return operand_symbol(array_node);
+    }
+    
+    // Verify index is an integer expression
+    if (!check_array_index(array_node, &index)) {
+        // Create a default index for recovery
+        SymbolNode* default_idx = symboltable_create_temp(TYPE_INTEGER);
+        quadgen_generate(":=", "0", "", default_idx->name);
+        symboltable_set_initialized(default_idx);
+        index = operand_symbol(default_idx);
+    }
     
-    symboltable_set_initialized(temp);
-    return safe_strdup(temp->name);
+    // The element is read when a statement uses the value
+    return operand_expr(expr_node("[]", array_node->type, NULL, array_node, expr_leaf(index), NULL));
 }
  
  // Utility function to convert SymbolType to string representation
@@ -461,22 +666,33 @@
  }
  
  // Helper function to determine expression type
- SymbolType get_expression_type(const char* expr) {
-     if (is_integer_literal(expr)) {
-         return TYPE_INTEGER;
-     } else if (is_float_literal(expr)) {
-         return TYPE_FLOAT;
-     } else {
-         SymbolNode* expr_node = symboltable_lookup(expr);
-         if (expr_node) {
-             return expr_node->type;
-         }
+ SymbolType get_expression_type(const Operand* expr) {
+     if (expr->kind == OPERAND_SYMBOL) {
+         return expr->symbol->type;
      }
-     return TYPE_UNKNOWN;
+     return expr->type;
+ }
+ 
+ // Convert a value to the type of the variable or array element storing it
+ static Operand convert_for_store(Operand value, SymbolType destination_type) {
+     SymbolType value_type = get_expression_type(&value);
+     
+     // Check if conversion is needed
+     if (destination_type != value_type && destination_type != TYPE_UNKNOWN && value_type != TYPE_UNKNOWN) {
+         // Need to convert the expression to match the destination type
+         value = convert_operand(value, destination_type);
+     }
+     return value;
+ }
+ 
+ // Store a lowered value into a variable or array element
+ static void store_value(const char* destination, Operand value) {
+     char value_str[OPERAND_TEXT_SIZE];
+     quadgen_generate(":=", operand_text(&value, value_str, sizeof(value_str)), "", destination);
  }
  
  // Function to handle simple variable assignment
- void process_simple_assignment(const char* var_name, const char* expr_value) {
+ void process_simple_assignment(const char* var_name, Operand expr_value) {
      SymbolNode* var_node = symboltable_lookup(var_name);
      
      if (!var_node) {
@@ -495,11 +711,13 @@
      }
      
      // Check for expression type
-     SymbolType expr_type = get_expression_type(expr_value);
+     SymbolType expr_type = get_expression_type(&expr_value);
      
      if (expr_type == TYPE_UNKNOWN) {
          char error_msg[256];
-         sprintf(error_msg, "Undefined expression '%s' in assignment", expr_value);
+         char expr_str[OPERAND_TEXT_SIZE];
+         sprintf(error_msg, "Undefined expression '%s' in assignment",
+                 operand_text(&expr_value, expr_str, sizeof(expr_str)));
          parser_semantic_error(error_msg);
          return;
      }
@@ -513,26 +731,14 @@
          return;
      }
      
-     // Check if conversion is needed
-     if (var_node->type != expr_type && var_node->type != TYPE_UNKNOWN && expr_type != TYPE_UNKNOWN) {
-         // Need to convert the expression to match variable type
-         SymbolNode* converted = symboltable_create_temp(var_node->type);
-         quadgen_generate("CONVERT", expr_value, get_type_name(var_node->type), converted->name);
-         symboltable_set_initialized(converted);
-         
-         // Use the converted value for assignment
-         quadgen_generate(":=", converted->name, "", var_name);
-     } else {
-         // Direct assignment, no conversion needed
-         quadgen_generate(":=", expr_value, "", var_name);
-     }
+     store_value(var_name, expr_emit(convert_for_store(expr_value, var_node->type)));
      
      // Mark variable as initialized
      symboltable_set_initialized(var_node);
  }
  
  // Function to handle array element assignment
-void process_array_assignment(const char* array_name, const char* index, const char* expr_value) {
+void process_array_assignment(const char* array_name, Operand index, Operand expr_value) {
     // Check if array exists
     SymbolNode* array_node = symboltable_lookup(array_name);
     
@@ -551,55 +757,18 @@ void process_array_assignment(const char* array_name, const char* index, const c
     }
     
     // Verify index is valid
-    if (is_integer_literal(index)) {
-        // Verify constant index is within bounds
-        int idx_val = string_to_int(index);
-        if (idx_val < array_node->array_lower_bound || 
-            idx_val >= array_node->array_lower_bound + array_node->array_size) {
-            char error_msg[256];
-            sprintf(error_msg, "Array index %d out of bounds [%d:%d]", 
-                  idx_val, 
-                  array_node->array_lower_bound, 
-                  array_node->array_lower_bound + array_node->array_size - 1);
-            parser_semantic_error(error_msg);
-            // Continue anyway for code generation
-        }
-    } else {
-        // Check variable index type
-        SymbolNode* index_node = symboltable_lookup(index);
-        if (!index_node) {
-            char error_msg[256];
-            sprintf(error_msg, "Undefined index expression '%s'", index);
-            parser_semantic_error(error_msg);
-            return;
-        }
-        else if (index_node->type != TYPE_INTEGER) {
-            parser_semantic_error("Array index must be INTEGER");
-            
-            // Try to convert non-integer index to integer if possible
-            const char* original_index = index;
-            if (index_node->type == TYPE_FLOAT) {
-                // Create a conversion temp
-                SymbolNode* int_index = symboltable_create_temp(TYPE_INTEGER);
-                quadgen_generate("CONVERT", original_index, "INTEGER", int_index->name);
-                symboltable_set_initialized(int_index);
-                index = int_index->name;
-            } else {
-                // For other types, use a default index
-                SymbolNode* default_idx = symboltable_create_temp(TYPE_INTEGER);
-                quadgen_generate(":=", "0", "", default_idx->name);
-                symboltable_set_initialized(default_idx);
-                index = default_idx->name;
-            }
-        }
+    if (!check_array_index(array_node, &index)) {
+        return;
     }
     
     // Check expression type
-    SymbolType expr_type = get_expression_type(expr_value);
+    SymbolType expr_type = get_expression_type(&expr_value);
     
     if (expr_type == TYPE_UNKNOWN) {
         char error_msg[256];
-        sprintf(error_msg, "Undefined expression '%s' in assignment", expr_value);
+        char expr_str[OPERAND_TEXT_SIZE];
+        sprintf(error_msg, "Undefined expression '%s' in assignment",
+                operand_text(&expr_value, expr_str, sizeof(expr_str)));
         parser_semantic_error(error_msg);
         return;
     }
@@ -613,46 +782,30 @@ void process_array_assignment(const char* array_name, const char* index, const c
         return;
     }
     
-    // Get the lower bound of the array
-    int lower_bound = array_node->array_lower_bound;
-    
-    // Create a new temporary for the adjusted index
-    SymbolNode* adjusted_index = symboltable_create_temp(TYPE_INTEGER);
-    symboltable_set_initialized(adjusted_index);
-    
-    // Generate code to calculate: adjusted_index = index - lower_bound
-    char lower_bound_str[16];
-    sprintf(lower_bound_str, "%d", lower_bound);
-    quadgen_generate("-", index, lower_bound_str, adjusted_index->name);
-    
-    // Format the array access for the left side using the adjusted index
+    // Lower the index and the value, then format the array access for the left
+    // side using the adjusted index
+    Operand value = convert_for_store(expr_value, array_node->type);
+    expr_emit_pair(&index, &value);
     char array_access[256];
-    sprintf(array_access, "%s[%s]", array_name, adjusted_index->name);
-    
-    // Check if conversion is needed
-    if (array_node->type != expr_type && array_node->type != TYPE_UNKNOWN && expr_type != TYPE_UNKNOWN) {
-        // Need to convert the expression to match array element type
-        SymbolNode* converted = symboltable_create_temp(array_node->type);
-        quadgen_generate("CONVERT", expr_value, get_type_name(array_node->type), converted->name);
-        symboltable_set_initialized(converted);
-        
-        // Use the converted value for assignment
-        quadgen_generate(":=", converted->name, "", array_access);
-    } else {
-        // Direct assignment, no conversion needed
-        quadgen_generate(":=", expr_value, "", array_access);
-    }
+    format_array_element(array_name, array_node, &index, array_access, sizeof(array_access));
+    
+    store_value(array_access, value);
 }
  
  // Process input/output statements
 // Process input/output statements
-void process_io_statement(const char* io_type, const char* format, const char* target) {
-    // Check if target is valid
-    SymbolNode* var_node = symboltable_lookup(target);
-    if (!var_node) {
+void process_io_statement(const char* io_type, const char* format, Operand target) {
+    // An element or expression is lowered to the temporary holding it
+    target = expr_emit(target);
+    
+    // Check if target is valid (DISPLAY also accepts literal values)
+    SymbolNode* var_node = target.kind == OPERAND_SYMBOL ? target.symbol : NULL;
+    int is_display = strcmp(io_type, "DISPLAY") == 0;
+    if (!var_node && !(is_display && target.kind == OPERAND_IMMEDIATE)) {
         parser_semantic_error("Undefined variable in I/O statement");
         return;
     }
+    SymbolType target_type = get_expression_type(&target);
     
     // Verify format matches variable type
     char format_error = 0;
@@ -671,16 +824,16 @@ void process_io_statement(const char* io_type, const char* format, const char* t
     if (format_specifier) {
         switch (*format_specifier) {
             case '$':
-                if (var_node->type != TYPE_INTEGER) format_error = 1;
+                if (target_type != TYPE_INTEGER) format_error = 1;
                 break;
             case '%':
-                if (var_node->type != TYPE_FLOAT) format_error = 1;
+                if (target_type != TYPE_FLOAT) format_error = 1;
                 break;
             case '#':
-                if (var_node->type != TYPE_STRING) format_error = 1;
+                if (target_type != TYPE_STRING) format_error = 1;
                 break;
             case '&':
-                if (var_node->type != TYPE_CHAR) format_error = 1;
+                if (target_type != TYPE_CHAR) format_error = 1;
                 break;
         }
     }
@@ -694,33 +847,39 @@ void process_io_statement(const char* io_type, const char* format, const char* t
         // Check if the variable is a constant (cannot be modified)
         if (var_node->category == CATEGORY_CONSTANT) {
             char error_msg[256];
-            sprintf(error_msg, "Cannot modify constant '%s' with READ", target);
+            sprintf(error_msg, "Cannot modify constant '%s' with READ", var_node->name);
             parser_semantic_error(error_msg);
             return;
         }
         
         // Generate the READ quadruple
-        quadgen_generate("LIRE", format, "", target);
+        quadgen_generate("LIRE", format, "", var_node->name);
         symboltable_set_initialized(var_node);
-    } else if (strcmp(io_type, "DISPLAY") == 0) {
+    } else if (is_display) {
         // Check if the variable is initialized
-        if (!var_node->is_initialized) {
+        if (var_node && !var_node->is_initialized) {
             parser_semantic_error("Cannot display uninitialized variable");
             // Continue anyway for code generation
         }
         
-        // Generate the DISPLAY quadruple
-        quadgen_generate("AFFICHER", format, target, "");
+        // Generate the DISPLAY quadruple. A literal 0 (the ZERO placeholder)
+        // shows the message alone and leaves the value field empty, so a
+        // value the optimizer later folds to 0 is still displayed.
+        char value_str[OPERAND_TEXT_SIZE] = "";
+        if (!(target.kind == OPERAND_IMMEDIATE && target.type == TYPE_INTEGER && target.imm.int_value == 0)) {
+            operand_text(&target, value_str, sizeof(value_str));
+        }
+        quadgen_generate("AFFICHER", format, value_str, "");
     }
 }
  
  // Process condition for control structures
- ConditionAttrs* process_condition(const char* op, const char* arg1, const char* arg2) {
+ ConditionAttrs* process_condition(const char* op, Operand arg1, Operand arg2) {
     ConditionAttrs* attrs = (ConditionAttrs*)safe_malloc(sizeof(ConditionAttrs));
     
     // Get operand types for type checking
-    SymbolType type1 = get_expression_type(arg1);
-    SymbolType type2 = get_expression_type(arg2);
+    SymbolType type1 = get_expression_type(&arg1);
+    SymbolType type2 = get_expression_type(&arg2);
     
     // Check if the types are comparable
     if (!symboltable_types_compatible(type1, type2)) {
@@ -731,52 +890,36 @@ void process_io_statement(const char* io_type, const char* format, const char* t
     }
     
     // Make sure both operands are valid before generating code
-    if (!is_integer_literal(arg1) && !is_float_literal(arg1)) {
-        SymbolNode* node1 = symboltable_lookup(arg1);
-        if (!node1) {
-            // Create a placeholder for error recovery
-            node1 = symboltable_create_temp(TYPE_INTEGER);
-            quadgen_generate(":=", "0", "", node1->name);
-            symboltable_set_initialized(node1);
-            arg1 = node1->name;
-        }
+    if (arg1.kind == OPERAND_NONE) {
+        // Create a placeholder for error recovery
+        SymbolNode* node1 = symboltable_create_temp(TYPE_INTEGER);
+        quadgen_generate(":=", "0", "", node1->name);
+        symboltable_set_initialized(node1);
+        arg1 = operand_symbol(node1);
     }
     
-    if (!is_integer_literal(arg2) && !is_float_literal(arg2)) {
-        SymbolNode* node2 = symboltable_lookup(arg2);
-        if (!node2) {
-            // Create a placeholder for error recovery
-            node2 = symboltable_create_temp(TYPE_INTEGER);
-            quadgen_generate(":=", "0", "", node2->name);
-            symboltable_set_initialized(node2);
-            arg2 = node2->name;
-        }
+    if (arg2.kind == OPERAND_NONE) {
+        // Create a placeholder for error recovery
+        SymbolNode* node2 = symboltable_create_temp(TYPE_INTEGER);
+        quadgen_generate(":=", "0", "", node2->name);
+        symboltable_set_initialized(node2);
+        arg2 = operand_symbol(node2);
     }
     
-    // Apply conversion if needed for comparison
-    char* conv_arg1 = safe_strdup(arg1);
-    char* conv_arg2 = safe_strdup(arg2);
-    
-    // Use the "widest" type for comparison
+    // Use the "widest" type for comparison; two CHARs compare as bytes
     SymbolType compare_type = (type1 == TYPE_FLOAT || type2 == TYPE_FLOAT) ? TYPE_FLOAT : TYPE_INTEGER;
+    if (type1 == TYPE_CHAR && type2 == TYPE_CHAR) {
+        compare_type = TYPE_CHAR;
+    }
     
-    // Convert arg1 if needed
+    // Apply conversion if needed for comparison
     if (type1 != TYPE_UNKNOWN && type1 != compare_type) {
-        SymbolNode* conv_temp = symboltable_create_temp(compare_type);
-        quadgen_generate("CONVERT", arg1, get_type_name(compare_type), conv_temp->name);
-        symboltable_set_initialized(conv_temp);
-        free(conv_arg1);
-        conv_arg1 = safe_strdup(conv_temp->name);
+        arg1 = convert_operand(arg1, compare_type);
     }
-    
-    // Convert arg2 if needed
     if (type2 != TYPE_UNKNOWN && type2 != compare_type) {
-        SymbolNode* conv_temp = symboltable_create_temp(compare_type);
-        quadgen_generate("CONVERT", arg2, get_type_name(compare_type), conv_temp->name);
-        symboltable_set_initialized(conv_temp);
-        free(conv_arg2);
-        conv_arg2 = safe_strdup(conv_temp->name);
+        arg2 = convert_operand(arg2, compare_type);
     }
+    expr_emit_pair(&arg1, &arg2);
     
     // Choose the OPPOSITE jump instruction
     const char* jump_op = "SAUT"; // Default
@@ -796,16 +939,15 @@ void process_io_statement(const char* io_type, const char* format, const char* t
     }
     
     // CHANGE THIS - use correct order (op, target, arg1, arg2)
-    int quad_id = quadgen_generate(jump_op, "?", conv_arg1, conv_arg2);
+    char arg1_str[OPERAND_TEXT_SIZE], arg2_str[OPERAND_TEXT_SIZE];
+    int quad_id = quadgen_generate(jump_op, "?", operand_text(&arg1, arg1_str, sizeof(arg1_str)),
+                                   operand_text(&arg2, arg2_str, sizeof(arg2_str)));
     attrs->false_list = create_patch_list(quad_id);
     
     // Also change this for unconditional jump
     quad_id = quadgen_generate("SAUT", "?", "", "");
     attrs->true_list = create_patch_list(quad_id);
     
-    free(conv_arg1);
-    free(conv_arg2);
-    
     return attrs;
 }
  
@@ -942,8 +1084,142 @@ void end_if_statement(int has_else) {
 /* FOR loop context stack */
 static ForLoopContext* for_stack = NULL;
 
+/* Push a loop context whose condition code starts at the next quadruple */
+static ForLoopContext* push_loop_context(const char* var_name) {
+    ForLoopContext* ctx = (ForLoopContext*)safe_malloc(sizeof(ForLoopContext));
+    ctx->var_name = var_name ? safe_strdup(var_name) : NULL;
+    
+    // The condition label marks the test repeated at the bottom of the loop
+    ctx->cond_label = quadgen_new_label();
+    ctx->body_label = 0;  // Will be set later
+    ctx->end_label = 0;   // Will be set later
+    ctx->cond_start = quadgen_get_count();
+    ctx->cond_end = ctx->cond_start;
+    
+    // Push onto stack
+    ctx->next = for_stack;
+    for_stack = ctx;
+    return ctx;
+}
+
+/* Branch with the opposite condition */
+static const char* invert_branch(const char* op) {
+    if (strcmp(op, "BG") == 0) return "BLE";
+    if (strcmp(op, "BLE") == 0) return "BG";
+    if (strcmp(op, "BGE") == 0) return "BL";
+    if (strcmp(op, "BL") == 0) return "BGE";
+    if (strcmp(op, "BE") == 0) return "BNE";
+    if (strcmp(op, "BNE") == 0) return "BE";
+    return NULL;
+}
+
+/* Emit the loop latch: a copy of the condition code that jumps back to the body
+   while the condition holds and falls through to the loop end otherwise */
+static void emit_rotated_latch(ForLoopContext* ctx) {
+    int count = ctx->cond_end - ctx->cond_start;
+    if (count <= 0) {
+        return;
+    }
+    
+    char body_str[16], end_str[16];
+    strcpy(body_str, quadgen_label_to_string(ctx->body_label));
+    strcpy(end_str, quadgen_label_to_string(ctx->end_label));
+    
+    // Falling off the end of the condition code enters the body
+    Quadruplet* latch = (Quadruplet*)safe_malloc((count + 1) * sizeof(Quadruplet));
+    for (int i = 0; i < count; i++) {
+        memcpy(&latch[i], quadgen_get(ctx->cond_start + i), sizeof(Quadruplet));
+    }
+    memset(&latch[count], 0, sizeof(Quadruplet));
+    strcpy(latch[count].op, "SAUT");
+    strcpy(latch[count].arg1, body_str);
+    count++;
+    
+    // Labels inside the condition (from AND/OR) get fresh names in the copy
+    for (int i = 0; i < count; i++) {
+        if (strcmp(latch[i].op, "ETIQ") != 0) continue;
+        
+        char old_label[32], new_label[32];
+        strcpy(old_label, latch[i].arg1);
+        strcpy(new_label, quadgen_label_to_string(quadgen_new_label()));
+        for (int j = 0; j < count; j++) {
+            if (strcmp(latch[j].arg1, old_label) == 0) {
+                strcpy(latch[j].arg1, new_label);
+            }
+        }
+    }
+    
+    // Jumps to an internal label that only leads to "SAUT X" go to X directly
+    for (int i = 0; i < count; i++) {
+        if (strcmp(latch[i].op, "SAUT") != 0 && !invert_branch(latch[i].op)) continue;
+        for (int j = 0; j < count; j++) {
+            if (strcmp(latch[j].op, "ETIQ") != 0 || strcmp(latch[j].arg1, latch[i].arg1) != 0) continue;
+            int k = j;
+            while (k < count && strcmp(latch[k].op, "ETIQ") == 0) k++;
+            if (k < count && strcmp(latch[k].op, "SAUT") == 0) {
+                strcpy(latch[i].arg1, latch[k].arg1);
+            }
+            break;
+        }
+    }
+    
+    // Drop internal labels that are no longer referenced, and code after a
+    // SAUT that no label makes reachable again
+    int kept = 0;
+    int reachable = 1;
+    for (int i = 0; i < count; i++) {
+        if (strcmp(latch[i].op, "ETIQ") == 0) {
+            int referenced = 0;
+            for (int j = 0; j < count; j++) {
+                if (j != i && strcmp(latch[j].arg1, latch[i].arg1) == 0) referenced = 1;
+            }
+            if (!referenced) continue;
+            reachable = 1;
+        }
+        if (!reachable) continue;
+        latch[kept++] = latch[i];
+        if (strcmp(latch[i].op, "SAUT") == 0) reachable = 0;
+    }
+    count = kept;
+    
+    // "Bxx end; SAUT body" becomes "B!xx body"; a trailing "SAUT end" falls through
+    const char* inverted = count >= 2 ? invert_branch(latch[count - 2].op) : NULL;
+    if (strcmp(latch[count - 1].op, "SAUT") == 0) {
+        if (strcmp(latch[count - 1].arg1, body_str) == 0 && inverted &&
+            strcmp(latch[count - 2].arg1, end_str) == 0) {
+            strcpy(latch[count - 2].op, inverted);
+            strcpy(latch[count - 2].arg1, body_str);
+            count--;
+        } else if (strcmp(latch[count - 1].arg1, end_str) == 0) {
+            count--;
+        }
+    }
+    
+    quadgen_generate("ETIQ", quadgen_label_to_string(ctx->cond_label), "", "");
+    for (int i = 0; i < count; i++) {
+        quadgen_generate(latch[i].op, latch[i].arg1, latch[i].arg2, latch[i].result);
+    }
+    free(latch);
+}
+
+/* Pop a loop context, emitting the rotated latch and the end label */
+static void finish_loop(void) {
+    ForLoopContext* ctx = for_stack;
+    for_stack = ctx->next;
+    
+    // Test at the bottom: one conditional branch per iteration
+    emit_rotated_latch(ctx);
+    
+    // Generate end label
+    quadgen_generate("ETIQ", quadgen_label_to_string(ctx->end_label), "", "");
+    
+    // Clean up
+    free(ctx->var_name);
+    free(ctx);
+}
+
 /* Initialize a FOR loop counter and set up condition check */
-void begin_for_loop_init(const char* var_name, const char* initial_value) {
+void begin_for_loop_init(const char* var_name, Operand initial_value) {
     // Check loop counter variable
     SymbolNode* var_node = symboltable_lookup(var_name);
     if (!var_node) {
@@ -958,34 +1234,20 @@ void begin_for_loop_init(const char* var_name, const char* initial_value) {
     }
     
     // Check if the initial value needs type conversion
-    SymbolType init_type = get_expression_type(initial_value);
+    SymbolType init_type = get_expression_type(&initial_value);
     if (init_type != TYPE_INTEGER && init_type != TYPE_UNKNOWN) {
         // Create a converted initial value
-        SymbolNode* converted = symboltable_create_temp(TYPE_INTEGER);
-        quadgen_generate("CONVERT", initial_value, "INTEGER", converted->name);
-        symboltable_set_initialized(converted);
-        initial_value = converted->name;
+        initial_value = convert_operand(initial_value, TYPE_INTEGER);
     }
+    initial_value = expr_emit(initial_value);
     
     // CRUCIAL: Initialize counter BEFORE condition check
-    quadgen_generate(":=", initial_value, "", var_name);
+    char init_str[OPERAND_TEXT_SIZE];
+    quadgen_generate(":=", operand_text(&initial_value, init_str, sizeof(init_str)), "", var_name);
     symboltable_set_initialized(var_node);
     
-    // Create new for loop context
-    ForLoopContext* ctx = (ForLoopContext*)safe_malloc(sizeof(ForLoopContext));
-    ctx->var_name = safe_strdup(var_name);
-    
-    // Create and set condition label
-    ctx->cond_label = quadgen_new_label();
-    ctx->body_label = 0;  // Will be set later
-    ctx->end_label = 0;   // Will be set later
-    
-    // Push onto stack
-    ctx->next = for_stack;
-    for_stack = ctx;
-    
-    // Generate condition label
-    quadgen_generate("ETIQ", quadgen_label_to_string(ctx->cond_label), "", "");
+    // Create new for loop context; the condition code that follows is the loop guard
+    push_loop_context(var_name);
 }
 
 /* Set up FOR loop condition checking and body label */
@@ -1009,6 +1271,9 @@ void begin_for_loop_condition(ConditionAttrs* condition) {
     backpatch(condition->true_list, for_stack->body_label);
     backpatch(condition->false_list, for_stack->end_label);
     
+    // The condition code ends here; it is repeated at the latch
+    for_stack->cond_end = quadgen_get_count();
+    
     // Generate body label
     quadgen_generate("ETIQ", quadgen_label_to_string(for_stack->body_label), "", "");
     
@@ -1016,7 +1281,7 @@ void begin_for_loop_condition(ConditionAttrs* condition) {
     free(condition);
 }
 
-/* Complete a FOR loop by generating increment, jump back and end label */
+/* Complete a FOR loop by generating increment, the bottom test and end label */
 void end_for_loop() {
     // Check for stack underflow
     if (!for_stack) {
@@ -1024,23 +1289,30 @@ void end_for_loop() {
         return;
     }
     
-    // Get context from top of stack
-    ForLoopContext* ctx = for_stack;
-    for_stack = ctx->next;
-    
     // Generate increment
-    quadgen_generate("+", ctx->var_name, "1", ctx->var_name);
-    
-    // Generate jump back to condition
-    quadgen_generate("SAUT", "", "", quadgen_label_to_string(ctx->cond_label));
-    
-    // Generate end label
-    quadgen_generate("ETIQ", quadgen_label_to_string(ctx->end_label), "", "");
+    if (for_stack->var_name) {
+        quadgen_generate("+", for_stack->var_name, "1", for_stack->var_name);
+    }
     
-    // Clean up
-    free(ctx->var_name);
-    free(ctx);
+    finish_loop();
 }
 
- 
- 
+/* Start a WHILE loop: the condition code that follows is the loop guard */
+void begin_while_loop(void) {
+    push_loop_context(NULL);
+}
+
+/* Set up WHILE loop condition checking and body label */
+void begin_while_loop_body(ConditionAttrs* condition) {
+    begin_for_loop_condition(condition);
+}
+
+/* Complete a WHILE loop with the bottom test and end label */
+void end_while_loop(void) {
+    if (!for_stack) {
+        parser_semantic_error("WHILE loop context stack underflow");
+        return;
+    }
+    
+    finish_loop();
+}
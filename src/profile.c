@@ -0,0 +1,213 @@
+/*
+ * profile.c - Basic block execution profiles for the PHYLOG compiler
+ *
+ * A profile records how often each basic block of the unoptimized
+ * quadruples ran (see jit_set_profile). It is a text file:
+ *
+ *   # PHYLOG block profile
+ *   code <checksum> <quadruples> <blocks>
+ *   <first quadruple> <label or -> <count>      (one line per block)
+ *
+ * The checksum covers every quadruple, so a profile is only used for the
+ * exact code it was recorded on; any change to the source invalidates it.
+ */
+
+#include "../include/profile.h"
+#include "../include/quadgen.h"
+
+#define PROFILE_LINE_LENGTH 128
+
+// Loaded profile: execution count of each quadruple's block
+static long* quad_counts = NULL;
+static int profiled_quads = 0;
+static long max_count = 0;
+
+// Check if a quadruple transfers control (the next one starts a block)
+static int ends_block(const Quadruplet* q) {
+    return strcmp(q->op, "SAUT") == 0 || strcmp(q->op, "BG") == 0 || strcmp(q->op, "BGE") == 0 ||
+           strcmp(q->op, "BL") == 0 || strcmp(q->op, "BLE") == 0 || strcmp(q->op, "BE") == 0 ||
+           strcmp(q->op, "BNE") == 0;
+}
+
+// FNV-1a 32-bit hash, continued from a previous value
+static unsigned int fnv1a32(unsigned int hash, const void* data, size_t size) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Checksum of the current quadruples
+static unsigned int code_checksum(void) {
+    unsigned int hash = 2166136261u;
+    int quad_count = quadgen_get_count();
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = quadgen_get(i);
+        hash = fnv1a32(hash, q->op, strlen(q->op) + 1);
+        hash = fnv1a32(hash, q->arg1, strlen(q->arg1) + 1);
+        hash = fnv1a32(hash, q->arg2, strlen(q->arg2) + 1);
+        hash = fnv1a32(hash, q->result, strlen(q->result) + 1);
+    }
+    return hash;
+}
+
+// Split the current quadruples into basic blocks
+int profile_find_blocks(int* block_of_quad) {
+    int quad_count = quadgen_get_count();
+    int block = -1;
+    for (int i = 0; i < quad_count; i++) {
+        Quadruplet* q = quadgen_get(i);
+        if (i == 0 || strcmp(q->op, "ETIQ") == 0 || ends_block(quadgen_get(i - 1))) {
+            block++;
+        }
+        block_of_quad[i] = block;
+    }
+    return block + 1;
+}
+
+// Read the counts of a profile recorded for the current quadruples: first
+// quadruple and count of each block. Returns the number of blocks, -1 if the
+// file is missing, malformed or profiles other code.
+static int read_profile(const char* filename, int* first_quads, long* counts, int max_blocks) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        return -1;
+    }
+
+    char line[PROFILE_LINE_LENGTH];
+    unsigned int checksum;
+    int quad_count, block_count;
+    if (!fgets(line, sizeof(line), file) || line[0] != '#' || !fgets(line, sizeof(line), file) ||
+        sscanf(line, "code %x %d %d", &checksum, &quad_count, &block_count) != 3 ||
+        checksum != code_checksum() || quad_count != quadgen_get_count() ||
+        block_count < 1 || block_count > max_blocks) {
+        fclose(file);
+        return -1;
+    }
+
+    for (int b = 0; b < block_count; b++) {
+        char label[32];
+        if (!fgets(line, sizeof(line), file) ||
+            sscanf(line, "%d %31s %ld", &first_quads[b], label, &counts[b]) != 3 ||
+            (b == 0 ? first_quads[b] != 0 : first_quads[b] <= first_quads[b - 1]) ||
+            first_quads[b] >= quad_count || counts[b] < 0) {
+            fclose(file);
+            return -1;
+        }
+    }
+    fclose(file);
+    return block_count;
+}
+
+// Write the block counts of the current quadruples, accumulating over runs
+int profile_write(const char* filename, const long* counts, int block_count) {
+    int quad_count = quadgen_get_count();
+    int* block_of_quad = (int*)safe_malloc((quad_count + 1) * sizeof(int));
+    int* first_quads = (int*)safe_malloc((block_count + 1) * sizeof(int));
+    long* totals = (long*)safe_malloc((block_count + 1) * sizeof(long));
+
+    if (profile_find_blocks(block_of_quad) != block_count ||
+        read_profile(filename, first_quads, totals, block_count) != block_count) {
+        memset(totals, 0, block_count * sizeof(long));
+    }
+
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        report_error(ERROR_LEVEL_ERROR, 0, 0, "Could not open profile file '%s' for writing", filename);
+        free(block_of_quad);
+        free(first_quads);
+        free(totals);
+        return 0;
+    }
+
+    fprintf(file, "# PHYLOG block profile\n");
+    fprintf(file, "code %08x %d %d\n", code_checksum(), quad_count, block_count);
+    for (int i = 0; i < quad_count; i++) {
+        if (i > 0 && block_of_quad[i] == block_of_quad[i - 1]) continue;
+        Quadruplet* q = quadgen_get(i);
+        int b = block_of_quad[i];
+        fprintf(file, "%d %s %ld\n", i, strcmp(q->op, "ETIQ") == 0 ? q->arg1 : "-", totals[b] + counts[b]);
+    }
+    fclose(file);
+
+    free(block_of_quad);
+    free(first_quads);
+    free(totals);
+    return 1;
+}
+
+// Load a profile of the current quadruples
+int profile_load(const char* filename) {
+    profile_cleanup();
+
+    int quad_count = quadgen_get_count();
+    int* first_quads = (int*)safe_malloc((quad_count + 1) * sizeof(int));
+    long* counts = (long*)safe_malloc((quad_count + 1) * sizeof(long));
+    int block_count = read_profile(filename, first_quads, counts, quad_count);
+    if (block_count < 0) {
+        free(first_quads);
+        free(counts);
+        return 0;
+    }
+
+    // Each block's count applies up to the next block's first quadruple
+    quad_counts = (long*)safe_malloc((quad_count + 1) * sizeof(long));
+    profiled_quads = quad_count;
+    for (int b = 0; b < block_count; b++) {
+        int end = b + 1 < block_count ? first_quads[b + 1] : quad_count;
+        for (int i = first_quads[b]; i < end; i++) {
+            quad_counts[i] = counts[b];
+        }
+        if (counts[b] > max_count) {
+            max_count = counts[b];
+        }
+    }
+
+    free(first_quads);
+    free(counts);
+    return 1;
+}
+
+// Check if a profile is loaded
+int profile_loaded(void) {
+    return quad_counts != NULL;
+}
+
+// Execution count of the block holding a quadruple
+long profile_quad_count(int quad) {
+    if (!quad_counts || quad < 0 || quad >= profiled_quads) {
+        return -1;
+    }
+    return quad_counts[quad];
+}
+
+// Execution count of the most executed block
+long profile_max_count(void) {
+    return max_count;
+}
+
+// Checksum of a profile file's bytes
+unsigned int profile_file_checksum(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return 0;
+    }
+    unsigned int hash = 2166136261u;
+    unsigned char buffer[4096];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        hash = fnv1a32(hash, buffer, size);
+    }
+    fclose(file);
+    return hash;
+}
+
+// Release the loaded profile
+void profile_cleanup(void) {
+    free(quad_counts);
+    quad_counts = NULL;
+    profiled_quads = 0;
+    max_count = 0;
+}
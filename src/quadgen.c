@@ -4,6 +4,8 @@
 
 #include "../include/quadgen.h"
 #include "../include/symboltable.h"
+#include "../include/irbin.h"
+#include "../include/strpool.h"
 
 #define MAX_QUADS 10000
 
@@ -18,11 +20,27 @@ static int label_counter = 0;
 // Buffer for temporary names
 static char temp_name[32];
 
+// Distinct AFFICHER messages, interned as the quadruplets are generated
+static StrPool* message_pool = NULL;
+
 // Initialize the quadruplet generator
 void quadgen_init() {
     quad_count = 0;
     temp_counter = 0;
     label_counter = 0;
+    
+    if (message_pool) {
+        strpool_clear(message_pool);
+    } else {
+        message_pool = strpool_create();
+    }
+}
+
+// Record the message of a display quadruplet
+static void intern_message(const Quadruplet* q) {
+    if (strcmp(q->op, "AFFICHER") == 0) {
+        strpool_intern(quadgen_get_messages(), q->arg1);
+    }
 }
 
 // Generate a quadruplet and return its ID
@@ -68,6 +86,7 @@ int quadgen_generate(const char* op, const char* arg1, const char* arg2, const c
     strncpy(q->result, result ? result : "", sizeof(q->result) - 1);
     q->result[sizeof(q->result) - 1] = '\0';
     
+    intern_message(q);
     return quad_count++;
 }
 
@@ -150,7 +169,14 @@ void quadgen_display() {
 }
 
 // Write quadruplets to a file in a format that can be read back
+// (binary IR container for "*.bin" names, CSV otherwise)
 void quadgen_write_to_file(const char* filename) {
+    size_t name_len = strlen(filename);
+    if (name_len > 4 && strcmp(filename + name_len - 4, ".bin") == 0) {
+        irbin_write(filename);
+        return;
+    }
+    
     FILE* file = fopen(filename, "w");
     if (!file) {
         report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open file for writing: %s", filename);
@@ -170,9 +196,12 @@ void quadgen_write_to_file(const char* filename) {
     fclose(file);
 }
 
-// Read quadruplets from a file
-// Read quadruplets from a file
+// Read quadruplets from a file (binary IR container or CSV)
 int quadgen_read_from_file(const char* filename) {
+    if (irbin_is_binary(filename)) {
+        return irbin_load_quads(filename);
+    }
+    
     FILE* file = fopen(filename, "r");
     if (!file) {
         report_error(ERROR_LEVEL_ERROR, 0, 0, "Cannot open file for reading: %s", filename);
@@ -313,6 +342,7 @@ int quadgen_read_from_file(const char* filename) {
             q->arg2[sizeof(q->arg2) - 1] = '\0';
             strncpy(q->result, result, sizeof(q->result) - 1);
             q->result[sizeof(q->result) - 1] = '\0';
+            intern_message(q);
             quad_count++;
         } else {
             report_error(ERROR_LEVEL_ERROR, 0, 0, "Maximum number of quadruplets exceeded");
@@ -332,6 +362,17 @@ void quadgen_cleanup() {
     quad_count = 0;
     temp_counter = 0;
     label_counter = 0;
+    
+    strpool_destroy(message_pool);
+    message_pool = NULL;
+}
+
+// Get the pool of display messages
+StrPool* quadgen_get_messages() {
+    if (!message_pool) {
+        message_pool = strpool_create();
+    }
+    return message_pool;
 }
 
 
@@ -0,0 +1,180 @@
+/*
+ * strpool.c - Hash-interned string pool for the PHYLOG compiler
+ *
+ * Strings are copied into one growing buffer and found again through an
+ * open-addressing table of string numbers, so interning and lookup take
+ * constant time on average and the pool has no fixed capacity.
+ */
+
+#include "../include/strpool.h"
+
+#define STRPOOL_INITIAL_SLOTS 64
+
+struct StrPool {
+    char* data;            // NUL-terminated strings, back to back
+    size_t size;
+    size_t capacity;
+    size_t* offsets;       // Start of each string in data
+    int count;
+    int offset_capacity;
+    int* slots;            // Open-addressing table of string numbers (-1 = empty)
+    int slot_count;
+};
+
+// FNV-1a hash of a string
+static unsigned int hash_text(const char* s) {
+    unsigned int h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Allocate an empty slot table
+static void reset_slots(StrPool* pool, int slot_count) {
+    pool->slot_count = slot_count;
+    pool->slots = (int*)safe_malloc(slot_count * sizeof(int));
+    for (int i = 0; i < slot_count; i++) {
+        pool->slots[i] = -1;
+    }
+}
+
+// Slot holding a string, or the empty slot where it belongs
+static int find_slot(const StrPool* pool, const char* text) {
+    int h = (int)(hash_text(text) & (unsigned int)(pool->slot_count - 1));
+    while (pool->slots[h] >= 0 && strcmp(pool->data + pool->offsets[pool->slots[h]], text) != 0) {
+        h = (h + 1) & (pool->slot_count - 1);
+    }
+    return h;
+}
+
+// Double the slot table and reinsert all strings
+static void grow_slots(StrPool* pool) {
+    free(pool->slots);
+    reset_slots(pool, pool->slot_count * 2);
+    for (int i = 0; i < pool->count; i++) {
+        pool->slots[find_slot(pool, pool->data + pool->offsets[i])] = i;
+    }
+}
+
+// Create an empty pool
+StrPool* strpool_create(void) {
+    StrPool* pool = (StrPool*)safe_malloc(sizeof(StrPool));
+    pool->capacity = 1024;
+    pool->data = (char*)safe_malloc(pool->capacity);
+    pool->size = 0;
+    pool->offset_capacity = 32;
+    pool->offsets = (size_t*)safe_malloc(pool->offset_capacity * sizeof(size_t));
+    pool->count = 0;
+    reset_slots(pool, STRPOOL_INITIAL_SLOTS);
+    return pool;
+}
+
+// Intern a string and return its number (the same number for equal strings)
+int strpool_intern(StrPool* pool, const char* text) {
+    int slot = find_slot(pool, text);
+    if (pool->slots[slot] >= 0) {
+        return pool->slots[slot];
+    }
+
+    size_t len = strlen(text) + 1;
+    while (pool->size + len > pool->capacity) {
+        pool->capacity *= 2;
+        pool->data = (char*)safe_realloc(pool->data, pool->capacity);
+    }
+    if (pool->count >= pool->offset_capacity) {
+        pool->offset_capacity *= 2;
+        pool->offsets = (size_t*)safe_realloc(pool->offsets, pool->offset_capacity * sizeof(size_t));
+    }
+    memcpy(pool->data + pool->size, text, len);
+    pool->offsets[pool->count] = pool->size;
+    pool->size += len;
+
+    int id = pool->count++;
+    pool->slots[slot] = id;
+    if (pool->count * 2 > pool->slot_count) {
+        grow_slots(pool);
+    }
+    return id;
+}
+
+// Number of a string already in the pool (-1 if absent)
+int strpool_find(const StrPool* pool, const char* text) {
+    return pool->slots[find_slot(pool, text)];
+}
+
+// Number of strings in the pool
+int strpool_count(const StrPool* pool) {
+    return pool->count;
+}
+
+// String with the given number
+const char* strpool_get(const StrPool* pool, int id) {
+    if (id < 0 || id >= pool->count) {
+        return "";
+    }
+    return pool->data + pool->offsets[id];
+}
+
+// Pool being sorted by strpool_share_suffixes (qsort has no context argument)
+static const StrPool* sort_pool = NULL;
+
+// Compare two strings read backwards
+static int compare_reversed(const void* a, const void* b) {
+    const char* s = strpool_get(sort_pool, *(const int*)a);
+    const char* t = strpool_get(sort_pool, *(const int*)b);
+    size_t i = strlen(s), j = strlen(t);
+    while (i > 0 && j > 0) {
+        unsigned char cs = (unsigned char)s[--i];
+        unsigned char ct = (unsigned char)t[--j];
+        if (cs != ct) return cs < ct ? -1 : 1;
+    }
+    return (i > 0) - (j > 0);
+}
+
+// Find strings stored as the tail of a longer one. Sorted by their reversed
+// text, a string that ends another one comes right before a string it ends.
+void strpool_share_suffixes(const StrPool* pool, int* owner, int* offset) {
+    int* order = (int*)safe_malloc((pool->count + 1) * sizeof(int));
+    for (int i = 0; i < pool->count; i++) {
+        order[i] = i;
+        owner[i] = i;
+        offset[i] = 0;
+    }
+    sort_pool = pool;
+    qsort(order, pool->count, sizeof(int), compare_reversed);
+    sort_pool = NULL;
+
+    for (int k = pool->count - 2; k >= 0; k--) {
+        const char* s = strpool_get(pool, order[k]);
+        const char* next = strpool_get(pool, order[k + 1]);
+        size_t len = strlen(s), next_len = strlen(next);
+        if (len < next_len && strcmp(next + next_len - len, s) == 0) {
+            int holder = owner[order[k + 1]];
+            owner[order[k]] = holder;
+            offset[order[k]] = (int)(strlen(strpool_get(pool, holder)) - len);
+        }
+    }
+    free(order);
+}
+
+// Remove all strings
+void strpool_clear(StrPool* pool) {
+    pool->size = 0;
+    pool->count = 0;
+    for (int i = 0; i < pool->slot_count; i++) {
+        pool->slots[i] = -1;
+    }
+}
+
+// Free a pool
+void strpool_destroy(StrPool* pool) {
+    if (!pool) {
+        return;
+    }
+    free(pool->data);
+    free(pool->offsets);
+    free(pool->slots);
+    free(pool);
+}
@@ -513,7 +513,7 @@
      if (from_type == TYPE_INTEGER && to_type == TYPE_FLOAT) {
          // Integer to float - simply add decimal point
          int int_val = string_to_int(value);
-         sprintf(result, "%f", (float)int_val);
+         format_float(result, sizeof(result), (float)int_val);
      }
      else if (from_type == TYPE_FLOAT && to_type == TYPE_INTEGER) {
          // Float to integer - truncate
@@ -638,6 +638,8 @@
      for (int i = 0; i < HASH_SIZE; i++) {
          SymbolNode* node = hash_table[i];  // Fixed: using 'i' instead of 'index'
          while (node) {
+             char float_text[32];
+             
              // Write name, category, type
              fprintf(file, "%s,%s,%s,", 
                     node->name, 
@@ -651,7 +653,8 @@
                          fprintf(file, "%d,", node->value.int_value);
                          break;
                      case TYPE_FLOAT:
-                         fprintf(file, "%f,", node->value.float_value);
+                         format_float(float_text, sizeof(float_text), node->value.float_value);
+                         fprintf(file, "%s,", float_text);
                          break;
                      case TYPE_CHAR:
                          if (node->value.char_value >= 32 && node->value.char_value <= 126) {
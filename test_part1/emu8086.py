@@ -0,0 +1,437 @@
+#!/usr/bin/env python3
+"""Minimal 8086 + 8087 emulator for the .com files of the PHYLOG compiler.
+
+Runs a program built with --com and prints one line per DISPLAY, then the
+exit status:
+
+    ./emu8086.py output.com < input.txt
+
+It covers the instructions and 8087 operations the code generator and the
+soft-float runtime use, and the int 80h hooks of the generated code:
+0FFFFh reads an integer (or a character) into the word at BX, 0FFFEh shows
+message DX with the integer in BX, 0FFFDh reads a float into the doubleword
+at BX and 0FFFCh shows message DX with the float in CX:BX. A DISPLAY line is
+"<message> | <value>", because the hooks always receive a value. READ takes
+the next blank-separated word of standard input (0 at the end of input).
+
+    ./emu8086.py --compare emulated.txt host.txt
+
+checks that the output of the x86-64 and C targets (host.txt) shows the
+same messages and values as an emulated run (emulated.txt).
+"""
+import struct, sys, math
+
+def format_float(v):
+    """Fewest digits that read back to the same single-precision value."""
+    if math.isnan(v) or math.isinf(v):
+        return repr(v)
+    for precision in range(1, 10):
+        text = '%.*g' % (precision, v)
+        if f32(float(text)) == v:
+            break
+    if '.' not in text and 'n' not in text:
+        text = text.replace('e', '.0e') if 'e' in text else text + '.0'
+    return text
+
+def f32(x):
+    try:
+        return struct.unpack('<f', struct.pack('<f', x))[0]
+    except OverflowError:
+        return math.copysign(math.inf, x)
+
+class Halt(Exception):
+    def __init__(self, code): self.code = code
+
+class CPU:
+    def __init__(self, image, inputs):
+        self.mem = bytearray(0x10000)
+        self.mem[0x100:0x100 + len(image)] = image
+        self.r = [0]*8  # ax cx dx bx sp bp si di
+        self.r[4] = 0xFFFE
+        self.seg = [0]*4
+        self.ip = 0x100
+        self.cf = self.zf = self.sf = self.of = self.pf = 0
+        self.df = 0
+        self.inputs = list(inputs)
+        self.out = []
+        self.st = []
+        self.cw = 0x037F
+        self.sw = 0
+        self.steps = 0
+    # memory
+    def rb(self, a): return self.mem[a & 0xFFFF]
+    def rw(self, a): return self.mem[a & 0xFFFF] | (self.mem[(a+1) & 0xFFFF] << 8)
+    def wb(self, a, v): self.mem[a & 0xFFFF] = v & 0xFF
+    def ww(self, a, v): self.wb(a, v); self.wb(a+1, v >> 8)
+    def rd(self, a): return self.rw(a) | (self.rw(a+2) << 16)
+    def fetch(self):
+        b = self.rb(self.ip); self.ip = (self.ip + 1) & 0xFFFF; return b
+    def fetchw(self):
+        w = self.rw(self.ip); self.ip = (self.ip + 2) & 0xFFFF; return w
+    def sfetch(self):
+        b = self.fetch(); return b - 256 if b >= 128 else b
+    # registers
+    def reg8(self, n):
+        v = self.r[n & 3]
+        return (v >> 8) & 0xFF if n >= 4 else v & 0xFF
+    def setreg8(self, n, val):
+        i = n & 3
+        if n >= 4: self.r[i] = (self.r[i] & 0x00FF) | ((val & 0xFF) << 8)
+        else: self.r[i] = (self.r[i] & 0xFF00) | (val & 0xFF)
+    def modrm(self):
+        m = self.fetch()
+        mod, reg, rm = m >> 6, (m >> 3) & 7, m & 7
+        if mod == 3: return reg, ('r', rm)
+        if mod == 0 and rm == 6:
+            return reg, ('m', self.fetchw())
+        base = [self.r[3]+self.r[6], self.r[3]+self.r[7], self.r[5]+self.r[6], self.r[5]+self.r[7],
+                self.r[6], self.r[7], self.r[5], self.r[3]][rm]
+        if mod == 1: base += self.sfetch()
+        elif mod == 2: base += self.fetchw()
+        return reg, ('m', base & 0xFFFF)
+    def get(self, op, w):
+        k, v = op
+        if k == 'r': return self.r[v] if w else self.reg8(v)
+        return self.rw(v) if w else self.rb(v)
+    def put(self, op, w, val):
+        k, v = op
+        if k == 'r':
+            if w: self.r[v] = val & 0xFFFF
+            else: self.setreg8(v, val)
+        else:
+            if w: self.ww(v, val)
+            else: self.wb(v, val)
+    def setszp(self, res, w):
+        mask = 0xFFFF if w else 0xFF
+        res &= mask
+        self.zf = int(res == 0)
+        self.sf = int(bool(res & (0x8000 if w else 0x80)))
+        self.pf = int(bin(res & 0xFF).count('1') % 2 == 0)
+        return res
+    def alu(self, op, a, b, w):
+        mask = 0xFFFF if w else 0xFF
+        top = 0x8000 if w else 0x80
+        if op == 0 or op == 2:  # add adc
+            c = self.cf if op == 2 else 0
+            res = a + b + c
+            self.cf = int(res > mask)
+            self.of = int(((a ^ res) & (b ^ res) & top) != 0)
+        elif op == 3 or op == 5 or op == 7:  # sbb sub cmp
+            c = self.cf if op == 3 else 0
+            res = a - b - c
+            self.cf = int(res < 0)
+            self.of = int(((a ^ b) & (a ^ res) & top) != 0)
+        else:
+            res = {1: a | b, 4: a & b, 6: a ^ b}[op]
+            self.cf = self.of = 0
+        return self.setszp(res, w)
+    def push(self, v):
+        self.r[4] = (self.r[4] - 2) & 0xFFFF; self.ww(self.r[4], v)
+    def pop(self):
+        v = self.rw(self.r[4]); self.r[4] = (self.r[4] + 2) & 0xFFFF; return v
+    def cond(self, c):
+        t = [self.of, self.cf, self.zf, self.cf or self.zf, self.sf, self.pf,
+             self.sf != self.of, (self.sf != self.of) or self.zf][c >> 1]
+        return bool(t) != bool(c & 1)
+    def msg(self, addr):
+        s = bytearray()
+        while self.mem[addr]: s.append(self.mem[addr]); addr += 1
+        return s.decode('latin1')
+    def hook(self):
+        ax = self.r[0]
+        if ax == 0xFFFF:
+            word = self.inputs.pop(0) if self.inputs else '0'
+            try:
+                v = int(word)
+            except ValueError:
+                v = ord(word[0])  # A character
+            self.ww(self.r[3], v)
+        elif ax == 0xFFFE:
+            v = self.r[3]; v = v - 0x10000 if v >= 0x8000 else v
+            self.out.append('%s | %d' % (self.msg(self.r[2]), v))
+        elif ax == 0xFFFD:
+            v = float(self.inputs.pop(0)) if self.inputs else 0.0
+            bits = struct.unpack('<I', struct.pack('<f', v))[0]
+            self.ww(self.r[3], bits & 0xFFFF); self.ww(self.r[3] + 2, bits >> 16)
+        elif ax == 0xFFFC:
+            bits = self.r[3] | (self.r[1] << 16)
+            v = struct.unpack('<f', struct.pack('<I', bits))[0]
+            self.out.append('%s | %s' % (self.msg(self.r[2]), format_float(v)))
+        else:
+            raise RuntimeError('bad hook %x' % ax)
+    # 8087
+    def fmem(self, kind, addr):
+        if kind == 'f32': return struct.unpack('<f', struct.pack('<I', self.rd(addr)))[0]
+        v = self.rw(addr); return v - 0x10000 if v >= 0x8000 else v
+    def farith(self, digit, src):
+        a = self.st[-1]
+        if digit == 0: r = a + src
+        elif digit == 1: r = a * src
+        elif digit in (2, 3):
+            c3 = c2 = c0 = 0
+            if math.isnan(a) or math.isnan(src): c3 = c2 = c0 = 1
+            elif a < src: c0 = 1
+            elif a == src: c3 = 1
+            self.sw = (self.sw & ~0x4500) | (c3 << 14) | (c2 << 10) | (c0 << 8)
+            if digit == 3: self.st.pop()
+            return
+        elif digit == 4: r = a - src
+        elif digit == 5: r = src - a
+        elif digit == 6: r = a / src if src != 0 else (math.copysign(math.inf, a) * math.copysign(1, src) if a != 0 else math.nan)
+        elif digit == 7: r = src / a if a != 0 else math.inf
+        self.st[-1] = r
+    def fpu(self, op):
+        m = self.rb(self.ip)
+        if op == 0xDB and m == 0xE3:
+            self.ip += 1; self.st = []; self.cw = 0x037F; self.sw = 0; return
+        reg, rm = self.modrm()
+        if rm[0] != 'm': raise RuntimeError('x87 register form %02x %02x' % (op, m))
+        a = rm[1]
+        if op == 0xD8: self.farith(reg, self.fmem('f32', a))
+        elif op == 0xDE: self.farith(reg, float(self.fmem('i16', a)))
+        elif op == 0xD9:
+            if reg == 0: self.st.append(self.fmem('f32', a))
+            elif reg in (2, 3):
+                v = self.st[-1]
+                bits = struct.unpack('<I', struct.pack('<f', f32(v)))[0]
+                self.ww(a, bits & 0xFFFF); self.ww(a + 2, bits >> 16)
+                if reg == 3: self.st.pop()
+            elif reg == 5: self.cw = self.rw(a)
+            elif reg == 7: self.ww(a, self.cw)
+            else: raise RuntimeError('D9 /%d' % reg)
+        elif op == 0xDF:
+            if reg == 0: self.st.append(float(self.fmem('i16', a)))
+            elif reg in (2, 3):
+                v = self.st[-1]
+                rc = (self.cw >> 10) & 3
+                if math.isnan(v) or math.isinf(v): iv = -32768
+                else:
+                    iv = {0: round(v), 1: math.floor(v), 2: math.ceil(v), 3: math.trunc(v)}[rc]
+                    if iv < -32768 or iv > 32767: iv = -32768
+                self.ww(a, iv)
+                if reg == 3: self.st.pop()
+            else: raise RuntimeError('DF /%d' % reg)
+        elif op == 0xDD and reg == 7:
+            self.ww(a, self.sw)
+        else:
+            raise RuntimeError('x87 %02x /%d' % (op, reg))
+    def run(self, limit=5_000_000):
+        while True:
+            self.steps += 1
+            if self.steps > limit: raise RuntimeError('step limit')
+            rep = None
+            op = self.fetch()
+            if op in (0xF2, 0xF3):
+                rep = op; op = self.fetch()
+            if op in (0xA4, 0xA5, 0xAA, 0xAB, 0xAC, 0xAD):
+                w = op & 1; size = 2 if w else 1
+                count = self.r[1] if rep else 1
+                while count:
+                    if op in (0xA4, 0xA5):
+                        v = self.get(('m', self.r[6]), w); self.put(('m', self.r[7]), w, v)
+                        self.r[6] = (self.r[6] + size) & 0xFFFF; self.r[7] = (self.r[7] + size) & 0xFFFF
+                    elif op in (0xAA, 0xAB):
+                        self.put(('m', self.r[7]), w, self.r[0] if w else self.reg8(0))
+                        self.r[7] = (self.r[7] + size) & 0xFFFF
+                    else:
+                        v = self.get(('m', self.r[6]), w); self.put(('r', 0), w, v)
+                        self.r[6] = (self.r[6] + size) & 0xFFFF
+                    count -= 1
+                    if rep: self.r[1] = count
+                continue
+            if op < 0x40 and (op & 7) < 4 and (op >> 3) < 8:
+                w = op & 1; d = (op >> 1) & 1
+                reg, rm = self.modrm()
+                regop = ('r', reg)
+                dst, src = (regop, rm) if d else (rm, regop)
+                k = op >> 3
+                res = self.alu(k, self.get(dst, w), self.get(src, w), w)
+                if k != 7: self.put(dst, w, res)
+            elif op < 0x40 and (op & 7) in (4, 5):
+                w = op & 1; k = op >> 3
+                imm = self.fetchw() if w else self.fetch()
+                res = self.alu(k, self.get(('r', 0), w), imm, w)
+                if k != 7: self.put(('r', 0), w, res)
+            elif op in (0x06, 0x0E, 0x16, 0x1E): self.push(self.seg[op >> 3])
+            elif op in (0x07, 0x17, 0x1F): self.seg[op >> 3] = self.pop()
+            elif 0x40 <= op <= 0x4F:
+                i = op & 7; v = self.r[i]
+                cf = self.cf
+                if op < 0x48: res = self.alu(0, v, 1, 1)
+                else: res = self.alu(5, v, 1, 1)
+                self.cf = cf; self.r[i] = res
+            elif 0x50 <= op <= 0x57: self.push(self.r[op & 7])
+            elif 0x58 <= op <= 0x5F: self.r[op & 7] = self.pop()
+            elif 0x70 <= op <= 0x7F:
+                d = self.sfetch()
+                if self.cond(op & 0xF): self.ip = (self.ip + d) & 0xFFFF
+            elif op in (0x80, 0x81, 0x83):
+                w = int(op != 0x80)
+                reg, rm = self.modrm()
+                if op == 0x81: imm = self.fetchw()
+                elif op == 0x83: imm = self.sfetch() & 0xFFFF
+                else: imm = self.fetch()
+                res = self.alu(reg, self.get(rm, w), imm, w)
+                if reg != 7: self.put(rm, w, res)
+            elif op in (0x84, 0x85):
+                w = op & 1; reg, rm = self.modrm()
+                self.alu(4, self.get(rm, w), self.get(('r', reg), w), w)
+            elif op in (0x86, 0x87):
+                w = op & 1; reg, rm = self.modrm()
+                a = self.get(rm, w); b = self.get(('r', reg), w)
+                self.put(rm, w, b); self.put(('r', reg), w, a)
+            elif 0x88 <= op <= 0x8B:
+                w = op & 1; d = (op >> 1) & 1
+                reg, rm = self.modrm()
+                if d: self.put(('r', reg), w, self.get(rm, w))
+                else: self.put(rm, w, self.get(('r', reg), w))
+            elif op == 0x8C:
+                reg, rm = self.modrm(); self.put(rm, 1, self.seg[reg])
+            elif op == 0x8E:
+                reg, rm = self.modrm(); self.seg[reg] = self.get(rm, 1)
+            elif op == 0x8D:
+                reg, rm = self.modrm(); self.r[reg] = rm[1]
+            elif 0x90 <= op <= 0x97:
+                i = op & 7; self.r[0], self.r[i] = self.r[i], self.r[0]
+            elif op == 0x98:
+                al = self.reg8(0); self.r[0] = al | (0xFF00 if al & 0x80 else 0)
+            elif op == 0x99:
+                self.r[2] = 0xFFFF if self.r[0] & 0x8000 else 0
+            elif op == 0x9B: pass
+            elif op == 0x9E:
+                ah = self.reg8(4)
+                self.sf = (ah >> 7) & 1; self.zf = (ah >> 6) & 1; self.pf = (ah >> 2) & 1; self.cf = ah & 1
+            elif op == 0xA0: self.setreg8(0, self.rb(self.fetchw()))
+            elif op == 0xA1: self.r[0] = self.rw(self.fetchw())
+            elif op == 0xA2: self.wb(self.fetchw(), self.r[0])
+            elif op == 0xA3: self.ww(self.fetchw(), self.r[0])
+            elif op in (0xA8, 0xA9):
+                w = op & 1; imm = self.fetchw() if w else self.fetch()
+                self.alu(4, self.get(('r', 0), w), imm, w)
+            elif 0xB0 <= op <= 0xB7: self.setreg8(op & 7, self.fetch())
+            elif 0xB8 <= op <= 0xBF: self.r[op & 7] = self.fetchw()
+            elif op == 0xC3: self.ip = self.pop()
+            elif op in (0xC6, 0xC7):
+                w = op & 1; reg, rm = self.modrm()
+                self.put(rm, w, self.fetchw() if w else self.fetch())
+            elif op == 0xCD:
+                n = self.fetch()
+                if n == 0x80: self.hook()
+                elif n == 0x21 and self.reg8(4) == 0x4C: raise Halt(self.reg8(0))
+                else: raise RuntimeError('int %x' % n)
+            elif 0xD0 <= op <= 0xD3:
+                w = op & 1; reg, rm = self.modrm()
+                count = (self.r[1] & 0xFF) if op >= 0xD2 else 1
+                v = self.get(rm, w); bits = 16 if w else 8; mask = (1 << bits) - 1
+                for _ in range(count):
+                    if reg == 4:
+                        self.cf = (v >> (bits - 1)) & 1; v = (v << 1) & mask
+                    elif reg == 5:
+                        self.cf = v & 1; v >>= 1
+                    elif reg == 7:
+                        self.cf = v & 1; v = (v >> 1) | (v & (1 << (bits - 1)))
+                    elif reg == 2:
+                        c = self.cf; self.cf = (v >> (bits - 1)) & 1; v = ((v << 1) | c) & mask
+                    elif reg == 3:
+                        c = self.cf; self.cf = v & 1; v = (v >> 1) | (c << (bits - 1))
+                    else: raise RuntimeError('shift /%d' % reg)
+                if count and reg in (4, 5, 7): self.setszp(v, w)
+                self.put(rm, w, v)
+            elif op in (0xD8, 0xD9, 0xDB, 0xDD, 0xDE, 0xDF): self.fpu(op)
+            elif op == 0xE8:
+                d = self.fetchw(); self.push(self.ip); self.ip = (self.ip + d) & 0xFFFF
+            elif op == 0xE9:
+                d = self.fetchw(); self.ip = (self.ip + d) & 0xFFFF
+            elif op == 0xEB:
+                d = self.sfetch(); self.ip = (self.ip + d) & 0xFFFF
+            elif op in (0xF6, 0xF7):
+                w = op & 1; reg, rm = self.modrm(); v = self.get(rm, w)
+                if reg == 0:
+                    imm = self.fetchw() if w else self.fetch(); self.alu(4, v, imm, w)
+                elif reg == 2: self.put(rm, w, ~v)
+                elif reg == 3:
+                    res = self.alu(5, 0, v, w); self.put(rm, w, res); self.cf = int(v != 0)
+                elif reg in (4, 5):
+                    if not w: raise RuntimeError('byte mul')
+                    a = self.r[0]
+                    if reg == 5:
+                        a = a - 0x10000 if a >= 0x8000 else a
+                        v = v - 0x10000 if v >= 0x8000 else v
+                    p = (a * v) & 0xFFFFFFFF
+                    self.r[0] = p & 0xFFFF; self.r[2] = p >> 16
+                    self.cf = self.of = int(self.r[2] != 0)
+                elif reg in (6, 7):
+                    if not w: raise RuntimeError('byte div')
+                    n = (self.r[2] << 16) | self.r[0]
+                    if reg == 7:
+                        n = n - (1 << 32) if n >= (1 << 31) else n
+                        v = v - 0x10000 if v >= 0x8000 else v
+                        if v == 0: raise RuntimeError('divide by zero')
+                        q = abs(n) // abs(v) * (1 if (n >= 0) == (v > 0) else -1)
+                        r = n - q * v
+                    else:
+                        if v == 0: raise RuntimeError('divide by zero')
+                        q, r = divmod(n, v)
+                    self.r[0] = q & 0xFFFF; self.r[2] = r & 0xFFFF
+            elif op == 0xFC: self.df = 0
+            elif op == 0xFD: self.df = 1
+            elif op in (0xFE, 0xFF):
+                w = op & 1; reg, rm = self.modrm(); v = self.get(rm, w); cf = self.cf
+                res = self.alu(0 if reg == 0 else 5, v, 1, w); self.cf = cf
+                if reg > 1: raise RuntimeError('FF /%d' % reg)
+                self.put(rm, w, res)
+            else:
+                raise RuntimeError('opcode %02x at %04x' % (op, (self.ip - 1) & 0xFFFF))
+
+def host_display(message, value):
+    """What the x86-64 and C targets print for a DISPLAY the hook saw as
+    (message, value): the value replaces the first placeholder or follows
+    the message, the other placeholders are dropped. A DISPLAY without a
+    value reaches the hook with 0, so for 0 the message alone also fits."""
+    lines = set()
+    for pending in [value] + ([''] if value == '0' else []):
+        text = ''
+        for c in message:
+            if c in '$%#&':
+                if c == '&' and pending:
+                    pending = chr(int(pending) & 0xFF)
+                text += pending or ''
+                pending = None
+            else:
+                text += c
+        lines.add(text + (pending or ''))
+    return lines
+
+def compare(emulated_file, host_file):
+    """Check that the host targets' output matches the emulated output."""
+    emulated = [l.rstrip('\n') for l in open(emulated_file) if not l.startswith('exit ')]
+    host = [l.rstrip('\n') for l in open(host_file)]
+    if len(emulated) != len(host):
+        print('%d DISPLAY lines in %s, %d in %s' % (len(emulated), emulated_file, len(host), host_file))
+        return 1
+    status = 0
+    for number, (line, printed) in enumerate(zip(emulated, host), 1):
+        message, _, value = line.rpartition(' | ')
+        if printed not in host_display(message, value):
+            print('line %d: 8086 "%s", host "%s"' % (number, line, printed))
+            status = 1
+    return status
+
+def main():
+    if len(sys.argv) == 4 and sys.argv[1] == '--compare':
+        sys.exit(compare(sys.argv[2], sys.argv[3]))
+    if len(sys.argv) != 2:
+        sys.exit('usage: emu8086.py <program.com> < input\n'
+                 '       emu8086.py --compare <emulated output> <host output>')
+    image = open(sys.argv[1], 'rb').read()
+    cpu = CPU(image, sys.stdin.read().split())
+    code = None
+    try:
+        cpu.run()
+    except Halt as h:
+        code = h.code
+    for line in cpu.out: print(line)
+    print('exit', code)
+
+if __name__ == '__main__':
+    main()
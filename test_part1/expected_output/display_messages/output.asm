@@ -0,0 +1,76 @@
+; Generated by PHYLOG Compiler
+bits 16
+global _start
+
+section .data
+    hook_input db 'INPUT', 0
+    hook_output db 'OUTPUT', 0
+    ; Message strings
+    msg0 equ msg2 + 3
+    msg1 equ msg2 + 1
+    msg2 db 'isub $', 0
+    ; Temporary variables
+
+section .text
+_start:
+    ; Program initialization
+    mov ax, data
+    mov ds, ax
+
+
+    ; Quad 0: AFFICHER b $ 1 
+    ; Output operation
+    mov dx, msg0  ; String message
+    mov ax, 1
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 1: AFFICHER b $ 2 
+    ; Output operation
+    mov dx, msg0  ; String message
+    mov ax, 2
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 2: AFFICHER b $ 3 
+    ; Output operation
+    mov dx, msg0  ; String message
+    mov ax, 3
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 3: AFFICHER sub $ 7 
+    ; Output operation
+    mov dx, msg1  ; String message
+    mov ax, 7
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 4: AFFICHER isub $ 9 
+    ; Output operation
+    mov dx, msg2  ; String message
+    mov ax, 9
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Program termination
+    mov ax, 4C00h
+    int 21h
+
+; I/O Hooks for Python emulator
+read_int:
+    ; Input hook - Python will intercept
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Custom interrupt
+    ret
+
+print_int:
+    ; Output hook - Python will intercept
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Custom interrupt
+    ret
@@ -0,0 +1,133 @@
+; Generated by PHYLOG Compiler
+bits 16
+global _start
+
+section .data
+    hook_input db 'INPUT', 0
+    hook_output db 'OUTPUT', 0
+    ; Message strings
+    msg0 db 'no value', 0
+    msg1 db 'literal no value $', 0
+    msg2 db 'empty sum $', 0
+    msg3 db 'folded difference $', 0
+    msg4 equ msg2 + 6
+    I dw 0
+    N dw 0
+    S dw 0
+    ; Temporary variables
+
+section .text
+_start:
+    ; Program initialization
+    mov ax, data
+    mov ds, ax
+
+
+    ; Quad 0: AFFICHER no value  
+    ; Output operation
+    mov dx, msg0  ; String message
+    mov bx, 0     ; No value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 1: AFFICHER literal no value $  
+    ; Output operation
+    mov dx, msg1  ; String message
+    mov bx, 0     ; No value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 2: := 0  S
+    mov ax, 0
+    mov [S], ax
+
+    ; Quad 3: := 1  I
+    mov ax, 1
+    mov [I], ax
+
+    ; Quad 4: AFFICHER empty sum $ 0 
+    ; Output operation
+    mov dx, msg2  ; String message
+    mov ax, 0
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 5: := 3  N
+    mov ax, 3
+    mov [N], ax
+
+    ; Quad 6: := 0  S
+    mov ax, 0
+    mov [S], ax
+
+    ; Quad 7: AFFICHER folded difference $ 0 
+    ; Output operation
+    mov dx, msg3  ; String message
+    mov ax, 0
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 8: := 0  S
+    mov ax, 0
+    mov [S], ax
+
+    ; Quad 9: := 1  I
+    mov ax, 1
+    mov [I], ax
+
+    ; Quad 10: BG L5 1 3
+    mov ax, 1
+    cmp ax, 3
+    jg L5
+
+    ; Quad 11: ETIQ L4  
+L4:
+
+    ; Quad 12: + S I S
+    mov ax, [S]
+    mov cx, ax    ; Save first operand
+    mov ax, [I]
+    add ax, cx    ; Add operands
+    mov [S], ax
+
+    ; Quad 13: + I 1 I
+    mov ax, [I]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    add ax, cx    ; Add operands
+    mov [I], ax
+
+    ; Quad 14: BLE L4 I N
+    mov ax, [I]
+    cmp ax, [N]
+    jle L4
+
+    ; Quad 15: ETIQ L5  
+L5:
+
+    ; Quad 16: AFFICHER sum $ S 
+    ; Output operation
+    mov dx, msg4  ; String message
+    mov ax, [S]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Program termination
+    mov ax, 4C00h
+    int 21h
+
+; I/O Hooks for Python emulator
+read_int:
+    ; Input hook - Python will intercept
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Custom interrupt
+    ret
+
+print_int:
+    ; Output hook - Python will intercept
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Custom interrupt
+    ret
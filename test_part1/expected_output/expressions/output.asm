@@ -0,0 +1,982 @@
+; Generated by PHYLOG Compiler
+bits 16
+global _start
+
+section .data
+    hook_input db 'INPUT', 0
+    hook_output db 'OUTPUT', 0
+    ; Message strings
+    msg0 db 'square $', 0
+    msg1 db 'nested $', 0
+    msg2 db 'mixed $', 0
+    msg3 db 'elements $', 0
+    msg4 db 'remainders $', 0
+    msg5 db 'loop $', 0
+    msg6 equ msg7 + 4
+    msg7 db 'not greater $', 0
+    A dw 0
+    B dw 0
+    C dw 0
+    V times 8 dw 0
+    ; Temporary variables
+    T10 dw 0
+    T11 dw 0
+    T14 dw 0
+    T15 dw 0
+    T3 dw 0
+
+section .text
+_start:
+    ; Program initialization
+    mov ax, data
+    mov ds, ax
+
+
+    ; Quad 0: BOUNDS 1 8 
+    ; Array bounds checking
+
+    ; Quad 1: ADEC V  
+    ; Array declaration: V
+
+    ; Quad 2: LIRE $  A
+    ; Input operation
+    lea bx, [A]   ; Get address of target variable
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 3: LIRE $  B
+    ; Input operation
+    lea bx, [B]   ; Get address of target variable
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 4: LIRE $  C
+    ; Input operation
+    lea bx, [C]   ; Get address of target variable
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 5: + 1 A T10
+    mov ax, 1
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 6: := 0  T11
+    mov ax, 0
+    mov [T11], ax
+
+    ; Quad 7: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 8: + 4 A T10
+    mov ax, 4
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 9: := 1  T11
+    mov ax, 1
+    mov [T11], ax
+
+    ; Quad 10: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 11: + 9 A T10
+    mov ax, 9
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 12: := 2  T11
+    mov ax, 2
+    mov [T11], ax
+
+    ; Quad 13: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 14: + 16 A T10
+    mov ax, 16
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 15: := 3  T11
+    mov ax, 3
+    mov [T11], ax
+
+    ; Quad 16: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 17: + 25 A T10
+    mov ax, 25
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 18: := 4  T11
+    mov ax, 4
+    mov [T11], ax
+
+    ; Quad 19: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 20: + 36 A T10
+    mov ax, 36
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 21: := 5  T11
+    mov ax, 5
+    mov [T11], ax
+
+    ; Quad 22: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 23: + 49 A T10
+    mov ax, 49
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 24: := 6  T11
+    mov ax, 6
+    mov [T11], ax
+
+    ; Quad 25: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 26: + 64 A T10
+    mov ax, 64
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 27: := 7  T11
+    mov ax, 7
+    mov [T11], ax
+
+    ; Quad 28: := T10  V[T11]
+    mov ax, [T10]
+    ; Store to array V[T11]
+    push ax       ; Save value temporarily
+    mov bx, [T11] ; Load index
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    pop ax        ; Restore value
+    mov [bx], ax  ; Store at calculated address
+
+    ; Quad 29: * A B T3
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T3], ax
+
+    ; Quad 30: + T3 3 T10
+    mov ax, [T3]
+    mov cx, ax    ; Save first operand
+    mov ax, 3
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 31: * T10 T10 T11
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T11], ax
+
+    ; Quad 32: - T11 T10 T14
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 33: AFFICHER square $ T14 
+    ; Output operation
+    mov dx, msg0  ; String message
+    mov ax, [T14]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 34: - B C T10
+    mov ax, [B]
+    mov cx, ax    ; Save first operand
+    mov ax, [C]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T10], ax
+
+    ; Quad 35: - A T10 T11
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 36: - C T11 T14
+    mov ax, [C]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 37: - B T14 T10
+    mov ax, [B]
+    mov cx, ax    ; Save first operand
+    mov ax, [T14]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T10], ax
+
+    ; Quad 38: - A T10 T11
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 39: AFFICHER nested $ T11 
+    ; Output operation
+    mov dx, msg1  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 40: + A B T10
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 41: - C A T11
+    mov ax, [C]
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 42: * T10 T11 T14
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T14], ax
+
+    ; Quad 43: + T11 10 T15
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, 10
+    add ax, cx    ; Add operands
+    mov [T15], ax
+
+    ; Quad 44: / T10 T15 T11
+    mov ax, [T10]
+    mov cx, ax    ; Save dividend
+    mov ax, [T15]
+    mov bx, ax    ; Move divisor to BX
+    mov ax, cx    ; Move dividend to AX
+    cwd           ; Sign extend to DX:AX
+    idiv bx       ; Divide, quotient in AX
+    mov [T11], ax
+
+    ; Quad 45: + T14 T11 T10
+    mov ax, [T14]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 46: AFFICHER mixed $ T10 
+    ; Output operation
+    mov dx, msg2  ; String message
+    mov ax, [T10]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 47: - A 1 T10
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T10], ax
+
+    ; Quad 48: BOUNDS V[T10] 8 
+    ; Range check on V[T10]
+    mov bx, [T10]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 49: - B 1 T11
+    mov ax, [B]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 50: BOUNDS V[T11] 8 
+    ; Range check on V[T11]
+    mov bx, [T11]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 51: * V[T10] V[T11] T14
+    ; Array access V[T10]
+    mov bx, [T10]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    ; Array access V[T11]
+    mov bx, [T11]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T14], ax
+
+    ; Quad 52: + V[T10] T14 T11
+    ; Array access V[T10]
+    mov bx, [T10]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    mov ax, [T14]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 53: + A 1 T10
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 54: BOUNDS V[A] 8 
+    ; Range check on V[A]
+    mov bx, [A]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 55: - T11 V[A] T14
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    ; Array access V[A]
+    mov bx, [A]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 56: AFFICHER elements $ T14 
+    ; Output operation
+    mov dx, msg3  ; String message
+    mov ax, [T14]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 57: * A 7 T11
+    mov ax, [A]
+    ; Strength-reduced * by 7
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    shl ax, 1
+    sub ax, dx
+    mov [T11], ax
+
+    ; Quad 58: % T11 5 T14
+    mov ax, [T11]
+    ; Strength-reduced % by 5
+    mov bx, ax
+    mov ax, 26215
+    imul bx
+    sar dx, 1
+    mov ax, dx
+    cwd
+    sub ax, dx
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    add ax, dx
+    sub bx, ax
+    mov ax, bx
+    mov [T14], ax
+
+    ; Quad 59: * B 7 T11
+    mov ax, [B]
+    ; Strength-reduced * by 7
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    shl ax, 1
+    sub ax, dx
+    mov [T11], ax
+
+    ; Quad 60: % T11 5 T15
+    mov ax, [T11]
+    ; Strength-reduced % by 5
+    mov bx, ax
+    mov ax, 26215
+    imul bx
+    sar dx, 1
+    mov ax, dx
+    cwd
+    sub ax, dx
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    add ax, dx
+    sub bx, ax
+    mov ax, bx
+    mov [T15], ax
+
+    ; Quad 61: + T14 T15 T11
+    mov ax, [T14]
+    mov cx, ax    ; Save first operand
+    mov ax, [T15]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 62: * C 7 T14
+    mov ax, [C]
+    ; Strength-reduced * by 7
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    shl ax, 1
+    sub ax, dx
+    mov [T14], ax
+
+    ; Quad 63: % T14 5 T15
+    mov ax, [T14]
+    ; Strength-reduced % by 5
+    mov bx, ax
+    mov ax, 26215
+    imul bx
+    sar dx, 1
+    mov ax, dx
+    cwd
+    sub ax, dx
+    mov dx, ax
+    shl ax, 1
+    shl ax, 1
+    add ax, dx
+    sub bx, ax
+    mov ax, bx
+    mov [T15], ax
+
+    ; Quad 64: + T11 T15 T14
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T15]
+    add ax, cx    ; Add operands
+    mov [T14], ax
+
+    ; Quad 65: AFFICHER remainders $ T14 
+    ; Output operation
+    mov dx, msg4  ; String message
+    mov ax, [T14]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 66: := T10  T11
+    mov ax, [T10]
+    mov [T11], ax
+
+    ; Quad 67: * T11 T11 T10
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 68: := 0  T14
+    mov ax, 0
+    mov [T14], ax
+
+    ; Quad 69: + T10 V[T14] T15
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    add ax, cx    ; Add operands
+    mov [T15], ax
+
+    ; Quad 70: + 1 B T10
+    mov ax, 1
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 71: - T10 1 T14
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 72: BOUNDS V[B] 8 
+    ; Range check on V[B]
+    mov bx, [B]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 73: * V[B] T11 T10
+    ; Array access V[B]
+    mov bx, [B]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 74: - T15 T10 T11
+    mov ax, [T15]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 75: AFFICHER loop $ T11 
+    ; Output operation
+    mov dx, msg5  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 76: + 2 A T11
+    mov ax, 2
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 77: * T11 T11 T10
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 78: := 1  T14
+    mov ax, 1
+    mov [T14], ax
+
+    ; Quad 79: + T10 V[T14] T15
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    add ax, cx    ; Add operands
+    mov [T15], ax
+
+    ; Quad 80: + 2 B T10
+    mov ax, 2
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 81: - T10 1 T14
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 82: BOUNDS V[T14] 8 
+    ; Range check on V[T14]
+    mov bx, [T14]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 83: * V[T14] T11 T10
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 84: - T15 T10 T11
+    mov ax, [T15]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 85: AFFICHER loop $ T11 
+    ; Output operation
+    mov dx, msg5  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 86: + 3 A T11
+    mov ax, 3
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 87: * T11 T11 T10
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 88: := 2  T14
+    mov ax, 2
+    mov [T14], ax
+
+    ; Quad 89: + T10 V[T14] T15
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    add ax, cx    ; Add operands
+    mov [T15], ax
+
+    ; Quad 90: + 3 B T10
+    mov ax, 3
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 91: - T10 1 T14
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 92: BOUNDS V[T14] 8 
+    ; Range check on V[T14]
+    mov bx, [T14]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 93: * V[T14] T11 T10
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 94: - T15 T10 T11
+    mov ax, [T15]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 95: AFFICHER loop $ T11 
+    ; Output operation
+    mov dx, msg5  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 96: + 4 A T11
+    mov ax, 4
+    mov cx, ax    ; Save first operand
+    mov ax, [A]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 97: * T11 T11 T10
+    mov ax, [T11]
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 98: := 3  T14
+    mov ax, 3
+    mov [T14], ax
+
+    ; Quad 99: + T10 V[T14] T15
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    add ax, cx    ; Add operands
+    mov [T15], ax
+
+    ; Quad 100: + 4 B T10
+    mov ax, 4
+    mov cx, ax    ; Save first operand
+    mov ax, [B]
+    add ax, cx    ; Add operands
+    mov [T10], ax
+
+    ; Quad 101: - T10 1 T14
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, 1
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T14], ax
+
+    ; Quad 102: BOUNDS V[T14] 8 
+    ; Range check on V[T14]
+    mov bx, [T14]
+    cmp bx, 8     ; Elements in V
+    jae array_range_error
+
+    ; Quad 103: * V[T14] T11 T10
+    ; Array access V[T14]
+    mov bx, [T14]
+    shl bx, 1     ; Multiply by 2 for word size
+    add bx, V     ; Add array base address
+    mov ax, [bx]  ; Load value from array
+    mov cx, ax    ; Save first operand
+    mov ax, [T11]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 104: - T15 T10 T11
+    mov ax, [T15]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    mov dx, ax    ; Save second operand
+    mov ax, cx    ; Restore first operand
+    sub ax, dx    ; Subtract second operand
+    mov [T11], ax
+
+    ; Quad 105: AFFICHER loop $ T11 
+    ; Output operation
+    mov dx, msg5  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 106: := T3  T10
+    mov ax, [T3]
+    mov [T10], ax
+
+    ; Quad 107: + T10 C T11
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, [C]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 108: * B C T10
+    mov ax, [B]
+    mov cx, ax    ; Save first operand
+    mov ax, [C]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 109: + A T10 T14
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    add ax, cx    ; Add operands
+    mov [T14], ax
+
+    ; Quad 110: BLE L8 T11 T14
+    mov ax, [T11]
+    cmp ax, [T14]
+    jle L8
+
+    ; Quad 111: := T3  T10
+    mov ax, [T3]
+    mov [T10], ax
+
+    ; Quad 112: + T10 C T11
+    mov ax, [T10]
+    mov cx, ax    ; Save first operand
+    mov ax, [C]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 113: AFFICHER greater $ T11 
+    ; Output operation
+    mov dx, msg6  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 114: SAUT L7  
+    jmp L7
+
+    ; Quad 115: ETIQ L8  
+L8:
+
+    ; Quad 116: * B C T10
+    mov ax, [B]
+    mov cx, ax    ; Save first operand
+    mov ax, [C]
+    imul cx       ; Multiply (result in DX:AX)
+    mov [T10], ax
+
+    ; Quad 117: + A T10 T11
+    mov ax, [A]
+    mov cx, ax    ; Save first operand
+    mov ax, [T10]
+    add ax, cx    ; Add operands
+    mov [T11], ax
+
+    ; Quad 118: AFFICHER not greater $ T11 
+    ; Output operation
+    mov dx, msg7  ; String message
+    mov ax, [T11]
+    mov bx, ax    ; Value to output
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 119: ETIQ L7  
+L7:
+
+    ; Program termination
+    mov ax, 4C00h
+    int 21h
+
+; I/O Hooks for Python emulator
+read_int:
+    ; Input hook - Python will intercept
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Custom interrupt
+    ret
+
+print_int:
+    ; Output hook - Python will intercept
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Custom interrupt
+    ret
+
+array_range_error:
+    ; Array access outside its bounds - stop with exit code 1
+    mov ax, 4C01h
+    int 21h
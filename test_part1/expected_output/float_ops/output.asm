@@ -0,0 +1,258 @@
+; Generated by PHYLOG Compiler
+bits 16
+global _start
+
+section .data
+    hook_input db 'INPUT', 0
+    hook_output db 'OUTPUT', 0
+    ; Message strings
+    msg0 db 'a + b = %', 0
+    msg1 db 'a - b = %', 0
+    msg2 db 'a * b = %', 0
+    msg3 db 'a / b = %', 0
+    msg4 db 'b - a = %', 0
+    msg5 db '-0 - -0 = %', 0
+    msg6 db '-0 + -0 = %', 0
+    msg7 db '-0 + 0 = %', 0
+    msg8 equ msg5 + 1
+    msg9 db '-0 - 0 = %', 0
+    msg10 db 'a - a = %', 0
+    A dd 0.0
+    B dd 0.0
+    ; Temporary variables
+    T10 dd 0.0
+    T5 dd 0.0
+    T7 dd 0.0
+    ; 8087 operands
+    flt0 dd 1.0
+
+section .text
+_start:
+    ; Program initialization
+    mov ax, data
+    mov ds, ax
+    finit
+
+
+    ; Quad 0: LIRE %  A
+    ; Float input operation
+    lea bx, [A]   ; Get address of target variable
+    mov ax, 0FFFDh ; Float input hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 1: LIRE %  B
+    ; Float input operation
+    lea bx, [B]   ; Get address of target variable
+    mov ax, 0FFFDh ; Float input hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 2: + A B T10
+    fld dword [A]
+    fadd dword [B]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 3: AFFICHER a + b = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg0  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 4: - A B T10
+    fld dword [A]
+    fsub dword [B]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 5: AFFICHER a - b = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg1  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 6: * A B T10
+    fld dword [A]
+    fmul dword [B]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 7: AFFICHER a * b = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg2  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 8: / A B T10
+    fld dword [A]
+    fdiv dword [B]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 9: AFFICHER a / b = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg3  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 10: - B A T10
+    fld dword [B]
+    fsub dword [A]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 11: AFFICHER b - a = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg4  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 12: - A A T5
+    fld dword [A]
+    fsub dword [A]
+    fstp dword [T5]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 13: - T5 1.0 T10
+    fld dword [T5]
+    fsub dword [flt0]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 14: * T5 T10 T7
+    fld dword [T5]
+    fmul dword [T10]
+    fstp dword [T7]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 15: - T7 T7 T10
+    fld dword [T7]
+    fsub dword [T7]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 16: AFFICHER -0 - -0 = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg5  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 17: + T7 T7 T10
+    fld dword [T7]
+    fadd dword [T7]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 18: AFFICHER -0 + -0 = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg6  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 19: + T7 T5 T10
+    fld dword [T7]
+    fadd dword [T5]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 20: AFFICHER -0 + 0 = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg7  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 21: - T5 T7 T10
+    fld dword [T5]
+    fsub dword [T7]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 22: AFFICHER 0 - -0 = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg8  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 23: - T7 T5 T10
+    fld dword [T7]
+    fsub dword [T5]
+    fstp dword [T10]
+    fwait         ; Stored before the CPU reads it
+
+    ; Quad 24: AFFICHER -0 - 0 = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg9  ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Quad 25: := T5  T10
+    mov ax, [T5]
+    mov dx, [T5 + 2]
+    mov [T10], ax
+    mov [T10 + 2], dx
+
+    ; Quad 26: AFFICHER a - a = % T10 
+    ; Float output operation
+    mov ax, [T10]
+    mov dx, [T10 + 2]
+    mov bx, ax
+    mov cx, dx    ; Value to output in CX:BX
+    mov dx, msg10 ; String message
+    mov ax, 0FFFCh ; Float output hook identifier
+    int 80h       ; Call hook
+
+    ; Program termination
+    mov ax, 4C00h
+    int 21h
+
+; I/O Hooks for Python emulator
+read_int:
+    ; Input hook - Python will intercept
+    mov ax, 0FFFFh ; Input hook identifier
+    int 80h       ; Custom interrupt
+    ret
+
+print_int:
+    ; Output hook - Python will intercept
+    mov ax, 0FFFEh ; Output hook identifier
+    int 80h       ; Custom interrupt
+    ret
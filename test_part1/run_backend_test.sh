@@ -0,0 +1,86 @@
+#!/bin/bash
+# Make sure the script is executable (chmod +x run_backend_test.sh)
+# Run a program through the x86-64 target, the C target and --run at each
+# optimization level and compare what it prints with the expected output
+# usage: ./run_backend_test.sh display_zero.phy
+#
+# Expected output: expected_output/<test>/program_output.txt
+# Program input (optional): expected_output/<test>/input.txt
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+# Directory containing the tests
+TEST_DIR="$(dirname "$0")"
+BIN_DIR="${BIN_DIR:-../bin}"
+COMPILER="${BIN_DIR}/phylog"
+
+if [ $# -eq 0 ]; then
+    echo -e "${RED}Error: No input file provided.${NC}"
+    echo -e "${YELLOW}Usage: ./run_backend_test.sh <filename.phy>${NC}"
+    exit 1
+fi
+
+INPUT_FILE="$1"
+BASENAME=$(basename "$INPUT_FILE" .phy)
+EXPECTED="$TEST_DIR/expected_output/$BASENAME/program_output.txt"
+PROGRAM_INPUT="$TEST_DIR/expected_output/$BASENAME/input.txt"
+
+if [ ! -f "$COMPILER" ]; then
+    echo -e "${RED}Compiler not found at $COMPILER. Build the project first.${NC}"
+    exit 1
+fi
+if [ ! -f "$EXPECTED" ]; then
+    echo -e "${RED}Error: No expected output at $EXPECTED.${NC}"
+    exit 1
+fi
+if [ ! -f "$PROGRAM_INPUT" ]; then
+    PROGRAM_INPUT=/dev/null
+fi
+
+WORK_DIR=$(mktemp -d)
+STATUS=0
+
+# Compare one run's output with the expected output
+check() {
+    local description="$1"
+    if diff -u "$EXPECTED" "$WORK_DIR/program_output.txt" > "$WORK_DIR/diff.txt"; then
+        echo -e "${GREEN}$description: output matches${NC}"
+    else
+        echo -e "${RED}$description: output differs from $EXPECTED${NC}"
+        cat "$WORK_DIR/diff.txt"
+        STATUS=1
+    fi
+}
+
+echo -e "${YELLOW}Running $INPUT_FILE on the host targets...${NC}"
+# Without -O the compiler optimizes at level 3, so the levels cover every build
+for LEVEL in -O1 -O2 -O3 -Os; do
+    for TARGET in x86-64 c; do
+        rm -f "$WORK_DIR/output"
+        $COMPILER "$INPUT_FILE" -o "$WORK_DIR/output" -q -t $TARGET $LEVEL > /dev/null 2>&1
+        if [ -x "$WORK_DIR/output" ]; then
+            "$WORK_DIR/output" < "$PROGRAM_INPUT" > "$WORK_DIR/program_output.txt"
+        else
+            echo "(no executable)" > "$WORK_DIR/program_output.txt"
+        fi
+        check "-t $TARGET, $LEVEL"
+    done
+
+    # --run prints the program's output between "Running <file>..." and the JIT summary
+    $COMPILER "$INPUT_FILE" -o "$WORK_DIR/output" -q --run $LEVEL < "$PROGRAM_INPUT" 2> /dev/null |
+        awk -v start="Running $INPUT_FILE..." '$0 == start { on = 1; next } /^JIT: / { on = 0 } on' \
+        > "$WORK_DIR/program_output.txt"
+    check "--run, $LEVEL"
+done
+
+rm -rf "$WORK_DIR"
+if [ $STATUS -eq 0 ]; then
+    echo -e "${GREEN}Test passed! Every target prints the expected output${NC}"
+else
+    echo -e "${RED}Test failed!${NC}"
+fi
+exit $STATUS
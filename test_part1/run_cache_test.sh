@@ -0,0 +1,89 @@
+#!/bin/bash
+# Make sure the script is executable (chmod +x run_cache_test.sh)
+# Check the compilation cache (-C): the same source and options must hit,
+# a changed option or a changed source must miss
+# usage: ./run_cache_test.sh sort_array.phy
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+# Directory containing the tests
+TEST_DIR="$(dirname "$0")"
+BIN_DIR="${BIN_DIR:-../bin}"
+COMPILER="${BIN_DIR}/phylog"
+
+if [ $# -eq 0 ]; then
+    echo -e "${RED}Error: No input file provided.${NC}"
+    echo -e "${YELLOW}Usage: ./run_cache_test.sh <filename.phy>${NC}"
+    exit 1
+fi
+
+INPUT_FILE="$1"
+if [ ! -f "$COMPILER" ]; then
+    echo -e "${RED}Compiler not found at $COMPILER. Build the project first.${NC}"
+    exit 1
+fi
+if [ ! -f "$INPUT_FILE" ]; then
+    echo -e "${RED}Error: $INPUT_FILE not found.${NC}"
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+CACHE_DIR="$WORK_DIR/cache"
+STATUS=0
+
+# Compile with the cache and report "hit" or "miss"
+compile() {
+    local source="$1"
+    shift
+    if $COMPILER "$source" -o "$WORK_DIR/output" -q -C "$CACHE_DIR" "$@" | grep -q "^Cache hit"; then
+        echo hit
+    else
+        echo miss
+    fi
+}
+
+# One compilation and its expected lookup result
+check() {
+    local expected="$1" description="$2"
+    shift 2
+    local actual
+    actual=$(compile "$@")
+    if [ "$actual" = "$expected" ]; then
+        echo -e "${GREEN}$description: $actual${NC}"
+    else
+        echo -e "${RED}$description: expected a $expected, got a $actual${NC}"
+        STATUS=1
+    fi
+}
+
+echo -e "${YELLOW}Compiling $INPUT_FILE with the cache in $CACHE_DIR...${NC}"
+check miss "First compilation" "$INPUT_FILE" -O2
+cp "$WORK_DIR/output.asm" "$WORK_DIR/compiled.asm"
+check hit "Same source and options" "$INPUT_FILE" -O2
+
+# A hit must restore exactly what the compiler produced
+if ! cmp -s "$WORK_DIR/output.asm" "$WORK_DIR/compiled.asm"; then
+    echo -e "${RED}Restored assembly differs from the compiled one${NC}"
+    STATUS=1
+fi
+
+check miss "Other optimization level" "$INPUT_FILE" -O1
+check miss "Other unrolling factor" "$INPUT_FILE" -O2 -U 2
+check hit "First options again" "$INPUT_FILE" -O2
+
+# The same program with one more line is another source
+cp "$INPUT_FILE" "$WORK_DIR/changed.phy"
+echo "" >> "$WORK_DIR/changed.phy"
+check miss "Changed source" "$WORK_DIR/changed.phy" -O2
+
+rm -rf "$WORK_DIR"
+if [ $STATUS -eq 0 ]; then
+    echo -e "${GREEN}Test passed! The cache hits and misses as expected${NC}"
+else
+    echo -e "${RED}Test failed!${NC}"
+fi
+exit $STATUS
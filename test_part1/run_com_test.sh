@@ -0,0 +1,49 @@
+#!/bin/bash
+# Make sure the script is executable (chmod +x run_com_test.sh)
+# Check the .com binary built by the built-in 8086 assembler against the expected one
+# usage: ./run_com_test.sh display_messages.phy
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+# Directory containing the tests
+TEST_DIR="$(dirname "$0")"
+BIN_DIR="../bin"
+COMPILER="${BIN_DIR}/phylog"
+
+if [ $# -eq 0 ]; then
+    echo -e "${RED}Error: No input file provided.${NC}"
+    echo -e "${YELLOW}Usage: ./run_com_test.sh <filename.phy>${NC}"
+    exit 1
+fi
+
+INPUT_FILE="$1"
+BASENAME=$(basename "$INPUT_FILE" .phy)
+EXPECTED="$TEST_DIR/expected_output/$BASENAME/output.com"
+
+if [ ! -f "$COMPILER" ]; then
+    echo -e "${RED}Compiler not found at $COMPILER. Build the project first.${NC}"
+    exit 1
+fi
+if [ ! -f "$EXPECTED" ]; then
+    echo -e "${RED}Error: No expected binary at $EXPECTED.${NC}"
+    exit 1
+fi
+
+echo -e "${YELLOW}Assembling $INPUT_FILE with --com...${NC}"
+$COMPILER "$INPUT_FILE" -o "$TEST_DIR/com_output" -q --com > /dev/null
+
+# Every byte counts: a message address off by one prints the wrong text
+if cmp -s "$TEST_DIR/com_output.com" "$EXPECTED"; then
+    echo -e "${GREEN}Test passed! com_output.com matches $EXPECTED${NC}"
+    STATUS=0
+else
+    echo -e "${RED}Test failed! com_output.com differs from $EXPECTED${NC}"
+    STATUS=1
+fi
+
+rm -f "$TEST_DIR"/com_output.*
+exit $STATUS
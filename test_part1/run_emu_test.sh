@@ -0,0 +1,90 @@
+#!/bin/bash
+# Make sure the script is executable (chmod +x run_emu_test.sh)
+# Run the 8086 .com builds of a program in the emulator (emu8086.py), at
+# each optimization level, with the 8087 and with -msoft-float, and compare
+# what they print with the expected output
+# usage: ./run_emu_test.sh float_ops.phy
+#
+# Expected output: expected_output/<test>/program_output.8086.txt, and the
+# host targets' expected_output/<test>/program_output.txt when there is one
+# Program input (optional): expected_output/<test>/input.txt
+
+# Colors for output
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+# Directory containing the tests
+TEST_DIR="$(dirname "$0")"
+BIN_DIR="${BIN_DIR:-../bin}"
+COMPILER="${BIN_DIR}/phylog"
+EMULATOR="$TEST_DIR/emu8086.py"
+
+if [ $# -eq 0 ]; then
+    echo -e "${RED}Error: No input file provided.${NC}"
+    echo -e "${YELLOW}Usage: ./run_emu_test.sh <filename.phy>${NC}"
+    exit 1
+fi
+
+INPUT_FILE="$1"
+BASENAME=$(basename "$INPUT_FILE" .phy)
+EXPECTED="$TEST_DIR/expected_output/$BASENAME/program_output.8086.txt"
+PROGRAM_INPUT="$TEST_DIR/expected_output/$BASENAME/input.txt"
+
+if [ ! -f "$COMPILER" ]; then
+    echo -e "${RED}Compiler not found at $COMPILER. Build the project first.${NC}"
+    exit 1
+fi
+if [ ! -f "$EXPECTED" ]; then
+    echo -e "${RED}Error: No expected output at $EXPECTED.${NC}"
+    exit 1
+fi
+if [ ! -f "$PROGRAM_INPUT" ]; then
+    PROGRAM_INPUT=/dev/null
+fi
+
+WORK_DIR=$(mktemp -d)
+STATUS=0
+
+echo -e "${YELLOW}Running $INPUT_FILE in the 8086 emulator...${NC}"
+# Without -O the compiler optimizes at level 3, so the levels cover every build
+for LEVEL in -O1 -O2 -O3 -Os; do
+    for FLOAT in "" -msoft-float; do
+        NAME="$LEVEL, ${FLOAT:-8087}"
+        rm -f "$WORK_DIR/output.com"
+        $COMPILER "$INPUT_FILE" -o "$WORK_DIR/output" -q --com $LEVEL $FLOAT > /dev/null 2>&1
+        if [ -f "$WORK_DIR/output.com" ]; then
+            python3 "$EMULATOR" "$WORK_DIR/output.com" < "$PROGRAM_INPUT" > "$WORK_DIR/program_output.txt" 2>&1
+        else
+            echo "(no .com file)" > "$WORK_DIR/program_output.txt"
+        fi
+
+        if diff -u "$EXPECTED" "$WORK_DIR/program_output.txt" > "$WORK_DIR/diff.txt"; then
+            echo -e "${GREEN}$NAME: output matches${NC}"
+        else
+            echo -e "${RED}$NAME: output differs from $EXPECTED${NC}"
+            cat "$WORK_DIR/diff.txt"
+            STATUS=1
+        fi
+    done
+done
+
+# The x86-64 and C targets must show the same values (see run_backend_test.sh)
+HOST_EXPECTED="$TEST_DIR/expected_output/$BASENAME/program_output.txt"
+if [ -f "$HOST_EXPECTED" ]; then
+    if python3 "$EMULATOR" --compare "$EXPECTED" "$HOST_EXPECTED"; then
+        echo -e "${GREEN}8086 output matches $HOST_EXPECTED${NC}"
+    else
+        echo -e "${RED}8086 output disagrees with $HOST_EXPECTED${NC}"
+        STATUS=1
+    fi
+fi
+
+rm -rf "$WORK_DIR"
+if [ $STATUS -eq 0 ]; then
+    echo -e "${GREEN}Test passed! The 8086 builds print the expected output${NC}"
+else
+    echo -e "${RED}Test failed!${NC}"
+fi
+exit $STATUS